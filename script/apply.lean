@@ -144,12 +144,34 @@ if (arity == fixed + n) \{
 }\n"
 
 def mkFixArgs : M Unit := emit "
+/* Number of additional arguments a closure created by `fix_args` can hold, so that a subsequent under-application of
+   an unshared partial application can store its arguments in place instead of allocating a new closure. */
+#define LEAN_FIX_ARGS_SLACK 2
+
+static inline size_t closure_byte_size(unsigned num_fixed) {
+    return sizeof(lean_closure_object) + sizeof(void*)*num_fixed;
+}
+
 static obj* fix_args(obj* f, unsigned n, obj*const* as) {
     unsigned arity = lean_closure_arity(f);
     unsigned fixed = lean_closure_num_fixed(f);
     unsigned new_fixed = fixed + n;
     lean_assert(new_fixed < arity);
-    obj * r = lean_alloc_closure(lean_closure_fun(f), arity, new_fixed);
+    if (lean_is_exclusive(f) && closure_byte_size(new_fixed) <= lean_small_object_size(f)) {
+        /* `f` would be freed below, and it has enough capacity to store the new arguments. */
+        obj ** target = lean_closure_arg_cptr(f) + fixed;
+        for (unsigned i = 0; i < n; i++, as++, target++) {
+            *target = *as;
+        }
+        lean_to_closure(f)->m_num_fixed = new_fixed;
+        return f;
+    }
+    unsigned capacity = std::min(arity - 1, new_fixed + LEAN_FIX_ARGS_SLACK);
+    obj * r = lean_alloc_small_object(closure_byte_size(capacity));
+    lean_set_st_header(r, LeanClosure, 0);
+    lean_to_closure(r)->m_fun = lean_closure_fun(f);
+    lean_to_closure(r)->m_arity = arity;
+    lean_to_closure(r)->m_num_fixed = new_fixed;
     obj ** source = lean_closure_arg_cptr(f);
     obj ** target = lean_closure_arg_cptr(r);
     if (!lean_is_exclusive(f)) {
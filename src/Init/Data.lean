@@ -16,12 +16,14 @@ import Init.Data.Int
 import Init.Data.Array
 import Init.Data.Array.Subarray.Split
 import Init.Data.ByteArray
+import Init.Data.ByteArray.Bulk
 import Init.Data.FloatArray
 import Init.Data.Fin
 import Init.Data.UInt
 import Init.Data.SInt
 import Init.Data.Float
 import Init.Data.Float32
+import Init.Data.ScalarArray
 import Init.Data.Option
 import Init.Data.Ord
 import Init.Data.Random
@@ -71,11 +71,19 @@ def set : (a : ByteArray) → (i : @& Nat) → UInt8 → (h : i < a.size := by g
 def uset : (a : ByteArray) → (i : USize) → UInt8 → (h : i.toNat < a.size := by get_elem_tactic) → ByteArray
   | ⟨bs⟩, i, v, h => ⟨bs.uset i v h⟩
 
+/-- A hash function for byte arrays whose values do not change between Lean versions. -/
 @[extern "lean_byte_array_hash"]
 protected opaque hash (a : @& ByteArray) : UInt64
 
+/--
+The hash function used by `Hashable ByteArray`. It is faster than `ByteArray.hash` on large arrays,
+but its values may change between Lean versions and must not be persisted.
+-/
+@[extern "lean_byte_array_fast_hash"]
+protected opaque fastHash (a : @& ByteArray) : UInt64
+
 instance : Hashable ByteArray where
-  hash := ByteArray.hash
+  hash := ByteArray.fastHash
 
 def isEmpty (s : ByteArray) : Bool :=
   s.size == 0
@@ -0,0 +1,68 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.ByteArray.Basic
+import Init.Data.Ord
+
+/-!
+Bulk operations on byte arrays that are implemented by vectorized kernels in the runtime.
+
+This module is not imported by `Init.Data.ByteArray` because `Init.Data.Ord` depends on it.
+-/
+
+namespace ByteArray
+
+/-- The index of the first occurrence of `b` in `a` at or after `start`, if any. -/
+@[extern "lean_byte_array_index_of"]
+def indexOf? (a : @& ByteArray) (b : UInt8) (start : @& Nat := 0) : Option Nat :=
+  (List.range (a.size - start)).find? (fun i => a.get! (start + i) == b) |>.map (start + ·)
+
+/-- The index of the first occurrence of the bytes of `pat` in `a` at or after `start`, if any. -/
+@[extern "lean_byte_array_index_of_bytes"]
+def indexOfBytes? (a pat : @& ByteArray) (start : @& Nat := 0) : Option Nat :=
+  (List.range (a.size + 1 - pat.size - start)).find? (fun i =>
+    (List.range pat.size).all fun j => a.get! (start + i + j) == pat.get! j) |>.map (start + ·)
+
+/-- Lexicographic comparison of `a` and `b`. -/
+@[extern "lean_byte_array_compare"]
+protected def compare (a b : @& ByteArray) : Ordering :=
+  go a.data.toList b.data.toList
+where
+  go : List UInt8 → List UInt8 → Ordering
+    | [],    []    => .eq
+    | [],    _     => .lt
+    | _,     []    => .gt
+    | x::xs, y::ys => (Ord.compare x y).then (go xs ys)
+
+instance : Ord ByteArray := ⟨ByteArray.compare⟩
+
+@[inline] private def mapSlice (f : UInt8 → UInt8 → UInt8) (src : ByteArray) (srcOff : Nat) (dest : ByteArray) (destOff len : Nat) : ByteArray :=
+  (List.range (min len (min (src.size - srcOff) (dest.size - destOff)))).foldl
+    (fun d i => d.set! (destOff + i) (f (d.get! (destOff + i)) (src.get! (srcOff + i)))) dest
+
+/--
+  Replace the bytes at `[destOff, destOff + len)` in `dest` with their bitwise xor with the bytes at `[srcOff, srcOff + len)`
+  in `src`. The slices are truncated to the bounds of both arrays, so `dest` never grows.
+-/
+@[extern "lean_byte_array_xor_slice"]
+def xorSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray :=
+  mapSlice (· ^^^ ·) src srcOff dest destOff len
+
+/-- Like `xorSlice`, but combines the bytes with bitwise and. -/
+@[extern "lean_byte_array_and_slice"]
+def andSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray :=
+  mapSlice (· &&& ·) src srcOff dest destOff len
+
+/-- Like `xorSlice`, but combines the bytes with bitwise or. -/
+@[extern "lean_byte_array_or_slice"]
+def orSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray :=
+  mapSlice (· ||| ·) src srcOff dest destOff len
+
+/-- The number of bits set in `a`. -/
+@[extern "lean_byte_array_popcount"]
+def popcount (a : @& ByteArray) : Nat :=
+  a.data.foldl (fun n b => n + ((List.range 8).filter fun i => (b >>> i.toUInt8) &&& 1 == 1).length) 0
+
+end ByteArray
@@ -5,3 +5,4 @@ Author: Leonardo de Moura
 -/
 prelude
 import Init.Data.FloatArray.Basic
+import Init.Data.FloatArray.Bulk
@@ -0,0 +1,70 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.FloatArray.Basic
+import Init.Data.OfScientific
+
+/-!
+Bulk operations on float arrays that are implemented by vectorized kernels in the runtime.
+-/
+
+namespace FloatArray
+
+/--
+  Sum of `f i` for `i < n`, accumulated in the order used by the vectorized kernels: the terms with index
+  `4*k + j` are added to the `j`-th of four partial sums `s₀, …, s₃`, which are combined as `(s₀ + s₂) + (s₁ + s₃)`.
+  The last `n % 4` terms are then added in order.
+-/
+@[inline] private def sumLanes (n : Nat) (f : Nat → Float) : Float :=
+  let m := n / 4
+  let lane (j : Nat) := (List.range m).foldl (fun s k => s + f (4 * k + j)) 0
+  (List.range (n % 4)).foldl (fun s i => s + f (4 * m + i)) ((lane 0 + lane 2) + (lane 1 + lane 3))
+
+/--
+  The sum of the elements of `a`.
+  The rounding errors may differ from `a.foldl (· + ·) 0` since the elements are added in a different order,
+  see `sumLanes`.
+-/
+@[extern "lean_float_array_sum"]
+def sum (a : @& FloatArray) : Float :=
+  sumLanes a.size a.get!
+
+/-- The dot product of `a` and `b`, ignoring the extra elements of the longer array. The order of summation is as in `sum`. -/
+@[extern "lean_float_array_dot"]
+def dot (a b : @& FloatArray) : Float :=
+  sumLanes (min a.size b.size) fun i => a.get! i * b.get! i
+
+/--
+  The least element of `a` that is not NaN, or `inf` if there is none.
+  If several elements compare equal to the result, such as `0.0` and `-0.0`, it is unspecified which one is returned.
+-/
+@[extern "lean_float_array_min"]
+def min (a : @& FloatArray) : Float :=
+  a.foldl (fun m x => if x < m then x else m) (1 / 0)
+
+/--
+  The greatest element of `a` that is not NaN, or `-inf` if there is none.
+  If several elements compare equal to the result, such as `0.0` and `-0.0`, it is unspecified which one is returned.
+-/
+@[extern "lean_float_array_max"]
+def max (a : @& FloatArray) : Float :=
+  a.foldl (fun m x => if x > m then x else m) (-1 / 0)
+
+/-- Multiply every element of `a` by `s`. -/
+@[extern "lean_float_array_mul_scalar"]
+def mulScalar (a : FloatArray) (s : Float) : FloatArray :=
+  (List.range a.size).foldl (fun a i => a.set! i (a.get! i * s)) a
+
+/-- Add `s` to every element of `a`. -/
+@[extern "lean_float_array_add_scalar"]
+def addScalar (a : FloatArray) (s : Float) : FloatArray :=
+  (List.range a.size).foldl (fun a i => a.set! i (a.get! i + s)) a
+
+/-- Replace `y[i]` with `y[i] + alpha * x[i]` for every `i` that is in bounds for both arrays. -/
+@[extern "lean_float_array_axpy"]
+def axpy (alpha : Float) (x : @& FloatArray) (y : FloatArray) : FloatArray :=
+  (List.range (Nat.min x.size y.size)).foldl (fun y i => y.set! i (y.get! i + alpha * x.get! i)) y
+
+end FloatArray
@@ -0,0 +1,236 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.ByteArray.Basic
+import Init.Data.Float32
+import Init.Data.SInt.Basic
+universe u
+
+/-!
+Arrays of unboxed `UInt32`, `UInt64`, `Int64` and `Float32` values.
+
+Like `ByteArray` and `FloatArray`, these are implemented by the runtime as scalar arrays: the elements
+are stored inline, without a pointer and a heap object per element. `Int64Array` uses the `UInt64Array`
+primitives since both are represented as `uint64_t`.
+-/
+
+open Lean in
+set_option hygiene false in
+/--
+Declares the scalar array type `typeName` with elements of type `elemType`, implemented by the runtime
+primitives `lean_<prim>_array_*`. The reference implementations of `toByteArray` and `ofByteArray`
+encode each element `x` as the `n` bytes of `toBits x : bits`, least significant first, and decode it with `ofBits`.
+-/
+macro "declare_scalar_array" typeName:ident elemType:ident prim:str bits:ident toBits:term:arg ofBits:term:arg
+    n:num : command => do
+  let ext (op : String) : StrLit := Syntax.mkStrLit ("lean_" ++ prim.getString ++ "_array_" ++ op)
+  let mkEmptyExt := Syntax.mkStrLit ("lean_mk_empty_" ++ prim.getString ++ "_array")
+  let q (n : Name) : Ident := mkIdent (typeName.getId ++ n)
+  let listFn := mkIdent (Name.mkStr `List ("to" ++ typeName.getId.toString))
+  let ofNat := mkIdent (bits.getId ++ `ofNat)
+  `(
+structure $typeName where
+  data : Array $elemType
+
+namespace $typeName
+attribute [extern $(ext "mk"):str] mk
+attribute [extern $(ext "data"):str] data
+
+@[extern $mkEmptyExt:str]
+def mkEmpty (c : @& Nat) : $typeName :=
+  { data := #[] }
+
+def empty : $typeName :=
+  mkEmpty 0
+
+instance : Inhabited $typeName where
+  default := empty
+
+instance : EmptyCollection $typeName where
+  emptyCollection := empty
+
+@[extern $(ext "push"):str]
+def push : $typeName → $elemType → $typeName
+  | ⟨ds⟩, b => ⟨ds.push b⟩
+
+@[extern $(ext "size"):str]
+def size : (@& $typeName) → Nat
+  | ⟨ds⟩ => ds.size
+
+@[extern "lean_sarray_size", simp]
+def usize (a : @& $typeName) : USize :=
+  a.size.toUSize
+
+@[extern $(ext "uget"):str]
+def uget : (a : @& $typeName) → (i : USize) → i.toNat < a.size → $elemType
+  | ⟨ds⟩, i, h => ds[i]
+
+@[extern $(ext "fget"):str]
+def get : (ds : @& $typeName) → (i : @& Nat) → (h : i < ds.size := by get_elem_tactic) → $elemType
+  | ⟨ds⟩, i, h => ds.get i h
+
+@[extern $(ext "get"):str]
+def get! : (@& $typeName) → (@& Nat) → $elemType
+  | ⟨ds⟩, i => ds.get! i
+
+def get? (ds : $typeName) (i : Nat) : Option $elemType :=
+  if h : i < ds.size then
+    some (ds.get i h)
+  else
+    none
+
+instance : GetElem $typeName Nat $elemType fun xs i => i < xs.size where
+  getElem xs i h := xs.get i h
+
+instance : GetElem $typeName USize $elemType fun xs i => i.val < xs.size where
+  getElem xs i h := xs.uget i h
+
+@[extern $(ext "uset"):str]
+def uset : (a : $typeName) → (i : USize) → $elemType → (h : i.toNat < a.size := by get_elem_tactic) → $typeName
+  | ⟨ds⟩, i, v, h => ⟨ds.uset i v h⟩
+
+@[extern $(ext "fset"):str]
+def set : (ds : $typeName) → (i : @& Nat) → $elemType → (h : i < ds.size := by get_elem_tactic) → $typeName
+  | ⟨ds⟩, i, d, h => ⟨ds.set i d h⟩
+
+@[extern $(ext "set"):str]
+def set! : $typeName → (@& Nat) → $elemType → $typeName
+  | ⟨ds⟩, i, d => ⟨ds.set! i d⟩
+
+def isEmpty (s : $typeName) : Bool :=
+  s.size == 0
+
+/-- An array of `n` copies of `v`. -/
+@[extern $(ext "replicate"):str]
+def replicate (n : @& Nat) (v : $elemType) : $typeName :=
+  ⟨mkArray n v⟩
+
+/-- Replace the elements at `[start, stop)` of `a` with `v`. Indices that are out of bounds are ignored. -/
+@[extern $(ext "fill"):str]
+def fill (a : $typeName) (start stop : @& Nat) (v : $elemType) : $typeName :=
+  (List.range (min stop a.size - start)).foldl (fun a i => a.set! (start + i) v) a
+
+/--
+  Copy the slice at `[srcOff, srcOff + len)` in `src` to `[destOff, destOff + len)` in `dest`, growing `dest` if necessary.
+  If `exact` is `false`, the capacity will be doubled when grown. -/
+@[extern "lean_sarray_copy_slice"]
+def copySlice (src : @& $typeName) (srcOff : Nat) (dest : $typeName) (destOff len : Nat) (exact : Bool := true) : $typeName :=
+  ⟨dest.data.extract 0 destOff ++ src.data.extract srcOff (srcOff + len) ++ dest.data.extract (destOff + min len (src.data.size - srcOff)) dest.data.size⟩
+
+def extract (a : $typeName) (b e : Nat) : $typeName :=
+  a.copySlice b empty 0 (e - b)
+
+protected def append (a : $typeName) (b : $typeName) : $typeName :=
+  -- we assume that `append`s may be repeated, so use asymptotic growing; use `copySlice` directly to customize
+  b.copySlice 0 a a.size b.size false
+
+instance : Append $typeName := ⟨$(q `append)⟩
+
+/-- The bytes of the elements of `a`, in little-endian order on all platforms. -/
+@[extern "lean_sarray_to_byte_array"]
+def toByteArray (a : @& $typeName) : ByteArray :=
+  a.data.foldl (fun bs x => (List.range $n).foldl (fun bs k => bs.push ($toBits x >>> $ofNat (8 * k)).toUInt8) bs) ByteArray.empty
+
+/-- The inverse of `toByteArray`. Trailing bytes that do not form a whole element are ignored. -/
+@[extern $(ext "of_byte_array"):str]
+def ofByteArray (bs : @& ByteArray) : $typeName :=
+  ⟨(Array.range (bs.size / $n)).map fun i =>
+    $ofBits <| (List.range $n).foldl (fun x k => x ||| $ofNat (bs.get! ($n * i + k)).toNat <<< $ofNat (8 * k)) 0⟩
+
+partial def toList (ds : $typeName) : List $elemType :=
+  let rec loop (i r) :=
+    if h : i < ds.size then
+      loop (i+1) (ds[i] :: r)
+    else
+      r.reverse
+  loop 0 []
+
+/--
+  We claim this unsafe implementation is correct because an array cannot have more than `usizeSz` elements in our runtime.
+  This is similar to the `Array` version.
+-/
+@[inline] unsafe def forInUnsafe {β : Type v} {m : Type v → Type w} [Monad m] (as : $typeName) (b : β) (f : $elemType → β → m (ForInStep β)) : m β :=
+  let sz := as.usize
+  let rec @[specialize] loop (i : USize) (b : β) : m β := do
+    if i < sz then
+      let a := as.uget i lcProof
+      match (← f a b) with
+      | ForInStep.done  b => pure b
+      | ForInStep.yield b => loop (i+1) b
+    else
+      pure b
+  loop 0 b
+
+/-- Reference implementation for `forIn` -/
+@[implemented_by forInUnsafe]
+protected def forIn {β : Type v} {m : Type v → Type w} [Monad m] (as : $typeName) (b : β) (f : $elemType → β → m (ForInStep β)) : m β :=
+  let rec loop (i : Nat) (h : i ≤ as.size) (b : β) : m β := do
+    match i, h with
+    | 0,   _ => pure b
+    | i+1, h =>
+      have h' : i < as.size            := Nat.lt_of_lt_of_le (Nat.lt_succ_self i) h
+      have : as.size - 1 < as.size     := Nat.sub_lt (Nat.zero_lt_of_lt h') (by decide)
+      have : as.size - 1 - i < as.size := Nat.lt_of_le_of_lt (Nat.sub_le (as.size - 1) i) this
+      match (← f as[as.size - 1 - i] b) with
+      | ForInStep.done b  => pure b
+      | ForInStep.yield b => loop i (Nat.le_of_lt h') b
+  loop as.size (Nat.le_refl _) b
+
+instance : ForIn m $typeName $elemType where
+  forIn := $(q `forIn)
+
+/-- See comment at `forInUnsafe` -/
+@[inline]
+unsafe def foldlMUnsafe {β : Type v} {m : Type v → Type w} [Monad m] (f : β → $elemType → m β) (init : β) (as : $typeName) (start := 0) (stop := as.size) : m β :=
+  let rec @[specialize] fold (i : USize) (stop : USize) (b : β) : m β := do
+    if i == stop then
+      pure b
+    else
+      fold (i+1) stop (← f b (as.uget i lcProof))
+  if start < stop then
+    if stop ≤ as.size then
+      fold (USize.ofNat start) (USize.ofNat stop) init
+    else
+      pure init
+  else
+    pure init
+
+/-- Reference implementation for `foldlM` -/
+@[implemented_by foldlMUnsafe]
+def foldlM {β : Type v} {m : Type v → Type w} [Monad m] (f : β → $elemType → m β) (init : β) (as : $typeName) (start := 0) (stop := as.size) : m β :=
+  let fold (stop : Nat) (h : stop ≤ as.size) :=
+    let rec loop (i : Nat) (j : Nat) (b : β) : m β := do
+      if hlt : j < stop then
+        match i with
+        | 0    => pure b
+        | i'+1 =>
+          loop i' (j+1) (← f b (as[j]'(Nat.lt_of_lt_of_le hlt h)))
+      else
+        pure b
+    loop (stop - start) start init
+  if h : stop ≤ as.size then
+    fold stop h
+  else
+    fold as.size (Nat.le_refl _)
+
+@[inline]
+def foldl {β : Type v} (f : β → $elemType → β) (init : β) (as : $typeName) (start := 0) (stop := as.size) : β :=
+  Id.run <| as.foldlM f init start stop
+
+end $typeName
+
+def $listFn (ds : List $elemType) : $typeName :=
+  let rec loop
+    | [],    r => r
+    | b::ds, r => loop ds (r.push b)
+  loop ds $(q `empty)
+
+instance : ToString $typeName := ⟨fun ds => ds.toList.toString⟩
+)
+
+declare_scalar_array UInt32Array UInt32 "uint32" UInt32 id id 4
+declare_scalar_array UInt64Array UInt64 "uint64" UInt64 id id 8
+declare_scalar_array Int64Array Int64 "uint64" UInt64 Int64.toUInt64 Int64.mk 8
+declare_scalar_array Float32Array Float32 "float32" UInt32 Float32.toBits Float32.ofBits 4
@@ -5,5 +5,6 @@ Authors: Leonardo de Moura
 -/
 prelude
 import Init.Data.String.Basic
+import Init.Data.String.Builder
 import Init.Data.String.Extra
 import Init.Data.String.Lemmas
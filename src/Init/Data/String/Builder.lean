@@ -0,0 +1,78 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.String.Basic
+
+namespace String
+
+private opaque BuilderPointed : NonemptyType.{0}
+
+/--
+A string builder, implemented by the runtime, that accumulates pieces of text and produces the final
+`String` with a single allocation of the exact size.
+
+Appending a long string, a `Substring` or a UTF-8 encoded `ByteArray` only stores a reference to it, and
+short pieces and characters are collected in chunks, so building a string from many pieces copies each
+byte once. The number of bytes and characters appended so far is maintained along the way, so `toString`
+does not need to count characters.
+
+In contrast, `s ++ t` copies `s` when it is shared and may copy it again whenever it grows.
+As for `Array`, updating a builder that is not shared modifies it in place.
+-/
+def Builder : Type := BuilderPointed.type
+
+instance : Nonempty Builder := BuilderPointed.property
+
+namespace Builder
+
+@[extern "lean_string_builder_mk"]
+opaque mkEmpty : Unit → Builder
+
+def empty : Builder := mkEmpty ()
+
+instance : Inhabited Builder := ⟨empty⟩
+
+instance : EmptyCollection Builder := ⟨empty⟩
+
+/-- Appends `s` to `b`. -/
+@[extern "lean_string_builder_append"]
+opaque append (b : Builder) (s : String) : Builder
+
+instance : HAppend Builder String Builder := ⟨append⟩
+
+/-- Appends `s.toString` to `b` without extracting it first. -/
+@[extern "lean_string_builder_append_substring"]
+opaque appendSubstring (b : Builder) (s : @& Substring) : Builder
+
+/-- Appends the character `c` to `b`. -/
+@[extern "lean_string_builder_push"]
+opaque push (b : Builder) (c : Char) : Builder
+
+/-- Appends `n` copies of the character `c` to `b`. -/
+@[extern "lean_string_builder_pushn"]
+opaque pushn (b : Builder) (c : Char) (n : @& Nat) : Builder
+
+/-- Number of bytes of the UTF-8 encoding of the text appended to `b` so far. -/
+@[extern "lean_string_builder_size"]
+opaque utf8ByteSize (b : @& Builder) : Nat
+
+/-- Number of characters appended to `b` so far. -/
+@[extern "lean_string_builder_length"]
+opaque length (b : @& Builder) : Nat
+
+/-- The text appended to `b`. -/
+@[extern "lean_string_builder_to_string"]
+opaque toString (b : @& Builder) : String
+
+def isEmpty (b : Builder) : Bool :=
+  b.utf8ByteSize == 0
+
+/-- Appends the strings of `l` to `b`. -/
+def appendList (b : Builder) (l : List String) : Builder :=
+  l.foldl append b
+
+end Builder
+
+end String
@@ -6,6 +6,7 @@ Author: Leonardo de Moura
 prelude
 import Init.Data.ByteArray
 import Init.Data.UInt.Lemmas
+import Init.Data.String.Builder
 
 namespace String
 
@@ -89,6 +90,10 @@ where
   termination_by a.size - i
   decreasing_by exact Nat.sub_lt_sub_left ‹_› (Nat.lt_add_of_pos_right c.utf8Size_pos)
 
+/-- Appends the [UTF-8](https://en.wikipedia.org/wiki/UTF-8) encoded `ByteArray` string `a` to `b` without copying it. -/
+@[extern "lean_string_builder_append_utf8"]
+opaque Builder.appendUTF8 (b : Builder) (a : ByteArray) (h : validateUTF8 a) : Builder
+
 /-- Converts a [UTF-8](https://en.wikipedia.org/wiki/UTF-8) encoded `ByteArray` string to `String`,
 or returns `none` if `a` is not properly UTF-8 encoded. -/
 @[inline] def fromUTF8? (a : ByteArray) : Option String :=
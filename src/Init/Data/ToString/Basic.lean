@@ -40,6 +40,11 @@ instance {p : Prop} : ToString (Decidable p) := ⟨fun h =>
   | Decidable.isTrue _  => "true"
   | Decidable.isFalse _ => "false"⟩
 
+private def List.toStringFast [ToString α] : List α → String
+  | [] => "[]"
+  | x::xs => xs.foldl (· ++ ", " ++ toString ·) (String.Builder.empty ++ "[" ++ toString x) |>.push ']' |>.toString
+
+@[implemented_by List.toStringFast]
 protected def List.toString [ToString α] : List α → String
   | [] => "[]"
   | [x] => "[" ++ toString x ++ "]"
@@ -3434,12 +3434,22 @@ opaque mixHash (u₁ u₂ : UInt64) : UInt64
 instance [Hashable α] {p : α → Prop} : Hashable (Subtype p) where
   hash a := hash a.val
 
-/-- An opaque string hash function. -/
+/--
+An opaque string hash function. `Name.hash` is computed from it and stored in .olean files, so its
+values do not change between Lean versions. Hash tables should use `hash` instead.
+-/
 @[extern "lean_string_hash"]
 protected opaque String.hash (s : @& String) : UInt64
 
+/--
+The string hash function used by `Hashable String`. It is faster than `String.hash`, in particular
+on long strings, but its values may change between Lean versions and must not be persisted.
+-/
+@[extern "lean_string_fast_hash"]
+protected opaque String.fastHash (s : @& String) : UInt64
+
 instance : Hashable String where
-  hash := String.hash
+  hash := String.fastHash
 
 namespace Lean
 
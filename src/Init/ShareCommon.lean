@@ -79,6 +79,28 @@ unsafe def mkStateImpl (σ : StateFactory) : State σ := unsafeCast (σ.get.mkSt
 @[implemented_by mkStateImpl] opaque State.mk (σ : StateFactory) : State σ
 instance : Inhabited (State σ) := ⟨.mk σ⟩
 
+@[extern "lean_sharecommon_mk_native_state"]
+private opaque mkNativeState (capacity : USize) : NonScalar
+
+unsafe def StateFactory.nativeImpl : StateFactory :=
+  unsafeCast {
+    Map := Unit, Set := Unit
+    mkState := fun _ => unsafeCast (mkNativeState 1024)
+    mapFind? := fun _ _ => none
+    mapInsert := fun _ _ _ => ()
+    setFind? := fun _ _ => none
+    setInsert := fun _ _ => ()
+  : StateFactoryImpl }
+
+/--
+A state factory whose states are hash-consing tables implemented natively in the runtime.
+Compared to the states of `StateFactory.mk`, they do not allocate a map node per visited object and
+do not call Lean closures. Like other values, a state is updated in place when it is not shared,
+and copied otherwise.
+-/
+@[implemented_by StateFactory.nativeImpl]
+opaque StateFactory.native : StateFactory
+
 @[extern "lean_state_sharecommon"]
 def State.shareCommon {σ : @& StateFactory} (s : State σ) (a : α) : α × State σ := (a, s)
 
@@ -328,6 +328,15 @@ inductive FS.Mode where
 
 opaque FS.Handle : Type := Unit
 
+/--
+  A read-only memory mapping of a file. The contents are accessed without copying them through a
+  buffer; the mapping is released when the object is freed.
+
+  Other processes may still modify the file while it is mapped, and such changes can become visible
+  through the mapping, which is why reading it is an `IO` action. If the file is truncated, reading
+  a page beyond its new end raises `SIGBUS` and terminates the program. -/
+opaque FS.MappedFile : Type := Unit
+
 /--
   A pure-Lean abstraction of POSIX streams. We use `Stream`s for the standard streams stdin/stdout/stderr so we can
   capture output of `#eval` commands into memory. -/
@@ -427,10 +436,30 @@ If the returned string is empty, an end-of-file marker has been reached.
 Note that EOF does not actually close a handle, so further reads may block and return more data.
 -/
 @[extern "lean_io_prim_handle_get_line"] opaque getLine (h : @& Handle) : IO String
+/--
+Read up to `max` lines from the handle, as if by calling `getLine` repeatedly.
+Stops early, without returning an empty line, when an end-of-file marker is reached.
+-/
+@[extern "lean_io_prim_handle_get_lines"] opaque getLines (h : @& Handle) (max : USize) : IO (Array String)
 @[extern "lean_io_prim_handle_put_str"] opaque putStr (h : @& Handle) (s : @& String) : IO Unit
 
 end Handle
 
+namespace MappedFile
+
+/-- Maps the given file into memory for reading. -/
+@[extern "lean_io_mapped_file_mk"] opaque mk (fn : @& FilePath) : IO MappedFile
+/-- Size of the mapped file in bytes, at the time it was mapped. -/
+@[extern "lean_io_mapped_file_size"] opaque size (m : @& MappedFile) : USize
+/-- Returns the byte at position `i`, or `0` if `i` is out of bounds. -/
+@[extern "lean_io_mapped_file_get"] opaque get (m : @& MappedFile) (i : USize) : BaseIO UInt8
+/-- Copies the bytes in the range `[start, stop)` into a new `ByteArray`. -/
+@[extern "lean_io_mapped_file_extract"] opaque extract (m : @& MappedFile) (start stop : USize) : BaseIO ByteArray
+/-- Returns the position of the first occurrence of `b` at or after `start`, or `m.size` if there is none. -/
+@[extern "lean_io_mapped_file_find_byte"] opaque findByte (m : @& MappedFile) (b : UInt8) (start : USize) : BaseIO USize
+
+end MappedFile
+
 /--
 Resolves a pathname to an absolute pathname with no '.', '..', or symbolic links.
 
@@ -489,7 +518,7 @@ def Handle.putStrLn (h : Handle) (s : String) : IO Unit :=
 
 partial def Handle.readBinToEndInto (h : Handle) (buf : ByteArray) : IO ByteArray := do
   let rec loop (acc : ByteArray) : IO ByteArray := do
-    let buf ← h.read 1024
+    let buf ← h.read 65536
     if buf.isEmpty then
       return acc
     else
@@ -507,16 +536,20 @@ def Handle.readToEnd (h : Handle) : IO String := do
 
 partial def lines (fname : FilePath) : IO (Array String) := do
   let h ← Handle.mk fname Mode.read
+  let batchSize : USize := 1024
   let rec read (lines : Array String) := do
-    let line ← h.getLine
-    if line.length == 0 then
+    let batch ← h.getLines batchSize
+    let lines := batch.foldl (init := lines) fun lines line =>
+      if line.back == '\n' then
+        let line := line.dropRight 1
+        let line := if line.back == '\r' then line.dropRight 1 else line
+        lines.push line
+      else
+        lines.push line
+    if batch.size < batchSize.toNat then
       pure lines
-    else if line.back == '\n' then
-      let line := line.dropRight 1
-      let line := if line.back == '\r' then line.dropRight 1 else line
-      read <| lines.push line
     else
-      pure <| lines.push line
+      read lines
   read #[]
 
 def writeBinFile (fname : FilePath) (content : ByteArray) : IO Unit := do
@@ -629,6 +662,25 @@ def readFile (fname : FilePath) : IO String := do
   | some s => return s
   | none => throw <| .userError s!"Tried to read file '{fname}' containing non UTF-8 data."
 
+/-!
+Batched variants of `FilePath.metadata`, `readBinFile` and `writeBinFile` for processing many files
+at once. On Linux, the syscalls of all files are submitted together through io_uring when the kernel
+supports it (set the environment variable `LEAN_IO_URING=0` to disable it). Elsewhere, the files are
+processed one after another. Failures are reported per file and do not affect the other files.
+-/
+
+/-- Retrieves the metadata of all files, see `System.FilePath.metadata`. -/
+@[extern "lean_io_metadata_batch"]
+opaque metadataBatch : @& Array FilePath → BaseIO (Array (Except IO.Error IO.FS.Metadata))
+
+/-- Reads the contents of all files, see `readBinFile`. -/
+@[extern "lean_io_read_bin_file_batch"]
+opaque readBinFileBatch : @& Array FilePath → BaseIO (Array (Except IO.Error ByteArray))
+
+/-- Writes the contents of all files, replacing them if they exist, see `writeBinFile`. -/
+@[extern "lean_io_write_bin_file_batch"]
+opaque writeBinFileBatch : @& Array (FilePath × ByteArray) → BaseIO (Array (Except IO.Error Unit))
+
 end FS
 
 def withStdin [Monad m] [MonadFinally m] [MonadLiftT BaseIO m] (h : FS.Stream) (x : m α) : m α := do
@@ -992,3 +1044,36 @@ lead to undefined behavior.
 -/
 @[extern "lean_runtime_forget"]
 def Runtime.forget (a : α) : BaseIO Unit := return
+
+/--
+Enables deferred deallocation of large object graphs when `threshold` is not `0`. When a thread drops
+the last reference to an object graph, it frees at most `threshold` objects itself, and the remaining
+multi-threaded objects are freed by a background thread. Single-threaded objects are always freed by
+the thread that drops them. This avoids latency spikes when big multi-threaded structures such as
+old environments are released. Deferred deallocation is disabled by default.
+-/
+@[extern "lean_runtime_set_deferred_free_threshold"]
+opaque Runtime.setDeferredFreeThreshold (threshold : USize) : BaseIO Unit
+
+/--
+Returns the number of objects waiting to be freed by the background thread of deferred deallocation
+(see `Runtime.setDeferredFreeThreshold`). This includes the objects handed to it and the objects that
+became unreachable from them but have not been freed yet, and it is `0` when the background thread
+is idle.
+-/
+@[extern "lean_runtime_get_deferred_free_backlog"]
+opaque Runtime.getDeferredFreeBacklog : BaseIO Nat
+
+/--
+Returns the total number of objects freed by the background thread of deferred deallocation (see
+`Runtime.setDeferredFreeThreshold`) since the start of the program.
+-/
+@[extern "lean_runtime_get_deferred_free_total"]
+opaque Runtime.getDeferredFreeTotal : BaseIO Nat
+
+/--
+Returns the number of closed terms extracted by the compiler that were computed on first access instead of by the
+module initializer. This only happens in C code compiled with `-DLEAN_LAZY_CLOSED_TERMS`.
+-/
+@[extern "lean_runtime_get_lazy_closed_term_inits"]
+opaque Runtime.getLazyClosedTermInits : BaseIO Nat
@@ -71,6 +71,11 @@ opaque Ref.swap {σ α} (r : @& Ref σ α) (a : α) : ST σ α := inhabitedFromR
 unsafe opaque Ref.take {σ α} (r : @& Ref σ α) : ST σ α := inhabitedFromRef r
 @[extern "lean_st_ref_ptr_eq"]
 opaque Ref.ptrEq {σ α} (r1 r2 : @& Ref σ α) : ST σ Bool
+/--
+Atomically replaces the value of `r` with `a` if the current value is pointer equal to `expected`.
+Returns `true` if the value has been replaced. -/
+@[extern "lean_st_ref_ptr_compare_exchange"]
+unsafe opaque Ref.ptrCompareExchange {σ α} (r : @& Ref σ α) (expected : @& α) (a : α) : ST σ Bool
 
 @[inline] unsafe def Ref.modifyUnsafe {σ α : Type} (r : Ref σ α) (f : α → α) : ST σ Unit := do
   let v ← Ref.take r
@@ -82,6 +87,14 @@ opaque Ref.ptrEq {σ α} (r1 r2 : @& Ref σ α) : ST σ Bool
   Ref.set r a
   pure b
 
+@[specialize] unsafe def Ref.modifyGetLockFreeUnsafe {σ α β : Type} (r : Ref σ α) (f : α → β × α) : ST σ β := do
+  let v ← Ref.get r
+  let (b, a) := f v
+  if (← Ref.ptrCompareExchange r v a) then
+    pure b
+  else
+    Ref.modifyGetLockFreeUnsafe r f
+
 @[implemented_by Ref.modifyUnsafe]
 def Ref.modify {σ α : Type} (r : Ref σ α) (f : α → α) : ST σ Unit := do
   let v ← Ref.get r
@@ -94,6 +107,18 @@ def Ref.modifyGet {σ α β : Type} (r : Ref σ α) (f : α → β × α) : ST 
   Ref.set r a
   pure b
 
+/--
+Like `Ref.modifyGet`, but other threads can keep reading `r` while `f` is being evaluated:
+the new value is installed using a compare-and-swap, and `f` is reevaluated if `r` has been
+modified in the meantime. Thus, `f` should be cheap, and the old value is never updated in place.
+-/
+@[implemented_by Ref.modifyGetLockFreeUnsafe]
+def Ref.modifyGetLockFree {σ α β : Type} (r : Ref σ α) (f : α → β × α) : ST σ β := do
+  let v ← Ref.get r
+  let (b, a) := f v
+  Ref.set r a
+  pure b
+
 end Prim
 
 section
@@ -107,6 +132,7 @@ variable {σ : Type} {m : Type → Type} [Monad m] [MonadLiftT (ST σ) m]
 @[inline] def Ref.ptrEq {α : Type} (r1 r2 : Ref σ α) : m Bool := liftM <| Prim.Ref.ptrEq r1 r2
 @[inline] def Ref.modify {α : Type} (r : Ref σ α) (f : α → α) : m Unit := liftM <| Prim.Ref.modify r f
 @[inline] def Ref.modifyGet {α : Type} {β : Type} (r : Ref σ α) (f : α → β × α) : m β := liftM <| Prim.Ref.modifyGet r f
+@[inline] def Ref.modifyGetLockFree {α : Type} {β : Type} (r : Ref σ α) (f : α → β × α) : m β := liftM <| Prim.Ref.modifyGetLockFree r f
 
 def Ref.toMonadStateOf (r : Ref σ α) : MonadStateOf α m where
   get := r.get
@@ -92,6 +92,13 @@ def toCInitName (n : Name) : M String := do
 def emitCInitName (n : Name) : M Unit :=
   toCInitName n >>= emit
 
+/--
+Extracted closed terms are accessed through `lean_closed_term_get`, which computes them on first access instead of in
+the module initializer when the C code is compiled with `-DLEAN_LAZY_CLOSED_TERMS`.
+-/
+def isLazyClosedTerm (decl : Decl) : M Bool := do
+  return decl.params.isEmpty && decl.resultType.isObj && isClosedTermName (← getEnv) decl.name
+
 def emitFnDeclAux (decl : Decl) (cppBaseName : String) (isExternal : Bool) : M Unit := do
   let ps := decl.params
   let env ← getEnv
@@ -114,6 +121,8 @@ def emitFnDeclAux (decl : Decl) (cppBaseName : String) (isExternal : Bool) : M U
         emit (toCType ps[i].ty)
     emit ")"
   emitLn ";"
+  if (← isLazyClosedTerm decl) then
+    emit ("static " ++ toCType decl.resultType ++ " "); emitCInitName decl.name; emitLn "(void);"
 
 def emitFnDecl (decl : Decl) (isExternal : Bool) : M Unit := do
   let cppBaseName ← toCName decl.name
@@ -428,9 +437,12 @@ def emitFullApp (z : VarId) (f : FunId) (ys : Array Arg) : M Unit := do
   match decl with
   | Decl.extern _ ps _ extData => emitExternCall f ps extData ys
   | _ =>
-    emitCName f
-    if ys.size > 0 then emit "("; emitArgs ys; emit ")"
-    emitLn ";"
+    if (← isLazyClosedTerm decl) then
+      emit "lean_closed_term_get(&"; emitCName f; emit ", "; emitCInitName f; emitLn ");"
+    else
+      emitCName f
+      if ys.size > 0 then emit "("; emitArgs ys; emit ")"
+      emitLn ";"
 
 def emitPartialApp (z : VarId) (f : FunId) (ys : Array Arg) : M Unit := do
   let decl ← getDecl f
@@ -725,7 +737,10 @@ def emitDeclInit (d : Decl) : M Unit := do
       if getBuiltinInitFnNameFor? env d.name |>.isSome then
         emit "}"
     | _ =>
+      let lazy ← isLazyClosedTerm d
+      if lazy then emitLn "#ifndef LEAN_LAZY_CLOSED_TERMS"
       emitCName n; emit " = "; emitCInitName n; emitLn "();"; emitMarkPersistent d n
+      if lazy then emitLn "#endif"
 
 def emitInitFn : M Unit := do
   let env ← getEnv
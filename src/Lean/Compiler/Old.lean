@@ -52,4 +52,11 @@ def isUnsafeRecName? : Name → Option Name
   | .str n "_unsafe_rec" => some n
   | _ => none
 
+/--
+Returns the number of worker threads started so far by the (old) code generator to process the declarations of a
+mutual block in parallel, see the `compiler.parallel` option.
+-/
+@[extern "lean_compiler_get_parallel_workers"]
+opaque getParallelWorkers : BaseIO Nat
+
 end Compiler
@@ -29,4 +29,5 @@ import Lean.Data.Xml
 import Lean.Data.NameTrie
 import Lean.Data.RBTree
 import Lean.Data.RBMap
+import Lean.Data.RRBVector
 import Lean.Data.RArray
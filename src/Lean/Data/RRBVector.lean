@@ -0,0 +1,157 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.Array.Basic
+import Init.NotationExtra
+import Init.Data.ToString.Macro
+
+universe u v w
+
+namespace Lean
+
+private opaque RRBVectorPointed : NonemptyType.{0}
+
+private structure RRBVectorImpl (α : Type u) : Type u where
+  ptr : RRBVectorPointed.type
+
+/--
+A persistent vector implemented by the runtime as a relaxed radix balanced tree (RRB tree).
+
+`push`, `pop`, `set`, `get?`, `append` and `extract` take `O(log n)` time, even when older versions of the
+vector are still in use. As for `Array`, updating a vector that is not shared modifies it in place, so
+a batch of updates only copies the nodes that are shared with other versions.
+
+In contrast, updating a shared `Array` copies all of its elements, and `PersistentArray` does not support
+efficient concatenation and slicing.
+-/
+def RRBVector (α : Type u) : Type u := RRBVectorImpl α
+
+instance : Nonempty (RRBVector α) :=
+  Nonempty.intro { ptr := Classical.choice RRBVectorPointed.property }
+
+namespace RRBVector
+
+@[extern "lean_rrb_mk_empty"]
+opaque mkEmpty : Unit → RRBVector α
+
+def empty : RRBVector α := mkEmpty ()
+
+instance : Inhabited (RRBVector α) := ⟨empty⟩
+
+instance : EmptyCollection (RRBVector α) := ⟨empty⟩
+
+/-- Number of elements in `v`. -/
+@[extern "lean_rrb_size"]
+opaque size (v : @& RRBVector α) : Nat
+
+def isEmpty (v : RRBVector α) : Bool :=
+  v.size == 0
+
+/-- The `i`-th element of `v`, or `none` if `i` is out of bounds. -/
+@[extern "lean_rrb_get_opt"]
+opaque get? (v : @& RRBVector α) (i : @& Nat) : Option α
+
+/-- The `i`-th element of `v`, or `v₀` if `i` is out of bounds. -/
+@[extern "lean_rrb_get_d"]
+opaque getD (v : @& RRBVector α) (i : @& Nat) (v₀ : α) : α := v₀
+
+def get! [Inhabited α] (v : RRBVector α) (i : Nat) : α :=
+  match v.get? i with
+  | some a => a
+  | none   => panic! "index out of bounds"
+
+def back? (v : RRBVector α) : Option α :=
+  v.get? (v.size - 1)
+
+/-- Replace the `i`-th element of `v` with `a`. If `i` is out of bounds, `v` is returned unchanged. -/
+@[extern "lean_rrb_set"]
+opaque set (v : RRBVector α) (i : @& Nat) (a : α) : RRBVector α
+
+def modify (v : RRBVector α) (i : Nat) (f : α → α) : RRBVector α :=
+  match v.get? i with
+  | some a => v.set i (f a)
+  | none   => v
+
+@[extern "lean_rrb_push"]
+opaque push (v : RRBVector α) (a : α) : RRBVector α
+
+/-- Remove the last element of `v`, if any. -/
+@[extern "lean_rrb_pop"]
+opaque pop (v : RRBVector α) : RRBVector α
+
+/-- Concatenate `v` and `w` in `O(log (v.size + w.size))` time. -/
+@[extern "lean_rrb_append"]
+opaque append (v w : RRBVector α) : RRBVector α
+
+instance : Append (RRBVector α) := ⟨append⟩
+
+/-- The elements of `v` with indices in `[start, stop)`, in `O(log v.size)` time. -/
+@[extern "lean_rrb_extract"]
+opaque extract (v : RRBVector α) (start stop : @& Nat) : RRBVector α
+
+@[extern "lean_rrb_of_array"]
+opaque ofArray (as : Array α) : RRBVector α
+
+@[extern "lean_rrb_to_array"]
+opaque toArray (v : @& RRBVector α) : Array α
+
+/--
+The elements of `v` as a sequence of non-empty arrays, in order.
+The arrays are the leaves of the tree, so this does not copy any element.
+-/
+@[extern "lean_rrb_to_chunks"]
+opaque toChunks (v : @& RRBVector α) : Array (Array α)
+
+def ofList (as : List α) : RRBVector α :=
+  ofArray as.toArray
+
+def toList (v : RRBVector α) : List α :=
+  v.toArray.toList
+
+/-- Push all elements of `as`. -/
+def appendArray (v : RRBVector α) (as : Array α) : RRBVector α :=
+  as.foldl push v
+
+section
+variable {m : Type v → Type w} [Monad m]
+variable {β : Type v}
+
+@[specialize] def foldlM (v : RRBVector α) (f : β → α → m β) (init : β) : m β :=
+  v.toChunks.foldlM (fun b c => c.foldlM f b) init
+
+@[specialize] protected def forIn (v : RRBVector α) (init : β) (f : α → β → m (ForInStep β)) : m β := do
+  let mut b := init
+  for c in v.toChunks do
+    for a in c do
+      match (← f a b) with
+      | ForInStep.done r => return r
+      | ForInStep.yield bNew => b := bNew
+  return b
+
+instance : ForIn m (RRBVector α) α where
+  forIn := RRBVector.forIn
+
+@[specialize] def forM (v : RRBVector α) (f : α → m PUnit) : m PUnit :=
+  v.toChunks.forM (·.forM f)
+
+end
+
+@[inline] def foldl (v : RRBVector α) (f : β → α → β) (init : β) : β :=
+  Id.run <| v.foldlM f init
+
+instance [ToString α] : ToString (RRBVector α) where
+  toString v := "RRBVector.ofList " ++ toString v.toList
+
+end RRBVector
+
+end Lean
+
+open Lean (RRBVector)
+
+def List.toRRBVector {α : Type u} (as : List α) : RRBVector α :=
+  RRBVector.ofList as
+
+def Array.toRRBVector {α : Type u} (as : Array α) : RRBVector α :=
+  RRBVector.ofArray as
@@ -22,7 +22,8 @@ inductive Literal where
 
 protected def Literal.hash : Literal → UInt64
   | .natVal v => hash v
-  | .strVal v => hash v
+  -- `Expr.data` hashes are stored in .olean files, so we use the stable `String.hash`
+  | .strVal v => v.hash
 
 instance : Hashable Literal := ⟨Literal.hash⟩
 
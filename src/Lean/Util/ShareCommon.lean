@@ -14,6 +14,10 @@ open ShareCommon
 namespace Lean.ShareCommon
 
 def objectFactory :=
+  StateFactory.native
+
+/-- Same as `objectFactory`, but the states are implemented using `Std.HashMap` and `Std.HashSet`. -/
+def hashMapObjectFactory :=
   StateFactory.mk {
     Map := Std.HashMap, mkMap := (Std.HashMap.empty ·), mapFind? := (·.get?), mapInsert := (·.insert)
     Set := Std.HashSet, mkSet := (Std.HashSet.empty ·), setFind? := (·.get?), setInsert := (·.insert)
@@ -0,0 +1,81 @@
+/-
+Copyright (c) 2024 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Std.Internal.UV
+import Std.Internal.Async.Basic
+
+
+namespace Std
+namespace Internal
+namespace IO
+namespace Async
+namespace FS
+
+/--
+A file whose operations are performed on the event loop instead of blocking the calling thread.
+-/
+structure File where
+  private ofNative ::
+    native : Internal.UV.FS.File
+
+namespace File
+
+/--
+Open the file at `path` with the given `mode`.
+-/
+@[inline]
+def «open» (path : System.FilePath) (mode : IO.FS.Mode) : IO (AsyncTask File) := do
+  let promise ← Internal.UV.FS.File.open path mode
+  return AsyncTask.ofPromise promise |>.map ofNative
+
+/--
+Read up to `nbytes` bytes from `f` at `offset`, or at the current position if `offset` is `none`.
+The returned `ByteArray` is empty at the end of the file.
+-/
+@[inline]
+def read (f : File) (nbytes : USize) (offset : Option UInt64 := none) : IO (AsyncTask ByteArray) := do
+  let promise ← f.native.read nbytes (offset.map (·.toNat.toInt64) |>.getD (-1))
+  return AsyncTask.ofPromise promise
+
+/--
+Write `data` to `f` at `offset`, or at the current position if `offset` is `none`. Returns the number
+of bytes written.
+-/
+@[inline]
+def write (f : File) (data : ByteArray) (offset : Option UInt64 := none) : IO (AsyncTask UInt64) := do
+  let promise ← f.native.write data (offset.map (·.toNat.toInt64) |>.getD (-1))
+  return AsyncTask.ofPromise promise
+
+/--
+Close `f`. Any later operation on `f` fails.
+-/
+@[inline]
+def close (f : File) : IO (AsyncTask Unit) := do
+  let promise ← f.native.close
+  return AsyncTask.ofPromise promise
+
+end File
+
+/--
+Query the metadata of the file at `path`.
+-/
+@[inline]
+def metadata (path : System.FilePath) : IO (AsyncTask IO.FS.Metadata) := do
+  let promise ← Internal.UV.FS.metadata path
+  return AsyncTask.ofPromise promise
+
+/--
+List the names of the entries of the directory at `path`.
+-/
+@[inline]
+def readDir (path : System.FilePath) : IO (AsyncTask (Array String)) := do
+  let promise ← Internal.UV.FS.readDir path
+  return AsyncTask.ofPromise promise
+
+end FS
+end Async
+end IO
+end Internal
+end Std
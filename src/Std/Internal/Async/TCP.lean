@@ -0,0 +1,170 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Std.Net.Addr
+import Std.Internal.UV
+import Std.Internal.Async.Basic
+
+
+namespace Std
+namespace Internal
+namespace IO
+namespace Async
+namespace TCP
+
+open Std.Net
+
+namespace Socket
+
+/--
+A TCP socket that listens for incoming connections.
+-/
+structure Server where
+  private ofNative ::
+    native : Internal.UV.TCP.Socket
+
+/--
+A TCP socket connected to a peer.
+-/
+structure Client where
+  private ofNative ::
+    native : Internal.UV.TCP.Socket
+
+namespace Server
+
+/--
+Create a new `Server` socket.
+-/
+@[inline]
+def mk : IO Server := do
+  let native ← Internal.UV.TCP.Socket.new
+  return ofNative native
+
+/--
+Bind `s` to `addr`.
+-/
+@[inline]
+def bind (s : Server) (addr : SocketAddress) : IO Unit :=
+  s.native.bind addr
+
+/--
+Start listening for incoming connections, queueing up to `backlog` of them.
+-/
+@[inline]
+def listen (s : Server) (backlog : UInt32) : IO Unit :=
+  s.native.listen backlog
+
+/--
+Accept the next incoming connection.
+-/
+@[inline]
+def accept (s : Server) : IO (AsyncTask Client) := do
+  let promise ← s.native.accept
+  return AsyncTask.ofPromise promise |>.map Client.ofNative
+
+/--
+The address `s` is bound to.
+-/
+@[inline]
+def getSockName (s : Server) : IO SocketAddress :=
+  s.native.getSockName
+
+end Server
+
+namespace Client
+
+/--
+Create a new, unconnected `Client` socket.
+-/
+@[inline]
+def mk : IO Client := do
+  let native ← Internal.UV.TCP.Socket.new
+  return ofNative native
+
+/--
+Connect `s` to `addr`.
+-/
+@[inline]
+def connect (s : Client) (addr : SocketAddress) : IO (AsyncTask Unit) := do
+  let promise ← s.native.connect addr
+  return AsyncTask.ofPromise promise
+
+/--
+Send `data` to the peer without copying it.
+-/
+@[inline]
+def send (s : Client) (data : ByteArray) : IO (AsyncTask Unit) := do
+  let promise ← s.native.send #[data]
+  return AsyncTask.ofPromise promise
+
+/--
+Send the concatenation of `data` to the peer without copying it.
+-/
+@[inline]
+def sendAll (s : Client) (data : Array ByteArray) : IO (AsyncTask Unit) := do
+  let promise ← s.native.send data
+  return AsyncTask.ofPromise promise
+
+/--
+Receive up to `size` bytes from the peer, or `none` once the peer has shut down its side of the
+connection.
+-/
+@[inline]
+def recv? (s : Client) (size : UInt64) : IO (AsyncTask (Option ByteArray)) := do
+  let promise ← s.native.recv? size
+  return AsyncTask.ofPromise promise
+
+/--
+The number of bytes passed to `send` that were not yet handed to the kernel.
+-/
+@[inline]
+def writeQueueSize (s : Client) : IO UInt64 :=
+  s.native.writeQueueSize
+
+/--
+Shut down the writing side of `s` after all pending writes.
+-/
+@[inline]
+def shutdown (s : Client) : IO (AsyncTask Unit) := do
+  let promise ← s.native.shutdown
+  return AsyncTask.ofPromise promise
+
+/--
+The address of the peer.
+-/
+@[inline]
+def getPeerName (s : Client) : IO SocketAddress :=
+  s.native.getPeerName
+
+/--
+The address `s` is bound to.
+-/
+@[inline]
+def getSockName (s : Client) : IO SocketAddress :=
+  s.native.getSockName
+
+/--
+Disable Nagle's algorithm.
+-/
+@[inline]
+def noDelay (s : Client) : IO Unit :=
+  s.native.noDelay
+
+/--
+Enable or disable TCP keep-alive, `delay` is the initial delay in seconds.
+-/
+@[inline]
+def keepAlive (s : Client) (enable : Bool) (delay : UInt32 := 60) : IO Unit :=
+  s.native.keepAlive enable delay
+
+end Client
+
+end Socket
+
+end TCP
+end Async
+end IO
+end Internal
+end Std
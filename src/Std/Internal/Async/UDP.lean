@@ -0,0 +1,86 @@
+/-
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Std.Net.Addr
+import Std.Internal.UV
+import Std.Internal.Async.Basic
+
+
+namespace Std
+namespace Internal
+namespace IO
+namespace Async
+namespace UDP
+
+open Std.Net
+
+/--
+A UDP socket.
+-/
+structure Socket where
+  private ofNative ::
+    native : Internal.UV.UDP.Socket
+
+namespace Socket
+
+/--
+Create a new UDP socket.
+-/
+@[inline]
+def mk : IO Socket := do
+  let native ← Internal.UV.UDP.Socket.new
+  return ofNative native
+
+/--
+Bind `s` to `addr`.
+-/
+@[inline]
+def bind (s : Socket) (addr : SocketAddress) : IO Unit :=
+  s.native.bind addr
+
+/--
+Associate `s` with the remote `addr`, so that `send` may omit the address.
+-/
+@[inline]
+def connect (s : Socket) (addr : SocketAddress) : IO Unit :=
+  s.native.connect addr
+
+/--
+Send `data` as a single datagram to `addr`, or to the connected peer if `addr` is `none`.
+-/
+@[inline]
+def send (s : Socket) (data : ByteArray) (addr : Option SocketAddress := none) : IO (AsyncTask Unit) := do
+  let promise ← s.native.send #[data] addr
+  return AsyncTask.ofPromise promise
+
+/--
+Receive a datagram of up to `size` bytes together with the address of its sender.
+-/
+@[inline]
+def recv (s : Socket) (size : UInt64) : IO (AsyncTask (ByteArray × Option SocketAddress)) := do
+  let promise ← s.native.recv size
+  return AsyncTask.ofPromise promise
+
+/--
+The address of the connected peer.
+-/
+@[inline]
+def getPeerName (s : Socket) : IO SocketAddress :=
+  s.native.getPeerName
+
+/--
+The address `s` is bound to.
+-/
+@[inline]
+def getSockName (s : Socket) : IO SocketAddress :=
+  s.native.getSockName
+
+end Socket
+
+end UDP
+end Async
+end IO
+end Internal
+end Std
@@ -6,6 +6,7 @@ Authors: Sofia Rodrigues
 prelude
 import Init.System.IO
 import Init.System.Promise
+import Std.Net.Addr
 
 namespace Std
 namespace Internal
@@ -114,6 +115,232 @@ opaque stop (timer : @& Timer) : IO Unit
 
 end Timer
 
+namespace FS
+
+private opaque FileImpl : NonemptyType.{0}
+
+/--
+A file opened through the event loop with `File.open`. All operations on a `File` are performed by
+the libuv thread pool and report their result through an `IO.Promise`, the calling thread is never
+blocked on the file system. The file is closed when it is freed unless `File.close` was called.
+-/
+def File : Type := FileImpl.type
+
+instance : Nonempty File := FileImpl.property
+
+namespace File
+
+/--
+Open the file at `path` with the given `mode`. The flags used for each `mode` are the same as for
+`IO.FS.Handle.mk`.
+-/
+@[extern "lean_uv_fs_open"]
+opaque «open» (path : @& System.FilePath) (mode : IO.FS.Mode) : IO (IO.Promise (Except IO.Error File))
+
+/--
+Read up to `nbytes` bytes from `file` starting at `offset`. If `offset` is `-1` the read starts at
+the current file position, which is advanced by the read. An empty `ByteArray` signals the end of
+the file.
+-/
+@[extern "lean_uv_fs_read"]
+opaque read (file : @& File) (nbytes : USize) (offset : Int64) : IO (IO.Promise (Except IO.Error ByteArray))
+
+/--
+Write `data` to `file` starting at `offset`, returning the number of bytes written. If `offset` is
+`-1` the write starts at the current file position, which is advanced by the write.
+-/
+@[extern "lean_uv_fs_write"]
+opaque write (file : @& File) (data : ByteArray) (offset : Int64) : IO (IO.Promise (Except IO.Error UInt64))
+
+/--
+Close `file`. Any later operation on `file` fails.
+-/
+@[extern "lean_uv_fs_close"]
+opaque close (file : @& File) : IO (IO.Promise (Except IO.Error Unit))
+
+end File
+
+/--
+Query the metadata of the file at `path`, see `System.FilePath.metadata`.
+-/
+@[extern "lean_uv_fs_stat"]
+opaque metadata (path : @& System.FilePath) : IO (IO.Promise (Except IO.Error IO.FS.Metadata))
+
+/--
+List the names of the entries of the directory at `path`, excluding `.` and `..`.
+-/
+@[extern "lean_uv_fs_read_dir"]
+opaque readDir (path : @& System.FilePath) : IO (IO.Promise (Except IO.Error (Array String)))
+
+end FS
+
+namespace TCP
+
+open Std.Net
+
+private opaque SocketImpl : NonemptyType.{0}
+
+/--
+A TCP socket on the event loop. Operations that wait for the network return an `IO.Promise` that is
+resolved from the event loop. At most one `recv?` and one `accept` may be pending at a time.
+-/
+def Socket : Type := SocketImpl.type
+
+instance : Nonempty Socket := SocketImpl.property
+
+namespace Socket
+
+/--
+Create a new TCP socket.
+-/
+@[extern "lean_uv_tcp_new"]
+opaque new : IO Socket
+
+/--
+Connect `socket` to `addr`.
+-/
+@[extern "lean_uv_tcp_connect"]
+opaque connect (socket : @& Socket) (addr : @& SocketAddress) : IO (IO.Promise (Except IO.Error Unit))
+
+/--
+Send the concatenation of `data` over `socket`. The `ByteArray`s are not copied, the returned
+`IO.Promise` resolves once all of them are written. Use `writeQueueSize` to limit the amount of data
+that is in flight.
+-/
+@[extern "lean_uv_tcp_send"]
+opaque send (socket : @& Socket) (data : Array ByteArray) : IO (IO.Promise (Except IO.Error Unit))
+
+/--
+Receive up to `size` bytes from `socket`. The socket is only read from while a `recv?` is pending,
+so a peer can never send more than the kernel buffers hold. Resolves to `none` once the peer has
+shut down its side of the connection.
+-/
+@[extern "lean_uv_tcp_recv"]
+opaque recv? (socket : @& Socket) (size : UInt64) : IO (IO.Promise (Except IO.Error (Option ByteArray)))
+
+/--
+The number of bytes that were passed to `send` but not yet written to the kernel.
+-/
+@[extern "lean_uv_tcp_write_queue_size"]
+opaque writeQueueSize (socket : @& Socket) : IO UInt64
+
+/--
+Bind `socket` to `addr`. Port `0` lets the operating system pick a free port.
+-/
+@[extern "lean_uv_tcp_bind"]
+opaque bind (socket : @& Socket) (addr : @& SocketAddress) : IO Unit
+
+/--
+Start listening for incoming connections on `socket`, queueing up to `backlog` of them.
+-/
+@[extern "lean_uv_tcp_listen"]
+opaque listen (socket : @& Socket) (backlog : UInt32) : IO Unit
+
+/--
+Accept an incoming connection on the listening `socket`.
+-/
+@[extern "lean_uv_tcp_accept"]
+opaque accept (socket : @& Socket) : IO (IO.Promise (Except IO.Error Socket))
+
+/--
+Shut down the writing side of `socket` once all pending writes are done.
+-/
+@[extern "lean_uv_tcp_shutdown"]
+opaque shutdown (socket : @& Socket) : IO (IO.Promise (Except IO.Error Unit))
+
+/--
+The address of the peer `socket` is connected to.
+-/
+@[extern "lean_uv_tcp_getpeername"]
+opaque getPeerName (socket : @& Socket) : IO SocketAddress
+
+/--
+The address `socket` is bound to.
+-/
+@[extern "lean_uv_tcp_getsockname"]
+opaque getSockName (socket : @& Socket) : IO SocketAddress
+
+/--
+Disable Nagle's algorithm on `socket`.
+-/
+@[extern "lean_uv_tcp_nodelay"]
+opaque noDelay (socket : @& Socket) : IO Unit
+
+/--
+Enable or disable TCP keep-alive on `socket`, `delay` is the initial delay in seconds.
+-/
+@[extern "lean_uv_tcp_keepalive"]
+opaque keepAlive (socket : @& Socket) (enable : Bool) (delay : UInt32) : IO Unit
+
+end Socket
+
+end TCP
+
+namespace UDP
+
+open Std.Net
+
+private opaque SocketImpl : NonemptyType.{0}
+
+/--
+A UDP socket on the event loop. At most one `recv` may be pending at a time.
+-/
+def Socket : Type := SocketImpl.type
+
+instance : Nonempty Socket := SocketImpl.property
+
+namespace Socket
+
+/--
+Create a new UDP socket.
+-/
+@[extern "lean_uv_udp_new"]
+opaque new : IO Socket
+
+/--
+Bind `socket` to `addr`. Port `0` lets the operating system pick a free port.
+-/
+@[extern "lean_uv_udp_bind"]
+opaque bind (socket : @& Socket) (addr : @& SocketAddress) : IO Unit
+
+/--
+Associate `socket` with the remote `addr`, after which `send` may be called without an address.
+-/
+@[extern "lean_uv_udp_connect"]
+opaque connect (socket : @& Socket) (addr : @& SocketAddress) : IO Unit
+
+/--
+Send the concatenation of `data` as a single datagram to `addr`, or to the connected peer if `addr`
+is `none`. The `ByteArray`s are not copied.
+-/
+@[extern "lean_uv_udp_send"]
+opaque send (socket : @& Socket) (data : Array ByteArray) (addr : @& Option SocketAddress) :
+    IO (IO.Promise (Except IO.Error Unit))
+
+/--
+Receive a single datagram of up to `size` bytes together with the address of its sender. Longer
+datagrams are truncated.
+-/
+@[extern "lean_uv_udp_recv"]
+opaque recv (socket : @& Socket) (size : UInt64) :
+    IO (IO.Promise (Except IO.Error (ByteArray × Option SocketAddress)))
+
+/--
+The address of the peer `socket` is connected to.
+-/
+@[extern "lean_uv_udp_getpeername"]
+opaque getPeerName (socket : @& Socket) : IO SocketAddress
+
+/--
+The address `socket` is bound to.
+-/
+@[extern "lean_uv_udp_getsockname"]
+opaque getSockName (socket : @& Socket) : IO SocketAddress
+
+end Socket
+
+end UDP
+
 end UV
 end Internal
 end Std
@@ -116,13 +116,22 @@ During deallocation and 64-bit machines, the fields `m_rc` and `m_cs_sz` store t
 These two fields together have 48-bits, and this is enough for modern computers.
 In 32-bit machines, the field `m_rc` is sufficient.
 
-The field `m_other` is used to store the number of fields in a constructor object and the element size in a scalar array.
+The field `m_other` is used to store the number of fields in a constructor object, the element size in a scalar array,
+and the layout of a string (see `lean_string_object`).
+
+When the runtime is built with `LEAN_BIASED_RC`, the reference counter of a multi-threaded object is split between
+a counter in `m_rc` that is only updated by the thread `m_owner` using non-atomic instructions, and the counter
+`m_shared_rc` that is updated atomically by all other threads. See `lean_mark_mt`.
 */
 typedef struct {
     int      m_rc;
     unsigned m_cs_sz:16;
     unsigned m_other:8;
     unsigned m_tag:8;
+#ifdef LEAN_BIASED_RC
+    unsigned m_owner;
+    int      m_shared_rc;
+#endif
 } lean_object;
 
 /*
@@ -178,6 +187,18 @@ typedef struct {
     uint8_t       m_data[];
 } lean_sarray_object;
 
+/* Strings are stored in one of three layouts, recorded in the `m_other` field of the header.
+   `lean_string_object` (`m_other == 0`) is the general layout. Strings whose capacity is their size and that
+   fit in a small object use the compact layout `lean_short_string_object` (`m_other == 1`) instead, which saves
+   16 bytes of header. Most strings created during elaboration, such as name components, use the compact layout.
+   Finally, `lean_string_slice_object` (`m_other == 2`) is a suffix of another string, its parent, that it
+   references instead of copying. See `lean_string_utf8_extract`.
+   Only strings in the general layout are resized or updated in place.
+
+   C code must use the accessors `lean_string_cstr`, `lean_string_size`, `lean_string_len`, ... instead of the fields:
+   reading `lean_string_object` fields of a compact string or a slice is undefined. Compacted regions, including
+   .olean files, store short strings in the compact layout, so they can only be read by a runtime that knows it;
+   the `version` field of the .olean header guards this. */
 typedef struct {
     lean_object m_header;
     size_t      m_size;     /* byte length including '\0' terminator */
@@ -186,6 +207,26 @@ typedef struct {
     char        m_data[];
 } lean_string_object;
 
+typedef struct {
+    lean_object m_header;
+    uint32_t    m_size;     /* byte length including '\0' terminator, also the capacity */
+    uint32_t    m_length;   /* UTF8 length */
+    char        m_data[];
+} lean_short_string_object;
+
+#define LEAN_MAX_SHORT_STRING_SIZE (LEAN_MAX_SMALL_OBJECT_SIZE - sizeof(lean_short_string_object))
+
+/* The first fields coincide with the ones of `lean_string_object`. Since a slice is a suffix of its parent,
+   `m_data` is '\0'-terminated by the terminator of the parent. */
+typedef struct {
+    lean_object   m_header;
+    size_t        m_size;     /* byte length including '\0' terminator */
+    size_t        m_capacity; /* equal to `m_size` */
+    size_t        m_length;   /* UTF8 length */
+    lean_object * m_parent;   /* a string that is not a slice */
+    char const *  m_data;     /* pointer into the data of `m_parent` */
+} lean_string_slice_object;
+
 typedef struct {
     lean_object   m_header;
     void *        m_fun;
@@ -485,7 +526,12 @@ static inline lean_ctor_object * lean_to_ctor(lean_object * o) { assert(lean_is_
 static inline lean_closure_object * lean_to_closure(lean_object * o) { assert(lean_is_closure(o)); return (lean_closure_object*)(o); }
 static inline lean_array_object * lean_to_array(lean_object * o) { assert(lean_is_array(o)); return (lean_array_object*)(o); }
 static inline lean_sarray_object * lean_to_sarray(lean_object * o) { assert(lean_is_sarray(o)); return (lean_sarray_object*)(o); }
-static inline lean_string_object * lean_to_string(lean_object * o) { assert(lean_is_string(o)); return (lean_string_object*)(o); }
+static inline bool lean_string_is_short(lean_object * o) { assert(lean_is_string(o)); return lean_ptr_other(o) == 1; }
+static inline bool lean_string_is_slice(lean_object * o) { assert(lean_is_string(o)); return lean_ptr_other(o) == 2; }
+/* Only for strings in the general layout, use `lean_string_cstr` to access the characters of any string. */
+static inline lean_string_object * lean_to_string(lean_object * o) { assert(lean_ptr_other(o) == 0); return (lean_string_object*)(o); }
+static inline lean_short_string_object * lean_to_short_string(lean_object * o) { assert(lean_string_is_short(o)); return (lean_short_string_object*)(o); }
+static inline lean_string_slice_object * lean_to_string_slice(lean_object * o) { assert(lean_string_is_slice(o)); return (lean_string_slice_object*)(o); }
 static inline lean_thunk_object * lean_to_thunk(lean_object * o) { assert(lean_is_thunk(o)); return (lean_thunk_object*)(o); }
 static inline lean_task_object * lean_to_task(lean_object * o) { assert(lean_is_task(o)); return (lean_task_object*)(o); }
 static inline lean_ref_object * lean_to_ref(lean_object * o) { assert(lean_is_ref(o)); return (lean_ref_object*)(o); }
@@ -514,11 +560,32 @@ static inline bool lean_is_shared(lean_object * o) {
 LEAN_EXPORT void lean_mark_mt(lean_object * o);
 LEAN_EXPORT void lean_mark_persistent(lean_object * o);
 
+/* Closed terms extracted by the compiler are stored in module-local global variables. By default, they are computed
+   eagerly by the module initializer. When the generated C code is compiled with `-DLEAN_LAZY_CLOSED_TERMS`, they are
+   instead computed by `init` on first access and published atomically to `*slot`, reducing startup time of executables
+   that only use a fraction of the closed terms of their imports. */
+LEAN_EXPORT lean_object * lean_closed_term_init(lean_object ** slot, lean_object * (*init)(void));
+
+static inline lean_object * lean_closed_term_get(lean_object ** slot, lean_object * (*init)(void)) {
+#ifdef LEAN_LAZY_CLOSED_TERMS
+    lean_object * r = *(_Atomic(lean_object *) *)slot;
+    if (LEAN_LIKELY(r != NULL)) return r;
+    return lean_closed_term_init(slot, init);
+#else
+    (void)init;
+    return *slot;
+#endif
+}
+
 static inline void lean_set_st_header(lean_object * o, unsigned tag, unsigned other) {
     o->m_rc       = 1;
     o->m_tag      = tag;
     o->m_other    = other;
     o->m_cs_sz    = 0;
+#ifdef LEAN_BIASED_RC
+    o->m_owner     = 0;
+    o->m_shared_rc = 0;
+#endif
 }
 
 /* Remark: we don't need a reference counter for objects that are not stored in the heap.
@@ -531,6 +598,10 @@ static inline void lean_set_non_heap_header(lean_object * o, size_t sz, unsigned
     o->m_tag      = tag;
     o->m_other    = other;
     o->m_cs_sz    = sz;
+#ifdef LEAN_BIASED_RC
+    o->m_owner     = 0;
+    o->m_shared_rc = 0;
+#endif
 }
 
 /* `lean_set_non_heap_header` for (potentially) big objects such as arrays and strings. */
@@ -890,6 +961,7 @@ LEAN_EXPORT lean_obj_res lean_byte_array_mk(lean_obj_arg a);
 LEAN_EXPORT lean_obj_res lean_byte_array_data(lean_obj_arg a);
 LEAN_EXPORT lean_obj_res lean_copy_byte_array(lean_obj_arg a);
 LEAN_EXPORT uint64_t lean_byte_array_hash(b_lean_obj_arg a);
+LEAN_EXPORT uint64_t lean_byte_array_fast_hash(b_lean_obj_arg a);
 
 static inline lean_obj_res lean_mk_empty_byte_array(b_lean_obj_arg capacity) {
     if (!lean_is_scalar(capacity)) lean_internal_panic_out_of_memory();
@@ -1009,9 +1081,99 @@ static inline lean_obj_res lean_float_array_set(lean_obj_arg a, b_lean_obj_arg i
     }
 }
 
+/* Typed scalar arrays: UInt32Array, UInt64Array, Int64Array and Float32Array (special cases of Array of Scalars).
+   `Int64Array` uses the `UInt64Array` primitives since `Int64` is represented as `uint64_t`. */
+
+LEAN_EXPORT lean_obj_res lean_copy_sarray(lean_obj_arg a, size_t capacity);
+LEAN_EXPORT lean_obj_res lean_sarray_copy_slice(b_lean_obj_arg src, lean_obj_arg src_off, lean_obj_arg dest, lean_obj_arg dest_off, lean_obj_arg len, bool exact);
+LEAN_EXPORT lean_obj_res lean_sarray_to_byte_array(b_lean_obj_arg a);
+LEAN_EXPORT lean_obj_res lean_sarray_of_byte_array(b_lean_obj_arg a, unsigned elem_size);
+
+/* `LEAN_SCALAR_ARRAY_API(name, T, dflt)` declares the `lean_<name>_array_*` primitives for the element type `T`.
+   `dflt` is the value returned by `get` for out of bounds indices. */
+#define LEAN_SCALAR_ARRAY_API(name, T, dflt) \
+LEAN_EXPORT lean_obj_res lean_##name##_array_mk(lean_obj_arg a); \
+LEAN_EXPORT lean_obj_res lean_##name##_array_data(lean_obj_arg a); \
+LEAN_EXPORT lean_obj_res lean_##name##_array_push(lean_obj_arg a, T v); \
+LEAN_EXPORT lean_obj_res lean_##name##_array_replicate(b_lean_obj_arg n, T v); \
+LEAN_EXPORT lean_obj_res lean_##name##_array_fill(lean_obj_arg a, b_lean_obj_arg start, b_lean_obj_arg stop, T v); \
+\
+static inline lean_obj_res lean_mk_empty_##name##_array(b_lean_obj_arg capacity) { \
+    if (!lean_is_scalar(capacity)) lean_internal_panic_out_of_memory(); \
+    return lean_alloc_sarray(sizeof(T), 0, lean_unbox(capacity)); \
+} \
+\
+static inline lean_obj_res lean_##name##_array_size(b_lean_obj_arg a) { \
+    return lean_box(lean_sarray_size(a)); \
+} \
+\
+static inline T * lean_##name##_array_cptr(b_lean_obj_arg a) { \
+    return (T*)(lean_sarray_cptr(a)); /* NOLINT */ \
+} \
+\
+static inline T lean_##name##_array_uget(b_lean_obj_arg a, size_t i) { \
+    return lean_##name##_array_cptr(a)[i]; \
+} \
+\
+static inline T lean_##name##_array_fget(b_lean_obj_arg a, b_lean_obj_arg i) { \
+    return lean_##name##_array_uget(a, lean_unbox(i)); \
+} \
+\
+static inline T lean_##name##_array_get(b_lean_obj_arg a, b_lean_obj_arg i) { \
+    if (lean_is_scalar(i)) { \
+        size_t idx = lean_unbox(i); \
+        return idx < lean_sarray_size(a) ? lean_##name##_array_uget(a, idx) : (dflt); \
+    } else { \
+        /* The index must be out of bounds. Otherwise we would be out of memory. */ \
+        return (dflt); \
+    } \
+} \
+\
+static inline lean_obj_res lean_##name##_array_uset(lean_obj_arg a, size_t i, T v) { \
+    lean_obj_res r; \
+    if (lean_is_exclusive(a)) r = a; \
+    else r = lean_copy_sarray(a, lean_sarray_capacity(a)); \
+    lean_##name##_array_cptr(r)[i] = v; \
+    return r; \
+} \
+\
+static inline lean_obj_res lean_##name##_array_fset(lean_obj_arg a, b_lean_obj_arg i, T v) { \
+    return lean_##name##_array_uset(a, lean_unbox(i), v); \
+} \
+\
+static inline lean_obj_res lean_##name##_array_set(lean_obj_arg a, b_lean_obj_arg i, T v) { \
+    if (!lean_is_scalar(i)) { \
+        return a; \
+    } else { \
+        size_t idx = lean_unbox(i); \
+        if (idx >= lean_sarray_size(a)) { \
+            return a; \
+        } else { \
+            return lean_##name##_array_uset(a, idx, v); \
+        } \
+    } \
+} \
+\
+static inline lean_obj_res lean_##name##_array_of_byte_array(b_lean_obj_arg a) { \
+    return lean_sarray_of_byte_array(a, sizeof(T)); \
+}
+
+LEAN_SCALAR_ARRAY_API(uint32, uint32_t, 0)
+LEAN_SCALAR_ARRAY_API(uint64, uint64_t, 0)
+LEAN_SCALAR_ARRAY_API(float32, float, 0.0f)
+
 /* Strings */
 
+/* Allocate a string with the compact layout if `capacity == size` and `size <= LEAN_MAX_SHORT_STRING_SIZE`.
+   The content must be written through `lean_string_cstr`. */
 static inline lean_obj_res lean_alloc_string(size_t size, size_t capacity, size_t len) {
+    if (capacity == size && size <= LEAN_MAX_SHORT_STRING_SIZE) {
+        lean_short_string_object * o = (lean_short_string_object*)lean_alloc_object(sizeof(lean_short_string_object) + size);
+        lean_set_st_header((lean_object*)o, LeanString, 1);
+        o->m_size = (uint32_t)size;
+        o->m_length = (uint32_t)len;
+        return (lean_object*)o;
+    }
     lean_string_object * o = (lean_string_object*)lean_alloc_object(sizeof(lean_string_object) + capacity);
     lean_set_st_header((lean_object*)o, LeanString, 0);
     o->m_size = size;
@@ -1021,8 +1183,29 @@ static inline lean_obj_res lean_alloc_string(size_t size, size_t capacity, size_
 }
 LEAN_EXPORT size_t lean_utf8_strlen(char const * str);
 LEAN_EXPORT size_t lean_utf8_n_strlen(char const * str, size_t n);
-static inline size_t lean_string_capacity(lean_object * o) { return lean_to_string(o)->m_capacity; }
-static inline size_t lean_string_byte_size(lean_object * o) { return sizeof(lean_string_object) + lean_string_capacity(o); }
+static inline size_t lean_string_size(b_lean_obj_arg o) {
+    if (lean_string_is_short(o)) return lean_to_short_string(o)->m_size;
+    if (LEAN_UNLIKELY(lean_string_is_slice(o))) return lean_to_string_slice(o)->m_size;
+    return lean_to_string(o)->m_size;
+}
+static inline size_t lean_string_len(b_lean_obj_arg o) {
+    if (lean_string_is_short(o)) return lean_to_short_string(o)->m_length;
+    if (LEAN_UNLIKELY(lean_string_is_slice(o))) return lean_to_string_slice(o)->m_length;
+    return lean_to_string(o)->m_length;
+}
+static inline size_t lean_string_capacity(lean_object * o) {
+    if (lean_string_is_short(o)) return lean_to_short_string(o)->m_size;
+    if (LEAN_UNLIKELY(lean_string_is_slice(o))) return lean_to_string_slice(o)->m_capacity;
+    return lean_to_string(o)->m_capacity;
+}
+static inline size_t lean_string_header_size(lean_object * o) {
+    return lean_string_is_short(o) ? sizeof(lean_short_string_object) :
+        lean_string_is_slice(o) ? sizeof(lean_string_slice_object) : sizeof(lean_string_object);
+}
+/* The data of a slice is stored in its parent. */
+static inline size_t lean_string_byte_size(lean_object * o) {
+    return lean_string_header_size(o) + (lean_string_is_slice(o) ? 0 : lean_string_capacity(o));
+}
 /* instance : inhabited char := ⟨'A'⟩ */
 static inline uint32_t lean_char_default_value() { return 'A'; }
 LEAN_EXPORT lean_obj_res lean_mk_string_unchecked(char const * s, size_t sz, size_t len);
@@ -1031,12 +1214,13 @@ LEAN_EXPORT lean_obj_res lean_mk_string_from_bytes_unchecked(char const * s, siz
 LEAN_EXPORT lean_obj_res lean_mk_ascii_string_unchecked(char const * s);
 LEAN_EXPORT lean_obj_res lean_mk_string(char const * s);
 static inline char const * lean_string_cstr(b_lean_obj_arg o) {
-    assert(lean_is_string(o));
+    if (lean_string_is_short(o)) return lean_to_short_string(o)->m_data;
+    if (LEAN_UNLIKELY(lean_string_is_slice(o))) return lean_to_string_slice(o)->m_data;
     return lean_to_string(o)->m_data;
 }
-static inline size_t lean_string_size(b_lean_obj_arg o) { return lean_to_string(o)->m_size; }
-static inline size_t lean_string_len(b_lean_obj_arg o) { return lean_to_string(o)->m_length; }
-static inline size_t lean_string_data_byte_size(lean_object * o) { return sizeof(lean_string_object) + lean_string_size(o); }
+static inline size_t lean_string_data_byte_size(lean_object * o) {
+    return lean_string_header_size(o) + (lean_string_is_slice(o) ? 0 : lean_string_size(o));
+}
 LEAN_EXPORT lean_obj_res lean_string_push(lean_obj_arg s, uint32_t c);
 LEAN_EXPORT lean_obj_res lean_string_append(lean_obj_arg s1, b_lean_obj_arg s2);
 static inline lean_obj_res lean_string_length(b_lean_obj_arg s) { return lean_box(lean_string_len(s)); }
@@ -1083,6 +1267,7 @@ LEAN_EXPORT bool lean_string_lt(b_lean_obj_arg s1, b_lean_obj_arg s2);
 static inline uint8_t lean_string_dec_eq(b_lean_obj_arg s1, b_lean_obj_arg s2) { return lean_string_eq(s1, s2); }
 static inline uint8_t lean_string_dec_lt(b_lean_obj_arg s1, b_lean_obj_arg s2) { return lean_string_lt(s1, s2); }
 LEAN_EXPORT uint64_t lean_string_hash(b_lean_obj_arg);
+LEAN_EXPORT uint64_t lean_string_fast_hash(b_lean_obj_arg);
 LEAN_EXPORT lean_obj_res lean_string_of_usize(size_t);
 
 /* Thunks */
@@ -2708,6 +2893,7 @@ LEAN_EXPORT lean_obj_res lean_st_ref_get(b_lean_obj_arg, lean_obj_arg);
 LEAN_EXPORT lean_obj_res lean_st_ref_set(b_lean_obj_arg, lean_obj_arg, lean_obj_arg);
 LEAN_EXPORT lean_obj_res lean_st_ref_reset(b_lean_obj_arg, lean_obj_arg);
 LEAN_EXPORT lean_obj_res lean_st_ref_swap(b_lean_obj_arg, lean_obj_arg, lean_obj_arg);
+LEAN_EXPORT lean_obj_res lean_st_ref_ptr_compare_exchange(b_lean_obj_arg, b_lean_obj_arg, lean_obj_arg, lean_obj_arg);
 
 /* pointer address unsafe primitive  */
 static inline size_t lean_ptr_addr(b_lean_obj_arg a) { return (size_t)a; }
@@ -121,10 +121,10 @@ instance : MixTrace Hash := ⟨mix⟩
 instance : ToString Hash := ⟨Hash.toString⟩
 
 @[inline] def ofString (str : String) :=
-  mix nil <| mk <| hash str -- same as Name.mkSimple
+  mix nil <| mk <| str.hash -- same as Name.mkSimple
 
 @[inline] def ofByteArray (bytes : ByteArray) : Hash :=
-  ⟨hash bytes⟩
+  ⟨bytes.hash⟩
 
 @[inline] def ofBool (b : Bool) :=
   mk (hash b)
@@ -4,6 +4,14 @@ Released under Apache 2.0 license as described in the file LICENSE.
 
 Author: Leonardo de Moura
 */
+#include <exception>
+#include <memory>
+#include <vector>
+#include "runtime/thread.h"
+#include "runtime/interrupt.h"
+#include "runtime/alloc.h"
+#include "runtime/io.h"
+#include "runtime/flet.h"
 #include "util/option_declarations.h"
 #include "util/io.h"
 #include "kernel/type_checker.h"
@@ -34,8 +42,26 @@ Author: Leonardo de Moura
 
 namespace lean {
 static name * g_extract_closed = nullptr;
+static name * g_compiler_parallel = nullptr;
+static name * g_compiler_parallel_threads = nullptr;
+
+/* Minimum number of declarations in a block for `compiler.parallel` to take effect. Smaller blocks do not amortize
+   the cost of starting the worker threads. */
+#define LEAN_COMPILER_PARALLEL_MIN_DECLS 4
 
 bool is_extract_closed_enabled(options const & opts) { return opts.get_bool(*g_extract_closed, true); }
+bool is_compiler_parallel_enabled(options const & opts) { return opts.get_bool(*g_compiler_parallel, false); }
+unsigned get_compiler_parallel_threads(options const & opts) {
+    unsigned n = opts.get_unsigned(*g_compiler_parallel_threads, 0);
+    return n == 0 ? hardware_concurrency() : n;
+}
+
+/* Number of threads `apply` uses to process the declarations of the block being compiled. If it is smaller than 2,
+   the declarations are processed sequentially. */
+LEAN_THREAD_VALUE(unsigned, g_parallel_threads, 0);
+
+/* Number of times a worker thread was started by `parallel_apply`. */
+static atomic<unsigned> g_parallel_workers(0);
 
 static name get_real_name(name const & n) {
     if (optional<name> new_n = is_unsafe_rec_name(n))
@@ -55,13 +81,80 @@ static expr eta_expand(elab_environment const & env, expr const & e) {
     return type_checker(env.to_kernel_env()).eta_expand(e);
 }
 
+/* Apply `f` to the values of `ds` using up to `g_parallel_threads` threads, including the current one.
+   The result preserves the order of `ds`, so later passes observe the same declarations as in sequential mode.
+   If `f` throws, the first exception is rethrown on the current thread after all workers have finished.
+
+   The worker threads run with the heartbeat count and limit and the cancellation token of the current thread, and
+   their allocation heartbeats are added to the current thread's, so `maxHeartbeats` and cancellation apply to
+   the work done on them as well. */
+template<typename F>
+comp_decls parallel_apply(F && f, comp_decls const & ds) {
+    buffer<comp_decl> in;
+    to_buffer(ds, in);
+    /* The input declarations may be shared with the environment, and are now accessed from multiple threads. */
+    for (comp_decl const & d : in)
+        mark_mt(d.raw());
+    buffer<expr> out;
+    out.resize(in.size());
+    atomic<unsigned> next(0);
+    mutex ex_mutex;
+    std::exception_ptr ex;
+    auto worker = [&]() {
+        try {
+            for (unsigned i = next++; i < in.size(); i = next++)
+                out[i] = f(in[i].snd());
+        } catch (...) {
+            lock_guard<mutex> lock(ex_mutex);
+            if (!ex) ex = std::current_exception();
+            next = in.size();
+        }
+    };
+    size_t max_heartbeat = get_max_heartbeat();
+    size_t heartbeat     = get_heartbeat();
+    object * cancel_tk   = get_cancel_tk();
+    if (cancel_tk)
+        mark_mt(cancel_tk);
+    atomic<uint64_t> worker_heartbeats(0);
+    auto thread_worker = [&]() {
+        scope_max_heartbeat s1(max_heartbeat);
+        scope_heartbeat s2(heartbeat);
+        scope_cancel_tk s3(cancel_tk);
+        g_parallel_workers++;
+        uint64_t start = get_num_heartbeats();
+        worker();
+        worker_heartbeats += get_num_heartbeats() - start;
+    };
+    unsigned num_threads = std::min(g_parallel_threads, static_cast<unsigned>(in.size()));
+    std::vector<std::unique_ptr<lthread>> threads;
+    for (unsigned i = 1; i < num_threads; i++)
+        threads.emplace_back(new lthread(thread_worker));
+    worker();
+    for (auto & t : threads)
+        t->join();
+    add_heartbeats(worker_heartbeats);
+    if (ex)
+        std::rethrow_exception(ex);
+    buffer<comp_decl> r;
+    for (unsigned i = 0; i < in.size(); i++)
+        r.push_back(comp_decl(in[i].fst(), out[i]));
+    return comp_decls(r);
+}
+
 template<typename F>
 comp_decls apply(F && f, elab_environment const & env, comp_decls const & ds) {
+    if (g_parallel_threads > 1) {
+        /* `env` is shared by the worker threads. */
+        mark_mt(env.raw());
+        return parallel_apply([&](expr const & e) { return f(env, e); }, ds);
+    }
     return map(ds, [&](comp_decl const & d) { return comp_decl(d.fst(), f(env, d.snd())); });
 }
 
 template<typename F>
 comp_decls apply(F && f, comp_decls const & ds) {
+    if (g_parallel_threads > 1)
+        return parallel_apply(f, ds);
     return map(ds, [&](comp_decl const & d) { return comp_decl(d.fst(), f(d.snd())); });
 }
 
@@ -200,6 +293,13 @@ elab_environment compile(elab_environment const & env, options const & opts, nam
 
     comp_decls ds = to_comp_decls(env, cs);
     csimp_cfg cfg(opts);
+    /* The per-declaration passes below only read the environment, so they can be run on independent threads.
+       Passes that extend the environment (e.g., `specialize`, `lambda_lifting`, `extract_closed`, and the
+       `cache_stage*` functions) still process the whole block sequentially, keeping the generated auxiliary
+       declarations and their names deterministic. We do not use threads when tracing is enabled since traces are
+       collected in thread-local state. */
+    bool parallel = is_compiler_parallel_enabled(opts) && length(ds) >= LEAN_COMPILER_PARALLEL_MIN_DECLS && !is_trace_enabled();
+    flet<unsigned> set_parallel(g_parallel_threads, parallel ? get_compiler_parallel_threads(opts) : 0);
     // Use the following line to see compiler intermediate steps
     // scope_traces_as_string trace_scope;
     auto simp  = [&](elab_environment const & env, expr const & e) { return csimp(env, e, cfg); };
@@ -273,6 +373,11 @@ elab_environment compile(elab_environment const & env, options const & opts, nam
     return compile_ir(new_env, opts, ds);
 }
 
+/* Lean.Compiler.getParallelWorkers : BaseIO Nat */
+extern "C" LEAN_EXPORT obj_res lean_compiler_get_parallel_workers(obj_arg) {
+    return io_result_mk_ok(lean_usize_to_nat(g_parallel_workers));
+}
+
 extern "C" LEAN_EXPORT object * lean_compile_decls(object * env, object * opts, object * decls) {
     return catch_kernel_exceptions<elab_environment>([&]() {
             return compile(elab_environment(env), options(opts, true), names(decls, true));
@@ -283,6 +388,12 @@ void initialize_compiler() {
     g_extract_closed = new name{"compiler", "extract_closed"};
     mark_persistent(g_extract_closed->raw());
     register_bool_option(*g_extract_closed, true, "(compiler) enable/disable closed term caching");
+    g_compiler_parallel = new name{"compiler", "parallel"};
+    mark_persistent(g_compiler_parallel->raw());
+    register_bool_option(*g_compiler_parallel, false, "(compiler) run per-declaration passes of large mutual blocks in parallel");
+    g_compiler_parallel_threads = new name{"compiler", "parallel", "threads"};
+    mark_persistent(g_compiler_parallel_threads->raw());
+    register_unsigned_option(*g_compiler_parallel_threads, 0, "(compiler) number of threads used when `compiler.parallel` is set, or 0 for the number of hardware threads");
     register_trace_class("compiler");
     register_trace_class({"compiler", "input"});
     register_trace_class({"compiler", "inline"});
@@ -324,6 +435,8 @@ void initialize_compiler() {
 }
 
 void finalize_compiler() {
+    delete g_compiler_parallel;
+    delete g_compiler_parallel_threads;
     delete g_extract_closed;
 }
 }
@@ -991,14 +991,18 @@ class specialize_fn {
         return optional<comp_decl>(new_decl);
     }
 
+    /* Return the closed term denoted by `e` (after expanding let-variables), for use in the key of the persistent
+       specialization cache. Universe levels are erased: the specialized code does not depend on them, and the
+       specialization is referenced without levels (see `mk_constant(*new_fn_name)` below). Thus, specializations
+       created in universe polymorphic declarations, or at different universe instances, can be shared, also
+       across modules. */
     optional<expr> get_closed(expr const & e) {
-        if (has_univ_param(e)) return none_expr();
         switch (e.kind()) {
         case expr_kind::MVar:  lean_unreachable();
         case expr_kind::Lit:   return some_expr(e);
         case expr_kind::BVar:  return some_expr(e);
-        case expr_kind::Sort:  return some_expr(e);
-        case expr_kind::Const: return some_expr(e);
+        case expr_kind::Sort:  return some_expr(mk_sort(mk_level_zero()));
+        case expr_kind::Const: return some_expr(mk_constant(const_name(e)));
         case expr_kind::FVar:
             if (auto v = m_lctx.get_local_decl(e).get_value()) {
                 return get_closed(*v);
@@ -1116,7 +1120,7 @@ class specialize_fn {
            This file will be deleted. So, it is not worth designing a better caching scheme.
            TODO: when we reimplement this module in Lean, we should have a better caching heuristic. */
         if (gcache_enabled && ctx.m_params.size() == 0) {
-            key = mk_app(fn, gcache_key_args);
+            key = mk_app(mk_constant(const_name(fn)), gcache_key_args);
             if (optional<name> it = get_cached_specialization(env(), key)) {
                 lean_trace(name({"compiler", "specialize"}), tout() << "get_cached_specialization [" << ctx.m_params.size() << "]: " << *it << "\n";
                            unsigned i = 0;
@@ -47,6 +47,8 @@ name const * g_float = nullptr;
 name const * g_float32 = nullptr;
 name const * g_float_array = nullptr;
 name const * g_float_array_data = nullptr;
+name const * g_float32_array = nullptr;
+name const * g_float32_array_data = nullptr;
 name const * g_false = nullptr;
 name const * g_false_rec = nullptr;
 name const * g_false_cases_on = nullptr;
@@ -62,6 +64,8 @@ name const * g_int = nullptr;
 name const * g_int_nat_abs = nullptr;
 name const * g_int_dec_lt = nullptr;
 name const * g_int_of_nat = nullptr;
+name const * g_int64_array = nullptr;
+name const * g_int64_array_data = nullptr;
 name const * g_inline = nullptr;
 name const * g_io = nullptr;
 name const * g_ite = nullptr;
@@ -109,6 +113,10 @@ name const * g_uint16 = nullptr;
 name const * g_uint32 = nullptr;
 name const * g_uint64 = nullptr;
 name const * g_usize = nullptr;
+name const * g_uint32_array = nullptr;
+name const * g_uint32_array_data = nullptr;
+name const * g_uint64_array = nullptr;
+name const * g_uint64_array_data = nullptr;
 void initialize_constants() {
     g_absurd = new name{"absurd"};
     mark_persistent(g_absurd->raw());
@@ -198,6 +206,10 @@ void initialize_constants() {
     mark_persistent(g_float_array->raw());
     g_float_array_data = new name{"FloatArray", "data"};
     mark_persistent(g_float_array_data->raw());
+    g_float32_array = new name{"Float32Array"};
+    mark_persistent(g_float32_array->raw());
+    g_float32_array_data = new name{"Float32Array", "data"};
+    mark_persistent(g_float32_array_data->raw());
     g_false = new name{"False"};
     mark_persistent(g_false->raw());
     g_false_rec = new name{"False", "rec"};
@@ -228,6 +240,10 @@ void initialize_constants() {
     mark_persistent(g_int_dec_lt->raw());
     g_int_of_nat = new name{"Int", "ofNat"};
     mark_persistent(g_int_of_nat->raw());
+    g_int64_array = new name{"Int64Array"};
+    mark_persistent(g_int64_array->raw());
+    g_int64_array_data = new name{"Int64Array", "data"};
+    mark_persistent(g_int64_array_data->raw());
     g_inline = new name{"inline"};
     mark_persistent(g_inline->raw());
     g_io = new name{"IO"};
@@ -322,6 +338,14 @@ void initialize_constants() {
     mark_persistent(g_uint64->raw());
     g_usize = new name{"USize"};
     mark_persistent(g_usize->raw());
+    g_uint32_array = new name{"UInt32Array"};
+    mark_persistent(g_uint32_array->raw());
+    g_uint32_array_data = new name{"UInt32Array", "data"};
+    mark_persistent(g_uint32_array_data->raw());
+    g_uint64_array = new name{"UInt64Array"};
+    mark_persistent(g_uint64_array->raw());
+    g_uint64_array_data = new name{"UInt64Array", "data"};
+    mark_persistent(g_uint64_array_data->raw());
 }
 void finalize_constants() {
     delete g_absurd;
@@ -368,6 +392,8 @@ void finalize_constants() {
     delete g_float32;
     delete g_float_array;
     delete g_float_array_data;
+    delete g_float32_array;
+    delete g_float32_array_data;
     delete g_false;
     delete g_false_rec;
     delete g_false_cases_on;
@@ -383,6 +409,8 @@ void finalize_constants() {
     delete g_int_nat_abs;
     delete g_int_dec_lt;
     delete g_int_of_nat;
+    delete g_int64_array;
+    delete g_int64_array_data;
     delete g_inline;
     delete g_io;
     delete g_ite;
@@ -430,6 +458,10 @@ void finalize_constants() {
     delete g_uint32;
     delete g_uint64;
     delete g_usize;
+    delete g_uint32_array;
+    delete g_uint32_array_data;
+    delete g_uint64_array;
+    delete g_uint64_array_data;
 }
 name const & get_absurd_name() { return *g_absurd; }
 name const & get_and_name() { return *g_and; }
@@ -475,6 +507,8 @@ name const & get_float_name() { return *g_float; }
 name const & get_float32_name() { return *g_float32; }
 name const & get_float_array_name() { return *g_float_array; }
 name const & get_float_array_data_name() { return *g_float_array_data; }
+name const & get_float32_array_name() { return *g_float32_array; }
+name const & get_float32_array_data_name() { return *g_float32_array_data; }
 name const & get_false_name() { return *g_false; }
 name const & get_false_rec_name() { return *g_false_rec; }
 name const & get_false_cases_on_name() { return *g_false_cases_on; }
@@ -490,6 +524,8 @@ name const & get_int_name() { return *g_int; }
 name const & get_int_nat_abs_name() { return *g_int_nat_abs; }
 name const & get_int_dec_lt_name() { return *g_int_dec_lt; }
 name const & get_int_of_nat_name() { return *g_int_of_nat; }
+name const & get_int64_array_name() { return *g_int64_array; }
+name const & get_int64_array_data_name() { return *g_int64_array_data; }
 name const & get_inline_name() { return *g_inline; }
 name const & get_io_name() { return *g_io; }
 name const & get_ite_name() { return *g_ite; }
@@ -537,4 +573,8 @@ name const & get_uint16_name() { return *g_uint16; }
 name const & get_uint32_name() { return *g_uint32; }
 name const & get_uint64_name() { return *g_uint64; }
 name const & get_usize_name() { return *g_usize; }
+name const & get_uint32_array_name() { return *g_uint32_array; }
+name const & get_uint32_array_data_name() { return *g_uint32_array_data; }
+name const & get_uint64_array_name() { return *g_uint64_array; }
+name const & get_uint64_array_data_name() { return *g_uint64_array_data; }
 }
@@ -49,6 +49,8 @@ name const & get_float_name();
 name const & get_float32_name();
 name const & get_float_array_name();
 name const & get_float_array_data_name();
+name const & get_float32_array_name();
+name const & get_float32_array_data_name();
 name const & get_false_name();
 name const & get_false_rec_name();
 name const & get_false_cases_on_name();
@@ -64,6 +66,8 @@ name const & get_int_name();
 name const & get_int_nat_abs_name();
 name const & get_int_dec_lt_name();
 name const & get_int_of_nat_name();
+name const & get_int64_array_name();
+name const & get_int64_array_data_name();
 name const & get_inline_name();
 name const & get_io_name();
 name const & get_ite_name();
@@ -111,4 +115,8 @@ name const & get_uint16_name();
 name const & get_uint32_name();
 name const & get_uint64_name();
 name const & get_usize_name();
+name const & get_uint32_array_name();
+name const & get_uint32_array_data_name();
+name const & get_uint64_array_name();
+name const & get_uint64_array_data_name();
 }
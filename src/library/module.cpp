@@ -49,8 +49,12 @@ namespace lean {
 struct olean_header {
     // 5 bytes: magic number
     char marker[5] = {'o', 'l', 'e', 'a', 'n'};
-    // 1 byte: version, incremented on structural changes to header
-    uint8_t version = 2;
+    // 1 byte: version, incremented on structural changes to header or to the layout of compacted objects
+    // * 3: strings of at most `LEAN_MAX_SHORT_STRING_SIZE` bytes use `lean_short_string_object`
+    uint8_t version = 3;
+    // Oldest version that can still be read. Version 2 files only contain strings in the general layout, which is
+    // still valid, so .olean files written by stage0 can be loaded until it is updated.
+    static constexpr uint8_t min_version = 2;
     // 1 byte of flags:
     // * bit 0: whether persisted bignums use GMP or Lean-native encoding
     // * bit 1-7: reserved
@@ -94,7 +98,8 @@ extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg
 
         // Let's start with a hash of the module name. Note that while our string hash is a dubious 32-bit
         // algorithm, the mixing of multiple `Name` parts seems to result in a nicely distributed 64-bit
-        // output
+        // output. `Name.hash` is based on the stable `String.hash` (see `hash_str`), so the base address
+        // of a module does not change between Lean versions.
         size_t base_addr = name(mod, true).hash();
         // x86-64 user space is currently limited to the lower 47 bits
         // https://en.wikipedia.org/wiki/X86-64#Virtual_address_space_details
@@ -160,7 +165,8 @@ extern "C" LEAN_EXPORT object * lean_read_module_data(object * fname, object *)
             || memcmp(header.marker, default_header.marker, sizeof(header.marker)) != 0) {
             return io_result_mk_error((sstream() << "failed to read file '" << olean_fn << "', invalid header").str());
         }
-        if (header.version != default_header.version || header.flags != default_header.flags
+        if (header.version < olean_header::min_version || header.version > default_header.version
+            || header.flags != default_header.flags
 #ifdef LEAN_CHECK_OLEAN_VERSION
             || strncmp(header.githash, LEAN_GITHASH, sizeof(header.githash)) != 0
 #endif
@@ -9,6 +9,7 @@ Author: Leonardo de Moura
 #include "runtime/thread.h"
 #include "runtime/debug.h"
 #include "runtime/alloc.h"
+#include "runtime/allocprof.h"
 
 #ifdef LEAN_RUNTIME_STATS
 #define LEAN_RUNTIME_STAT_CODE(c) c
@@ -71,6 +72,7 @@ struct page_header {
     unsigned         m_num_free;
     unsigned         m_slot_idx;
     bool             m_in_page_free_list;
+    atomic<unsigned> m_num_sampled; /* Number of live objects in this page sampled by the allocation profiler. */
 };
 
 struct page {
@@ -125,6 +127,7 @@ struct heap {
        by other heaps. */
     void *    m_to_import_list{nullptr};
     uint64_t  m_heartbeat{0}; /* Counter for implementing "deterministic timeouts". It is currently the number of small allocations */
+    int64_t   m_sample_countdown{0}; /* Number of bytes to be allocated before the next allocation profiler sample. */
     void import_objs();
     void export_objs();
     void alloc_segment();
@@ -318,6 +321,7 @@ static page * alloc_page(heap * h, unsigned obj_size) {
     p->m_header.m_max_free   = num_free;
     p->m_header.m_num_free   = num_free;
     p->m_header.m_in_page_free_list = false;
+    p->m_header.m_num_sampled = 0;
     return p;
 }
 
@@ -350,6 +354,7 @@ static void init_heap(bool main) {
             obj_size += LEAN_OBJECT_SIZE_DELTA;
         }
     }
+    g_heap->m_sample_countdown = allocprof_next_sample();
     if (!main)
         register_thread_finalizer(finalize_heap, g_heap);
 }
@@ -381,9 +386,8 @@ void * lean_alloc_small_cold(unsigned sz, unsigned slot_idx, page * p) {
     return r;
 }
 
-extern "C" LEAN_EXPORT void * lean_alloc_small(unsigned sz, unsigned slot_idx) {
+static inline void * alloc_small_core(unsigned sz, unsigned slot_idx) {
     page * p = g_heap->m_curr_page[slot_idx];
-    g_heap->m_heartbeat++;
     void * r = p->m_header.m_free_list;
     if (LEAN_UNLIKELY(r == nullptr)) {
         return lean_alloc_small_cold(sz, slot_idx, p);
@@ -394,12 +398,53 @@ extern "C" LEAN_EXPORT void * lean_alloc_small(unsigned sz, unsigned slot_idx) {
     return r;
 }
 
+LEAN_NOINLINE
+static void * lean_alloc_small_sampled(unsigned sz, unsigned slot_idx) {
+    g_heap->m_sample_countdown = allocprof_next_sample();
+    void * r = alloc_small_core(sz, slot_idx);
+    /* skip `lean_alloc_small_sampled` and `lean_alloc_small` */
+    if (allocprof_sample(r, sz, 2))
+        get_page_of(r)->m_header.m_num_sampled++;
+    return r;
+}
+
+extern "C" LEAN_EXPORT void * lean_alloc_small(unsigned sz, unsigned slot_idx) {
+    g_heap->m_heartbeat++;
+    g_heap->m_sample_countdown -= sz;
+    if (LEAN_UNLIKELY(g_heap->m_sample_countdown < 0)) {
+        return lean_alloc_small_sampled(sz, slot_idx);
+    }
+    return alloc_small_core(sz, slot_idx);
+}
+
+/* Number of live big objects sampled by the allocation profiler. */
+static atomic<unsigned> g_num_sampled_big(0);
+
+LEAN_NOINLINE
+static void alloc_big_sampled(void * r, size_t sz) {
+    g_heap->m_sample_countdown = allocprof_next_sample();
+    /* skip `alloc_big_sampled` and `alloc` */
+    if (allocprof_sample(r, sz, 2))
+        g_num_sampled_big++;
+}
+
+LEAN_NOINLINE
+static void dealloc_sampled(void * o, atomic<unsigned> & num_sampled) {
+    if (allocprof_forget(o))
+        num_sampled--;
+}
+
 void * alloc(size_t sz) {
     sz = lean_align(sz, LEAN_OBJECT_SIZE_DELTA);
     LEAN_RUNTIME_STAT_CODE(g_num_alloc++);
     if (LEAN_UNLIKELY(sz > LEAN_MAX_SMALL_OBJECT_SIZE)) {
         void * r = malloc(sz);
         if (r == nullptr) lean_internal_panic_out_of_memory();
+        if (g_heap) {
+            g_heap->m_sample_countdown -= sz;
+            if (LEAN_UNLIKELY(g_heap->m_sample_countdown < 0))
+                alloc_big_sampled(r, sz);
+        }
         return r;
     }
     lean_assert(g_heap);
@@ -426,6 +471,9 @@ static inline void dealloc_small_core(void * o) {
     }
     lean_assert(g_heap);
     page * p = get_page_of(o);
+    if (LEAN_UNLIKELY(atomic_load_explicit(&p->m_header.m_num_sampled, memory_order_relaxed) != 0)) {
+        dealloc_sampled(o, p->m_header.m_num_sampled);
+    }
     if (LEAN_LIKELY(p->get_heap() == g_heap)) {
         p->push_free_obj(o);
     } else {
@@ -437,6 +485,9 @@ void dealloc(void * o, size_t sz) {
     LEAN_RUNTIME_STAT_CODE(g_num_dealloc++);
     sz = lean_align(sz, LEAN_OBJECT_SIZE_DELTA);
     if (LEAN_UNLIKELY(sz > LEAN_MAX_SMALL_OBJECT_SIZE)) {
+        if (LEAN_UNLIKELY(atomic_load_explicit(&g_num_sampled_big, memory_order_relaxed) != 0)) {
+            dealloc_sampled(o, g_num_sampled_big);
+        }
         return free(o);
     }
     dealloc_small_core(o);
@@ -446,6 +497,13 @@ extern "C" LEAN_EXPORT void lean_free_small(void * o) {
     dealloc_small_core(o);
 }
 
+void flush_dealloc_exports() {
+    if (g_heap && g_heap->m_to_export_list) {
+        LEAN_RUNTIME_STAT_CODE(g_num_exports++);
+        g_heap->export_objs();
+    }
+}
+
 extern "C" LEAN_EXPORT unsigned lean_small_mem_size(void * o) {
     page * p = get_page_of(o);
     return p->m_header.m_obj_size;
@@ -455,6 +513,7 @@ extern "C" LEAN_EXPORT unsigned lean_small_mem_size(void * o) {
 
 void initialize_alloc() {
 #ifdef LEAN_SMALL_ALLOCATOR
+    initialize_allocprof();
     g_heap_manager = new heap_manager();
     init_heap(true);
 #endif
@@ -463,6 +522,11 @@ void initialize_alloc() {
 void finalize_alloc() {
 }
 
+#ifndef LEAN_SMALL_ALLOCATOR
+void flush_dealloc_exports() {
+}
+#endif
+
 #ifndef LEAN_SMALL_ALLOCATOR
 LEAN_THREAD_VALUE(uint64_t, g_heartbeat, 0);
 #endif
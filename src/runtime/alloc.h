@@ -13,6 +13,8 @@ namespace lean {
 void init_thread_heap();
 LEAN_EXPORT void * alloc(size_t sz);
 LEAN_EXPORT void dealloc(void * o, size_t sz);
+/* Send the objects of other heaps deallocated by this thread back to their heaps now. */
+void flush_dealloc_exports();
 LEAN_EXPORT void add_heartbeats(uint64_t count);
 LEAN_EXPORT uint64_t get_num_heartbeats();
 void initialize_alloc();
@@ -4,8 +4,218 @@ Released under Apache 2.0 license as described in the file LICENSE.
 
 Author: Leonardo de Moura
 */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 #include "runtime/allocprof.h"
+#include "runtime/thread.h"
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define LEAN_ALLOCPROF_BACKTRACE
+#endif
+
+#define LEAN_ALLOCPROF_DEFAULT_RATE (512*1024)
+#define LEAN_ALLOCPROF_MAX_FRAMES   64
+
 namespace lean {
+typedef std::chrono::steady_clock::time_point allocprof_time;
+
+struct allocprof_site {
+    uint64 m_num_alloc{0};
+    uint64 m_alloc_bytes{0};
+    uint64 m_num_live{0};
+    uint64 m_live_bytes{0};
+};
+
+struct allocprof_sample_info {
+    allocprof_site *            m_site;
+    size_t                      m_size;
+    allocprof_time              m_time;
+};
+
+struct allocprof_tag_info {
+    uint64 m_num_freed{0};
+    uint64 m_lifetime_ns{0};
+};
+
+struct allocprof_frames_hash {
+    size_t operator()(std::vector<void *> const & frames) const {
+        size_t h = 31;
+        for (void * f : frames)
+            h = h * 1000003 ^ reinterpret_cast<size_t>(f);
+        return h;
+    }
+};
+
+struct allocprof_state {
+    mutex  m_mutex;
+    uint64 m_rate;
+    std::string m_fname;
+    atomic<uint64> m_rng;
+    std::unordered_map<std::vector<void *>, allocprof_site, allocprof_frames_hash> m_sites;
+    std::unordered_map<void *, allocprof_sample_info> m_live;
+    allocprof_tag_info m_tags[256];
+};
+
+/* We never delete the profiler state since objects may still be released after `main` returns. */
+static allocprof_state * g_allocprof = nullptr;
+
+int64 allocprof_next_sample() {
+    if (!g_allocprof)
+        return std::numeric_limits<int64>::max();
+    /* Sample intervals are exponentially distributed, i.e., every allocated byte
+       has the same probability of being sampled. */
+    uint64 z = atomic_fetch_add_explicit(&g_allocprof->m_rng, static_cast<uint64>(0x9e3779b97f4a7c15ull), memory_order_relaxed);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z = z ^ (z >> 31);
+    double u = (static_cast<double>(z >> 11) + 1.0) / 9007199254740992.0; /* u in (0, 1] */
+    return static_cast<int64>(-std::log(u) * static_cast<double>(g_allocprof->m_rate)) + 1;
+}
+
+bool allocprof_sample(void * o, size_t sz, unsigned skip) {
+    if (!g_allocprof)
+        return false;
+    std::vector<void *> frames;
+#ifdef LEAN_ALLOCPROF_BACKTRACE
+    void * buf[LEAN_ALLOCPROF_MAX_FRAMES];
+    int n = backtrace(buf, LEAN_ALLOCPROF_MAX_FRAMES);
+    /* also skip `allocprof_sample` itself */
+    for (int i = skip + 1; i < n; i++)
+        frames.push_back(buf[i]);
+#else
+    (void)skip;
+#endif
+    allocprof_time now = std::chrono::steady_clock::now();
+    lock_guard<mutex> lock(g_allocprof->m_mutex);
+    auto it = g_allocprof->m_sites.emplace(std::move(frames), allocprof_site()).first;
+    allocprof_site & site = it->second;
+    site.m_num_alloc++;
+    site.m_alloc_bytes += sz;
+    site.m_num_live++;
+    site.m_live_bytes  += sz;
+    g_allocprof->m_live[o] = allocprof_sample_info{&site, sz, now};
+    return true;
+}
+
+bool allocprof_forget(void * o) {
+    if (!g_allocprof)
+        return false;
+    /* The object header is still intact. */
+    uint8 tag = lean_ptr_tag(static_cast<object *>(o));
+    allocprof_time now = std::chrono::steady_clock::now();
+    lock_guard<mutex> lock(g_allocprof->m_mutex);
+    auto it = g_allocprof->m_live.find(o);
+    if (it == g_allocprof->m_live.end())
+        return false;
+    allocprof_sample_info const & info = it->second;
+    info.m_site->m_num_live--;
+    info.m_site->m_live_bytes -= info.m_size;
+    allocprof_tag_info & t = g_allocprof->m_tags[tag];
+    t.m_num_freed++;
+    t.m_lifetime_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(now - info.m_time).count();
+    g_allocprof->m_live.erase(it);
+    return true;
+}
+
+static char const * allocprof_kind(unsigned tag) {
+    if (tag <= LeanMaxCtorTag) return "constructor";
+    switch (tag) {
+    case LeanClosure:     return "closure";
+    case LeanArray:       return "array";
+    case LeanScalarArray: return "scalar array";
+    case LeanString:      return "string";
+    case LeanMPZ:         return "mpz";
+    case LeanThunk:       return "thunk";
+    case LeanTask:        return "task";
+    case LeanRef:         return "ref";
+    case LeanExternal:    return "external";
+    default:              return "other";
+    }
+}
+
+extern "C" LEAN_EXPORT bool lean_allocprof_dump(char const * fname) {
+    if (!g_allocprof)
+        return false;
+    FILE * out = fopen(fname, "w");
+    if (!out)
+        return false;
+    lock_guard<mutex> lock(g_allocprof->m_mutex);
+    uint64 num_live = 0, live_bytes = 0, num_alloc = 0, alloc_bytes = 0;
+    for (auto const & p : g_allocprof->m_sites) {
+        num_live    += p.second.m_num_live;
+        live_bytes  += p.second.m_live_bytes;
+        num_alloc   += p.second.m_num_alloc;
+        alloc_bytes += p.second.m_alloc_bytes;
+    }
+    fprintf(out, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%llu\n",
+            (unsigned long long)num_live, (unsigned long long)live_bytes,
+            (unsigned long long)num_alloc, (unsigned long long)alloc_bytes,
+            (unsigned long long)g_allocprof->m_rate);
+    for (auto const & p : g_allocprof->m_sites) {
+        allocprof_site const & s = p.second;
+        fprintf(out, "%llu: %llu [%llu: %llu] @",
+                (unsigned long long)s.m_num_live, (unsigned long long)s.m_live_bytes,
+                (unsigned long long)s.m_num_alloc, (unsigned long long)s.m_alloc_bytes);
+        for (void * f : p.first)
+            fprintf(out, " %p", f);
+        fprintf(out, "\n");
+    }
+    /* Object tags and lifetimes are not part of the pprof format, we store them as comments. */
+    uint64 num_live_tags[256] = {0};
+    for (auto const & p : g_allocprof->m_live)
+        num_live_tags[lean_ptr_tag(static_cast<object *>(p.first))]++;
+    fprintf(out, "# tag kind freed mean_lifetime_us live\n");
+    for (unsigned tag = 0; tag < 256; tag++) {
+        allocprof_tag_info const & t = g_allocprof->m_tags[tag];
+        if (t.m_num_freed == 0 && num_live_tags[tag] == 0)
+            continue;
+        double mean_us = t.m_num_freed == 0 ? 0.0 : static_cast<double>(t.m_lifetime_ns) / t.m_num_freed / 1000.0;
+        fprintf(out, "# %u %s %llu %.3f %llu\n", tag, allocprof_kind(tag),
+                (unsigned long long)t.m_num_freed, mean_us, (unsigned long long)num_live_tags[tag]);
+    }
+#ifdef __linux__
+    fprintf(out, "\nMAPPED_LIBRARIES:\n");
+    if (FILE * maps = fopen("/proc/self/maps", "r")) {
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), maps)) > 0)
+            fwrite(buf, 1, n, out);
+        fclose(maps);
+    }
+#endif
+    fclose(out);
+    return true;
+}
+
+static void allocprof_dump_at_exit() {
+    lean_allocprof_dump(g_allocprof->m_fname.c_str());
+}
+
+void initialize_allocprof() {
+#ifndef LEAN_EMSCRIPTEN
+    char const * fname = std::getenv("LEAN_ALLOCPROF");
+    if (!fname || *fname == 0)
+        return;
+    uint64 rate = LEAN_ALLOCPROF_DEFAULT_RATE;
+    if (char const * r = std::getenv("LEAN_ALLOCPROF_RATE")) {
+        uint64 v = std::strtoull(r, nullptr, 10);
+        if (v > 0) rate = v;
+    }
+    g_allocprof = new allocprof_state();
+    g_allocprof->m_rate  = rate;
+    g_allocprof->m_fname = fname;
+    g_allocprof->m_rng   = static_cast<uint64>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::atexit(allocprof_dump_at_exit);
+#endif
+}
+
 allocprof::allocprof(std::ostream & out, char const * msg):
     m_out(out), m_msg(msg) {
 #ifdef LEAN_RUNTIME_STATS
@@ -8,6 +8,28 @@ Author: Leonardo de Moura
 #include <string>
 #include "runtime/object.h"
 namespace lean {
+/* Sampling allocation-site profiler.
+
+   It is available in regular builds (with `LEAN_SMALL_ALLOCATOR`), and it is enabled by setting
+   the environment variable `LEAN_ALLOCPROF=<file>`. Then, on average one sample is taken every
+   `LEAN_ALLOCPROF_RATE` bytes allocated (default: 512Kb). For each sample we record the C stack
+   of the allocation site, and when the object is released we record its tag and lifetime.
+   At exit, the profile is written to `<file>` using the legacy `pprof` heap profile format
+   (`heap_v2`), and can be inspected using `pprof <binary> <file>`.
+
+   The allocator is responsible for calling `allocprof_sample` whenever the countdown returned
+   by `allocprof_next_sample` is exhausted, and `allocprof_forget` when a sampled object is released. */
+void initialize_allocprof();
+/* Return the number of bytes to be allocated before the next sample is taken. */
+int64 allocprof_next_sample();
+/* Record an allocation site for `o`. Return false if the profiler is disabled.
+   `skip` is the number of innermost stack frames that belong to the allocator. */
+bool allocprof_sample(void * o, size_t sz, unsigned skip);
+/* Return true if `o` was a sampled object. */
+bool allocprof_forget(void * o);
+/* Write the current profile to `fname`. Return false if the profiler is disabled or the file cannot be created. */
+extern "C" LEAN_EXPORT bool lean_allocprof_dump(char const * fname);
+
 /* Low tech runtime allocation profiler.
    We need to compile Lean using RUNTIME_STATS=ON to use it. */
 class allocprof {
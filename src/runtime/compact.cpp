@@ -35,7 +35,7 @@ struct max_sharing_hash {
     object_compactor * m;
     max_sharing_hash(object_compactor * manager):m(manager) {}
     unsigned operator()(max_sharing_key const & k) const {
-        return hash_str(k.m_size, reinterpret_cast<unsigned char const *>(m->m_begin) + k.m_offset, 17);
+        return hash_bytes(k.m_size, reinterpret_cast<unsigned char const *>(m->m_begin) + k.m_offset, 17);
     }
 };
 
@@ -154,13 +154,23 @@ void object_compactor::insert_sarray(object * o) {
 void object_compactor::insert_string(object * o) {
     size_t sz        = lean_string_size(o);
     size_t len       = lean_string_len(o);
+    if (sz <= LEAN_MAX_SHORT_STRING_SIZE) {
+        size_t obj_sz = sizeof(lean_short_string_object) + sz;
+        lean_short_string_object * new_o = (lean_short_string_object*)alloc(obj_sz);
+        lean_set_non_heap_header_for_big((lean_object*)new_o, LeanString, 1);
+        new_o->m_size     = sz;
+        new_o->m_length   = len;
+        memcpy(new_o->m_data, lean_string_cstr(o), sz);
+        save_max_sharing(o, (lean_object*)new_o, obj_sz);
+        return;
+    }
     size_t obj_sz = sizeof(lean_string_object) + sz;
     lean_string_object * new_o = (lean_string_object*)alloc(obj_sz);
     lean_set_non_heap_header_for_big((lean_object*)new_o, LeanString, 0);
     new_o->m_size     = sz;
     new_o->m_capacity = sz;
     new_o->m_length   = len;
-    memcpy(new_o->m_data, lean_to_string(o)->m_data, sz);
+    memcpy(new_o->m_data, lean_string_cstr(o), sz);
     save_max_sharing(o, (lean_object*)new_o, obj_sz);
 }
 
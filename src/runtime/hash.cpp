@@ -4,8 +4,17 @@ Released under Apache 2.0 license as described in the file LICENSE.
 
 Author: Leonardo de Moura
 */
+#include <cstring>
 #include "runtime/hash.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAN_HASH_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LEAN_HASH_NEON
+#endif
+
 namespace lean {
 
 //-----------------------------------------------------------------------------
@@ -55,4 +64,176 @@ uint64 hash_str(size_t len, unsigned char const * str, uint64 init_value) {
     return MurmurHash64A(str, len, init_value);
 }
 
+//-----------------------------------------------------------------------------
+// `hash_bytes`: a wyhash-style hash for short inputs, and an XXH3-style hash with 8 independent
+// 64-bit accumulators for long inputs. The accumulator loop uses SSE2 on x86-64 and NEON on AArch64,
+// which are part of the base instruction sets, and a scalar fallback with the same results elsewhere.
+
+static const uint64 g_secret[24] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull,
+    0x1d8e4e27c47d124full, 0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull,
+    0x1f67b3b7a4a44072ull, 0x78e5c0cc4ee679cbull, 0xc4f1f2ddc3b7a4a4ull, 0x2172ffcc7dd05a82ull,
+    0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull, 0xcb00c391bb52283cull, 0xa32e531b8b65d088ull,
+    0x4ef90da297486471ull, 0xd8acdea946ef1938ull, 0x3f349ce33f76faa8ull, 0x1d4f0bc7c7bbdcf9ull,
+    0x3159b4cd4be0518aull, 0x647378d9c97e9fc8ull, 0xc3ebd33483acc5eaull, 0xeb6313faffa081c5ull
+};
+static const uint64 g_prime32_1 = 0x9e3779b1ull;
+static const unsigned g_stripe_size  = 64;
+static const unsigned g_block_stripes = 16;
+static const size_t   g_long_threshold = 256;
+
+static inline uint64 read64(unsigned char const * p) { uint64 r; memcpy(&r, p, sizeof(r)); return r; }
+static inline uint64 read32(unsigned char const * p) { uint32 r; memcpy(&r, p, sizeof(r)); return r; }
+
+/* Fold the 128-bit product of `a` and `b`. */
+static inline uint64 mum(uint64 a, uint64 b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64>(r) ^ static_cast<uint64>(r >> 64);
+#else
+    uint64 ha = a >> 32, hb = b >> 32, la = static_cast<uint32>(a), lb = static_cast<uint32>(b);
+    uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64 c = t < rl;
+    uint64 lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+static inline uint64 avalanche(uint64 h) {
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+static uint64 hash_short(unsigned char const * p, size_t len, uint64 seed) {
+    seed ^= g_secret[0];
+    uint64 a, b;
+    if (len <= 16) {
+        if (len >= 8) {
+            a = read64(p);
+            b = read64(p + len - 8);
+        } else if (len >= 4) {
+            a = read32(p);
+            b = read32(p + len - 4);
+        } else if (len > 0) {
+            a = (static_cast<uint64>(p[0]) << 16) | (static_cast<uint64>(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64 see1 = seed, see2 = seed;
+            do {
+                seed = mum(read64(p) ^ g_secret[1], read64(p + 8) ^ seed);
+                see1 = mum(read64(p + 16) ^ g_secret[2], read64(p + 24) ^ see1);
+                see2 = mum(read64(p + 32) ^ g_secret[3], read64(p + 40) ^ see2);
+                p += 48; i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mum(read64(p) ^ g_secret[1], read64(p + 8) ^ seed);
+            p += 16; i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    return mum(g_secret[1] ^ len, mum(a ^ g_secret[1], b ^ seed));
+}
+
+/* acc[i] += lo32(d[i] ^ key[i]) * hi32(d[i] ^ key[i]); acc[i ^ 1] += d[i] */
+static inline void accumulate_stripe(uint64 * acc, unsigned char const * p, uint64 const * key) {
+#if defined(LEAN_HASH_SSE2)
+    __m128i * xacc = reinterpret_cast<__m128i *>(acc);
+    for (unsigned i = 0; i < 4; i++) {
+        __m128i d    = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p) + i);
+        __m128i k    = _mm_loadu_si128(reinterpret_cast<__m128i const *>(key) + i);
+        __m128i dk   = _mm_xor_si128(d, k);
+        __m128i prod = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i sum  = _mm_add_epi64(xacc[i], _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+        xacc[i] = _mm_add_epi64(prod, sum);
+    }
+#elif defined(LEAN_HASH_NEON)
+    for (unsigned i = 0; i < 4; i++) {
+        uint64x2_t d  = vreinterpretq_u64_u8(vld1q_u8(p + 16 * i));
+        uint64x2_t dk = veorq_u64(d, vld1q_u64(key + 2 * i));
+        uint64x2_t a  = vaddq_u64(vld1q_u64(acc + 2 * i), vextq_u64(d, d, 1));
+        vst1q_u64(acc + 2 * i, vmlal_u32(a, vmovn_u64(dk), vshrn_n_u64(dk, 32)));
+    }
+#else
+    for (unsigned i = 0; i < 8; i++) {
+        uint64 d  = read64(p + 8 * i);
+        uint64 dk = d ^ key[i];
+        acc[i ^ 1] += d;
+        acc[i] += (dk & 0xffffffffull) * (dk >> 32);
+    }
+#endif
+}
+
+/* acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ key[i]) * g_prime32_1 */
+static inline void scramble(uint64 * acc, uint64 const * key) {
+#if defined(LEAN_HASH_SSE2)
+    __m128i * xacc  = reinterpret_cast<__m128i *>(acc);
+    __m128i   prime = _mm_set1_epi32(static_cast<int>(g_prime32_1));
+    for (unsigned i = 0; i < 4; i++) {
+        __m128i a  = xacc[i];
+        a = _mm_xor_si128(_mm_xor_si128(a, _mm_srli_epi64(a, 47)),
+                          _mm_loadu_si128(reinterpret_cast<__m128i const *>(key) + i));
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        xacc[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    }
+#elif defined(LEAN_HASH_NEON)
+    uint32x2_t prime = vdup_n_u32(static_cast<uint32>(g_prime32_1));
+    for (unsigned i = 0; i < 4; i++) {
+        uint64x2_t a = vld1q_u64(acc + 2 * i);
+        a = veorq_u64(veorq_u64(a, vshrq_n_u64(a, 47)), vld1q_u64(key + 2 * i));
+        uint64x2_t hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+        vst1q_u64(acc + 2 * i, vmlal_u32(hi, vmovn_u64(a), prime));
+    }
+#else
+    for (unsigned i = 0; i < 8; i++) {
+        uint64 a = acc[i];
+        acc[i] = ((a ^ (a >> 47)) ^ key[i]) * g_prime32_1;
+    }
+#endif
+}
+
+static uint64 hash_long(unsigned char const * p, size_t len, uint64 seed) {
+    uint64 key[24];
+    for (unsigned i = 0; i < 24; i++)
+        key[i] = g_secret[i] + ((i & 1) ? -seed : seed);
+    alignas(16) uint64 acc[8] = {
+        0xc2b2ae3dull, 0x9e3779b185ebca87ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull,
+        0x85ebca77c2b2ae63ull, 0x85ebca77ull, 0x27d4eb2f165667c5ull, 0x9e3779b1ull
+    };
+    size_t num_stripes = (len - 1) / g_stripe_size;
+    size_t s = 0;
+    for (; s + g_block_stripes <= num_stripes; s += g_block_stripes) {
+        for (unsigned j = 0; j < g_block_stripes; j++)
+            accumulate_stripe(acc, p + (s + j) * g_stripe_size, key + j);
+        scramble(acc, key + 16);
+    }
+    for (unsigned j = 0; s + j < num_stripes; j++)
+        accumulate_stripe(acc, p + (s + j) * g_stripe_size, key + j);
+    // The last stripe may overlap with the previous one.
+    accumulate_stripe(acc, p + len - g_stripe_size, key + 15);
+    uint64 h = len * 0x9e3779b185ebca87ull ^ seed;
+    for (unsigned i = 0; i < 4; i++)
+        h += mum(acc[2 * i] ^ key[2 * i + 1], acc[2 * i + 1] ^ key[2 * i + 2]);
+    return avalanche(h);
+}
+
+uint64 hash_bytes(size_t len, unsigned char const * data, uint64 seed) {
+    if (len <= g_long_threshold)
+        return hash_short(data, len, seed);
+    else
+        return hash_long(data, len, seed);
+}
+
 }
@@ -10,8 +10,14 @@ Author: Leonardo de Moura
 
 namespace lean {
 
+/* MurmurHash64A. Its values are persisted, e.g., through `String.hash` in the `Name` hashes stored in .olean
+   files, so it must never change. Use `hash_bytes` for hash tables that only live in memory. */
 uint64 hash_str(size_t len, unsigned char const * str, uint64 init_value);
 
+/* Fast hash function for byte sequences, processing long inputs with SIMD instructions where available.
+   Its values may change between Lean versions and must not be persisted. */
+uint64 hash_bytes(size_t len, unsigned char const * data, uint64 seed);
+
 inline uint64 hash(uint64 h, uint64 k) {
     uint64 m = 0xc6a4a7935bd1e995;
     uint64 r = 47;
@@ -12,6 +12,7 @@ Author: Leonardo de Moura
 #include "runtime/stack_overflow.h"
 #include "runtime/process.h"
 #include "runtime/mutex.h"
+#include "runtime/sharecommon.h"
 #include "runtime/init_module.h"
 #include "runtime/libuv.h"
 
@@ -23,6 +24,7 @@ extern "C" LEAN_EXPORT void lean_initialize_runtime_module() {
     initialize_io();
     initialize_thread();
     initialize_mutex();
+    initialize_sharecommon();
     initialize_process();
     initialize_stack_overflow();
     initialize_libuv();
@@ -33,6 +35,7 @@ void initialize_runtime_module() {
 void finalize_runtime_module() {
     finalize_stack_overflow();
     finalize_process();
+    finalize_sharecommon();
     finalize_mutex();
     finalize_thread();
     finalize_io();
@@ -20,13 +20,15 @@ void inc_heartbeat() { g_heartbeat++; }
 
 void reset_heartbeat() { g_heartbeat = 0; }
 
+size_t get_heartbeat() { return g_heartbeat; }
+
 void set_max_heartbeat(size_t max) { g_max_heartbeat = max; }
 
 size_t get_max_heartbeat() { return g_max_heartbeat; }
 
 void set_max_heartbeat_thousands(unsigned max) { g_max_heartbeat = static_cast<size_t>(max) * 1000; }
 
-scope_heartbeat::scope_heartbeat(size_t max):flet<size_t>(g_heartbeat, max) {}
+LEAN_EXPORT scope_heartbeat::scope_heartbeat(size_t max):flet<size_t>(g_heartbeat, max) {}
 LEAN_EXPORT scope_max_heartbeat::scope_max_heartbeat(size_t max):flet<size_t>(g_max_heartbeat, max) {}
 
 // separate definition to allow breakpoint in debugger
@@ -42,6 +44,8 @@ void check_heartbeat() {
 
 LEAN_THREAD_VALUE(lean_object *, g_cancel_tk, nullptr);
 
+lean_object * get_cancel_tk() { return g_cancel_tk; }
+
 LEAN_EXPORT scope_cancel_tk::scope_cancel_tk(lean_object * o):flet<lean_object *>(g_cancel_tk, o) {}
 
 /* CancelToken.isSet : @& IO.CancelToken → BaseIO Bool */
@@ -18,10 +18,13 @@ LEAN_EXPORT void inc_heartbeat();
 /** \brief Reset thread local counter for approximating elapsed time. */
 LEAN_EXPORT void reset_heartbeat();
 
+/** \brief Return the thread local counter for approximating elapsed time. */
+LEAN_EXPORT size_t get_heartbeat();
+
 /* Update the current heartbeat */
-class scope_heartbeat : flet<size_t> {
+class LEAN_EXPORT scope_heartbeat : flet<size_t> {
 public:
-    scope_heartbeat(size_t curr);
+    LEAN_EXPORT scope_heartbeat(size_t curr);
 };
 
 /** \brief Threshold on the number of heartbeats. check_system will throw
@@ -42,6 +45,9 @@ public:
 
 LEAN_EXPORT void check_heartbeat();
 
+/* Return the thread local `IO.CancelToken` (`nullptr` if unset) */
+LEAN_EXPORT lean_object * get_cancel_tk();
+
 /* Update the thread local `IO.CancelToken` (`nullptr` if unset) */
 class LEAN_EXPORT scope_cancel_tk : flet<lean_object *> {
 public:
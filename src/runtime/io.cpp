@@ -39,6 +39,8 @@ Authors: Leonardo de Moura, Sebastian Ullrich
 #include <string>
 #include <cstdlib>
 #include <cctype>
+#include <vector>
+#include <algorithm>
 #include <sys/stat.h>
 #include <uv.h>
 #include "util/io.h"
@@ -48,6 +50,7 @@ Authors: Leonardo de Moura, Sebastian Ullrich
 #include "runtime/object.h"
 #include "runtime/thread.h"
 #include "runtime/allocprof.h"
+#include "runtime/io_uring.h"
 
 #ifdef _MSC_VER
 #define S_ISDIR(mode) ((mode & _S_IFDIR) != 0)
@@ -595,10 +598,31 @@ extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_write(b_obj_arg h, b_obj_arg
     }
 }
 
-/* Handle.getLine : (@& Handle) → IO Unit */
-extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_get_line(b_obj_arg h, obj_arg /* w */) {
-    FILE * fp = io_get_handle(h);
+#ifndef LEAN_WINDOWS
+/* Capacity above which the `getline` buffer is released after reading a line, so that a single long line does
+   not pin its memory for the rest of the thread's life. */
+static const size_t LEAN_MAX_LINE_BUFFER_CAPACITY = 64 * 1024;
+
+/* Buffer reused by `getline`. */
+struct line_buffer {
+    char * m_data{nullptr};
+    size_t m_capacity{0};
+    ~line_buffer() { free(m_data); }
+    void shrink() {
+        if (m_capacity > LEAN_MAX_LINE_BUFFER_CAPACITY) {
+            free(m_data);
+            m_data = nullptr;
+            m_capacity = 0;
+        }
+    }
+};
+MK_THREAD_LOCAL_GET_DEF(line_buffer, get_line_buffer);
+#endif
 
+/* Read text up to (including) the next line break from `fp`.
+   Return `nullptr` if an error occurred, and the empty string at end-of-file. */
+static obj_res io_read_line(FILE * fp) {
+#ifdef LEAN_WINDOWS
     std::string result;
     int c; // Note: int, not char, required to handle EOF
     while ((c = std::fgetc(fp)) != EOF) {
@@ -607,16 +631,68 @@ extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_get_line(b_obj_arg h, obj_arg
             break;
         }
     }
+    if (std::ferror(fp))
+        return nullptr;
+    if (std::feof(fp))
+        clearerr(fp);
+    return mk_string(result);
+#else
+    /* `getline` scans the stream buffer using `memchr`, which is much faster than reading the line character by
+       character directly into the string. */
+    line_buffer & buf = get_line_buffer();
+    ssize_t n = getline(&buf.m_data, &buf.m_capacity, fp);
+    if (n < 0 && std::ferror(fp))
+        return nullptr;
+    /* EOF is not sticky, further reads may return more data. */
+    if (std::feof(fp))
+        clearerr(fp);
+    if (n <= 0)
+        return lean_mk_string_unchecked("", 0, 0);
+    /* Validating the line also computes its length, so the string is allocated once with its final size and the
+       line is copied straight from the `getline` buffer. Only invalid lines take the lossy path. */
+    size_t pos = 0, len = 0;
+    obj_res line;
+    if (validate_utf8(reinterpret_cast<uint8_t const *>(buf.m_data), n, pos, len))
+        line = lean_mk_string_unchecked(buf.m_data, n, len);
+    else
+        line = lean_mk_string_from_bytes(buf.m_data, n);
+    buf.shrink();
+    return line;
+#endif
+}
 
-    if (std::ferror(fp)) {
+/* Handle.getLine : (@& Handle) → IO Unit */
+extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_get_line(b_obj_arg h, obj_arg /* w */) {
+    obj_res line = io_read_line(io_get_handle(h));
+    if (!line)
         return io_result_mk_error(decode_io_error(errno, nullptr));
-    } else if (std::feof(fp)) {
-        clearerr(fp);
-        return io_result_mk_ok(mk_string(result));
-    } else {
-        obj_res ret = io_result_mk_ok(mk_string(result));
-        return ret;
+    return io_result_mk_ok(line);
+}
+
+/* Handle.getLines : (@& Handle) → USize → IO (Array String) */
+extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_get_lines(b_obj_arg h, usize max, obj_arg /* w */) {
+    FILE * fp = io_get_handle(h);
+    obj_res lines = lean_mk_empty_array();
+    for (usize i = 0; i < max; i++) {
+        obj_res line = io_read_line(fp);
+        if (!line) {
+            dec_ref(lines);
+            return io_result_mk_error(decode_io_error(errno, nullptr));
+        }
+        usize sz = lean_string_size(line) - 1;
+        if (sz == 0) {
+            /* end-of-file */
+            dec_ref(line);
+            break;
+        }
+        bool eol = lean_string_cstr(line)[sz - 1] == '\n';
+        lines = lean_array_push(lines, line);
+        if (!eol) {
+            /* end-of-file */
+            break;
+        }
     }
+    return io_result_mk_ok(lines);
 }
 
 /* Handle.putStr : (@& Handle) → (@& String) → IO Unit */
@@ -631,6 +707,111 @@ extern "C" LEAN_EXPORT obj_res lean_io_prim_handle_put_str(b_obj_arg h, b_obj_ar
     }
 }
 
+// =======================================
+// Memory mapped files
+
+struct mapped_file {
+    char * m_data;
+    size_t m_size;
+};
+
+static lean_external_class * g_io_mapped_file_external_class = nullptr;
+
+static void io_mapped_file_finalizer(void * p) {
+    mapped_file * m = static_cast<mapped_file *>(p);
+    if (m->m_data) {
+#ifdef LEAN_WINDOWS
+        UnmapViewOfFile(m->m_data);
+#else
+        munmap(m->m_data, m->m_size);
+#endif
+    }
+    delete m;
+}
+
+static void io_mapped_file_foreach(void * /* mod */, b_obj_arg /* fn */) {
+}
+
+static mapped_file * io_get_mapped_file(b_obj_arg m) {
+    return static_cast<mapped_file *>(lean_get_external_data(m));
+}
+
+/* MappedFile.mk : (@& FilePath) → IO MappedFile */
+extern "C" LEAN_EXPORT obj_res lean_io_mapped_file_mk(b_obj_arg filename, obj_arg /* w */) {
+#ifdef LEAN_WINDOWS
+    int fd = open(lean_string_cstr(filename), O_RDONLY | O_BINARY | O_NOINHERIT);
+#else
+    int fd = open(lean_string_cstr(filename), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd == -1) {
+        return io_result_mk_error(decode_io_error(errno, filename));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        return io_result_mk_error(decode_io_error(err, filename));
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    char * data = nullptr;
+    if (size > 0) {
+#ifdef LEAN_WINDOWS
+        HANDLE h_map = CreateFileMapping(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), NULL, PAGE_READONLY, 0, 0, NULL);
+        if (h_map != NULL) {
+            data = static_cast<char *>(MapViewOfFile(h_map, FILE_MAP_READ, 0, 0, 0));
+            /* the view keeps the mapping alive */
+            CloseHandle(h_map);
+        }
+        if (data == nullptr) {
+            close(fd);
+            return io_result_mk_error((sstream() << "failed to map '" << lean_string_cstr(filename) << "': " << GetLastError()).str());
+        }
+#else
+        void * r = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (r == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            return io_result_mk_error(decode_io_error(err, filename));
+        }
+        data = static_cast<char *>(r);
+#endif
+    }
+    /* the mapping stays valid after the file descriptor is closed */
+    close(fd);
+    return io_result_mk_ok(lean_alloc_external(g_io_mapped_file_external_class, new mapped_file{data, size}));
+}
+
+/* MappedFile.size : (@& MappedFile) → USize */
+extern "C" LEAN_EXPORT usize lean_io_mapped_file_size(b_obj_arg m) {
+    return io_get_mapped_file(m)->m_size;
+}
+
+/* MappedFile.get : (@& MappedFile) → USize → BaseIO UInt8 */
+extern "C" LEAN_EXPORT obj_res lean_io_mapped_file_get(b_obj_arg m, usize i, obj_arg /* w */) {
+    mapped_file * f = io_get_mapped_file(m);
+    return io_result_mk_ok(box(i < f->m_size ? static_cast<uint8>(f->m_data[i]) : 0));
+}
+
+/* MappedFile.extract : (@& MappedFile) → USize → USize → BaseIO ByteArray */
+extern "C" LEAN_EXPORT obj_res lean_io_mapped_file_extract(b_obj_arg m, usize start, usize stop, obj_arg /* w */) {
+    mapped_file * f = io_get_mapped_file(m);
+    if (stop > f->m_size) stop = f->m_size;
+    usize sz = start < stop ? stop - start : 0;
+    obj_res r = lean_alloc_sarray(1, sz, sz);
+    if (sz > 0)
+        memcpy(lean_sarray_cptr(r), f->m_data + start, sz);
+    return io_result_mk_ok(r);
+}
+
+/* MappedFile.findByte : (@& MappedFile) → UInt8 → USize → BaseIO USize */
+extern "C" LEAN_EXPORT obj_res lean_io_mapped_file_find_byte(b_obj_arg m, uint8 b, usize start, obj_arg /* w */) {
+    mapped_file * f = io_get_mapped_file(m);
+    if (start >= f->m_size)
+        return io_result_mk_ok(box_size_t(f->m_size));
+    void const * r = memchr(f->m_data + start, b, f->m_size - start);
+    return io_result_mk_ok(box_size_t(r ? static_cast<usize>(static_cast<char const *>(r) - f->m_data) : f->m_size));
+}
+
 /* Std.Time.Timestamp.now : IO Timestamp */
 extern "C" LEAN_EXPORT obj_res lean_get_current_time(obj_arg /* w */) {
     using namespace std::chrono;
@@ -1037,32 +1218,376 @@ static obj_res timespec_to_obj(timespec const & ts) {
     return o;
 }
 
+static obj_res mk_metadata(timespec const & atime, timespec const & mtime, uint64 size, unsigned mode) {
+    object * mdata = alloc_cnstr(0, 2, sizeof(uint64) + sizeof(uint8));
+    cnstr_set(mdata, 0, timespec_to_obj(atime));
+    cnstr_set(mdata, 1, timespec_to_obj(mtime));
+    cnstr_set_uint64(mdata, 2 * sizeof(object *), size);
+    cnstr_set_uint8(mdata, 2 * sizeof(object *) + sizeof(uint64),
+                    S_ISDIR(mode) ? 0 :
+                    S_ISREG(mode) ? 1 :
+#ifndef LEAN_WINDOWS
+                    S_ISLNK(mode) ? 2 :
+#endif
+                    3);
+    return mdata;
+}
+
 extern "C" LEAN_EXPORT obj_res lean_io_metadata(b_obj_arg fname, obj_arg) {
     struct stat st;
     if (stat(string_cstr(fname), &st) != 0) {
         return io_result_mk_error(decode_io_error(errno, fname));
     }
-    object * mdata = alloc_cnstr(0, 2, sizeof(uint64) + sizeof(uint8));
 #ifdef __APPLE__
-    cnstr_set(mdata, 0, timespec_to_obj(st.st_atimespec));
-    cnstr_set(mdata, 1, timespec_to_obj(st.st_mtimespec));
+    return io_result_mk_ok(mk_metadata(st.st_atimespec, st.st_mtimespec, st.st_size, st.st_mode));
 #elif defined(LEAN_WINDOWS)
     // TODO: sub-second precision on Windows
-    cnstr_set(mdata, 0, timespec_to_obj(timespec { st.st_atime, 0 }));
-    cnstr_set(mdata, 1, timespec_to_obj(timespec { st.st_mtime, 0 }));
+    return io_result_mk_ok(mk_metadata(timespec { st.st_atime, 0 }, timespec { st.st_mtime, 0 }, st.st_size, st.st_mode));
 #else
-    cnstr_set(mdata, 0, timespec_to_obj(st.st_atim));
-    cnstr_set(mdata, 1, timespec_to_obj(st.st_mtim));
+    return io_result_mk_ok(mk_metadata(st.st_atim, st.st_mtim, st.st_size, st.st_mode));
 #endif
-    cnstr_set_uint64(mdata, 2 * sizeof(object *), st.st_size);
-    cnstr_set_uint8(mdata, 2 * sizeof(object *) + sizeof(uint64),
-                    S_ISDIR(st.st_mode) ? 0 :
-                    S_ISREG(st.st_mode) ? 1 :
-#ifndef LEAN_WINDOWS
-                    S_ISLNK(st.st_mode) ? 2 :
+}
+
+/*
+Batched filesystem operations. On Linux, the syscalls of all files are submitted together through
+io_uring when the kernel supports it, otherwise the files are processed one by one. Errors are
+reported per file as `Except IO.Error α`.
+*/
+
+// Convert the result of an `IO` action to `Except IO.Error α`.
+static obj_res io_result_to_except(obj_arg r) {
+    object * v;
+    if (io_result_is_ok(r)) {
+        v = mk_except_ok(io_result_get_value(r));
+    } else {
+        v = mk_except_err(io_result_get_error(r));
+    }
+    inc(cnstr_get(v, 0));
+    dec_ref(r);
+    return v;
+}
+
+#ifdef LEAN_WINDOWS
+static const int g_batch_open_flags = O_BINARY | O_NOINHERIT;
+#else
+static const int g_batch_open_flags = O_CLOEXEC;
 #endif
-                    3);
-    return io_result_mk_ok(mdata);
+
+/* Maximal number of bytes transferred by a single `read` or `write` call. */
+static const size_t g_batch_max_io = 1u << 30;
+
+/* Read from `fd` into the byte array `buf` until the end of the file, growing it as necessary.
+   Return 0 on success and the error code otherwise. */
+static int read_to_end(int fd, object * & buf) {
+    while (true) {
+        size_t sz  = sarray_size(buf);
+        size_t cap = sarray_capacity(buf);
+        if (sz == cap) {
+            object * new_buf = alloc_sarray(1, sz, cap < 4096 ? 4096 : 2 * cap);
+            memcpy(sarray_cptr(new_buf), sarray_cptr(buf), sz);
+            dec_ref(buf);
+            buf = new_buf;
+            cap = sarray_capacity(buf);
+        }
+        auto n = read(fd, sarray_cptr(buf) + sz, std::min(cap - sz, g_batch_max_io));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        } else if (n == 0) {
+            return 0;
+        }
+        lean_sarray_set_size(buf, sz + n);
+    }
+}
+
+/* Write `data` starting at byte `pos` to `fd`. Return 0 on success and the error code otherwise. */
+static int write_all(int fd, b_obj_arg data, size_t pos) {
+    size_t sz = sarray_size(data);
+    while (pos < sz) {
+        auto n = write(fd, sarray_cptr(data) + pos, std::min(sz - pos, g_batch_max_io));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        pos += n;
+    }
+    return 0;
+}
+
+static obj_res read_bin_file(b_obj_arg fname) {
+    int fd = open(string_cstr(fname), O_RDONLY | g_batch_open_flags);
+    if (fd == -1) {
+        return io_result_mk_error(decode_io_error(errno, fname));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        return io_result_mk_error(decode_io_error(err, fname));
+    }
+    // one more byte than the size so that we usually detect the end of the file without growing
+    object * buf = alloc_sarray(1, 0, st.st_size + 1);
+    int err = read_to_end(fd, buf);
+    close(fd);
+    if (err != 0) {
+        dec_ref(buf);
+        return io_result_mk_error(decode_io_error(err, fname));
+    }
+    return io_result_mk_ok(buf);
+}
+
+static obj_res write_bin_file(b_obj_arg fname, b_obj_arg data) {
+    int fd = open(string_cstr(fname), O_WRONLY | O_CREAT | O_TRUNC | g_batch_open_flags, 0666);
+    if (fd == -1) {
+        return io_result_mk_error(decode_io_error(errno, fname));
+    }
+    int err = write_all(fd, data, 0);
+    if (close(fd) != 0 && err == 0) {
+        err = errno;
+    }
+    if (err != 0) {
+        return io_result_mk_error(decode_io_error(err, fname));
+    }
+    return io_result_mk_ok(box(0));
+}
+
+#if defined(LEAN_IO_URING)
+static void prep_openat(io_uring_sqe & sqe, b_obj_arg fname, int flags) {
+    sqe.opcode     = IORING_OP_OPENAT;
+    sqe.fd         = AT_FDCWD;
+    sqe.addr       = reinterpret_cast<uint64>(string_cstr(fname));
+    sqe.len        = 0666;
+    sqe.open_flags = flags | O_CLOEXEC;
+}
+
+static void prep_statx(io_uring_sqe & sqe, int dirfd, char const * path, int flags, struct statx * buf) {
+    sqe.opcode      = IORING_OP_STATX;
+    sqe.fd          = dirfd;
+    sqe.addr        = reinterpret_cast<uint64>(path);
+    sqe.len         = STATX_BASIC_STATS;
+    sqe.off         = reinterpret_cast<uint64>(buf);
+    sqe.statx_flags = flags;
+}
+
+// Read or write `len` bytes at the current file position.
+static void prep_rw(io_uring_sqe & sqe, uint8 opcode, int fd, void * buf, size_t len) {
+    sqe.opcode = opcode;
+    sqe.fd     = fd;
+    sqe.addr   = reinterpret_cast<uint64>(buf);
+    sqe.len    = len;
+    sqe.off    = static_cast<uint64>(-1);
+}
+
+static void prep_close(io_uring_sqe & sqe, int fd) {
+    sqe.opcode = IORING_OP_CLOSE;
+    sqe.fd     = fd;
+}
+
+static obj_res statx_to_metadata(struct statx const & stx) {
+    return mk_metadata(timespec { stx.stx_atime.tv_sec, stx.stx_atime.tv_nsec },
+                       timespec { stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec }, stx.stx_size, stx.stx_mode);
+}
+
+static obj_res io_uring_metadata_batch(io_uring_queue & q, b_obj_arg fnames) {
+    size_t n = array_size(fnames);
+    std::vector<struct statx> stx(n);
+    std::vector<int> res(n);
+    q.run(n, [&](size_t i, io_uring_sqe & sqe) {
+        prep_statx(sqe, AT_FDCWD, string_cstr(array_get(fnames, i)), 0, &stx[i]);
+    }, res.data());
+    object * r = alloc_array(n, n);
+    for (size_t i = 0; i < n; i++) {
+        object * fname = array_get(fnames, i);
+        array_set(r, i, res[i] < 0 ? mk_except_err(decode_io_error(-res[i], fname)) : mk_except_ok(statx_to_metadata(stx[i])));
+    }
+    return r;
+}
+
+/* Whether opening a file of a chunk failed because there were no file descriptors left. */
+static bool is_fd_exhausted(int fd) {
+    return fd == -EMFILE || fd == -ENFILE;
+}
+
+/* Read the `n` files `fnames[begin:begin+n]` and store the results in the array `r` at the same indices. */
+static void io_uring_read_bin_file_chunk(io_uring_queue & q, b_obj_arg fnames, size_t begin, size_t n, object * r) {
+    std::vector<int> fds(n), res(n), errs(n, 0);
+    std::vector<struct statx> stx(n);
+    std::vector<object *> bufs(n, nullptr);
+    q.run(n, [&](size_t i, io_uring_sqe & sqe) {
+        prep_openat(sqe, array_get(fnames, begin + i), O_RDONLY);
+    }, fds.data());
+    // The phases below only submit operations for the files that are still without error.
+    std::vector<size_t> live;
+    auto update_live = [&]() {
+        live.clear();
+        for (size_t i = 0; i < n; i++) {
+            if (fds[i] >= 0 && errs[i] == 0) live.push_back(i);
+        }
+    };
+    update_live();
+    q.run(live.size(), [&](size_t j, io_uring_sqe & sqe) {
+        prep_statx(sqe, fds[live[j]], "", AT_EMPTY_PATH, &stx[live[j]]);
+    }, res.data());
+    for (size_t j = 0; j < live.size(); j++) {
+        size_t i = live[j];
+        if (res[j] < 0) {
+            errs[i] = -res[j];
+        } else {
+            // one more byte than the size so that we usually detect the end of the file without growing
+            bufs[i] = alloc_sarray(1, 0, stx[i].stx_size + 1);
+        }
+    }
+    update_live();
+    q.run(live.size(), [&](size_t j, io_uring_sqe & sqe) {
+        object * buf = bufs[live[j]];
+        prep_rw(sqe, IORING_OP_READ, fds[live[j]], sarray_cptr(buf), std::min(sarray_capacity(buf), g_batch_max_io));
+    }, res.data());
+    for (size_t j = 0; j < live.size(); j++) {
+        size_t i = live[j];
+        if (res[j] < 0) {
+            errs[i] = -res[j];
+            continue;
+        }
+        lean_sarray_set_size(bufs[i], res[j]);
+        // A short read of a regular file means that we are at its end.
+        if (static_cast<size_t>(res[j]) == std::min(sarray_capacity(bufs[i]), g_batch_max_io) || !S_ISREG(stx[i].stx_mode)) {
+            errs[i] = read_to_end(fds[i], bufs[i]);
+        }
+    }
+    live.clear();
+    for (size_t i = 0; i < n; i++) {
+        if (fds[i] >= 0) live.push_back(i);
+    }
+    q.run(live.size(), [&](size_t j, io_uring_sqe & sqe) {
+        prep_close(sqe, fds[live[j]]);
+    }, res.data());
+    for (size_t i = 0; i < n; i++) {
+        object * fname = array_get(fnames, begin + i);
+        if (is_fd_exhausted(fds[i])) {
+            // retry now that the other files of the chunk are closed
+            array_set(r, begin + i, io_result_to_except(read_bin_file(fname)));
+            continue;
+        }
+        int err = fds[i] < 0 ? -fds[i] : errs[i];
+        if (err != 0) {
+            if (bufs[i]) dec_ref(bufs[i]);
+            array_set(r, begin + i, mk_except_err(decode_io_error(err, fname)));
+        } else {
+            array_set(r, begin + i, mk_except_ok(bufs[i]));
+        }
+    }
+}
+
+/* Write the `n` files `files[begin:begin+n]` and store the results in the array `r` at the same indices. */
+static void io_uring_write_bin_file_chunk(io_uring_queue & q, b_obj_arg files, size_t begin, size_t n, object * r) {
+    std::vector<int> fds(n), res(n), errs(n, 0);
+    q.run(n, [&](size_t i, io_uring_sqe & sqe) {
+        prep_openat(sqe, cnstr_get(array_get(files, begin + i), 0), O_WRONLY | O_CREAT | O_TRUNC);
+    }, fds.data());
+    std::vector<size_t> live;
+    for (size_t i = 0; i < n; i++) {
+        if (fds[i] >= 0) live.push_back(i);
+    }
+    q.run(live.size(), [&](size_t j, io_uring_sqe & sqe) {
+        object * data = cnstr_get(array_get(files, begin + live[j]), 1);
+        prep_rw(sqe, IORING_OP_WRITE, fds[live[j]], sarray_cptr(data), std::min(sarray_size(data), g_batch_max_io));
+    }, res.data());
+    for (size_t j = 0; j < live.size(); j++) {
+        size_t i = live[j];
+        if (res[j] < 0) {
+            errs[i] = -res[j];
+        } else {
+            errs[i] = write_all(fds[i], cnstr_get(array_get(files, begin + i), 1), res[j]);
+        }
+    }
+    q.run(live.size(), [&](size_t j, io_uring_sqe & sqe) {
+        prep_close(sqe, fds[live[j]]);
+    }, res.data());
+    for (size_t j = 0; j < live.size(); j++) {
+        if (res[j] < 0 && errs[live[j]] == 0) errs[live[j]] = -res[j];
+    }
+    for (size_t i = 0; i < n; i++) {
+        object * fname = cnstr_get(array_get(files, begin + i), 0);
+        if (is_fd_exhausted(fds[i])) {
+            // retry now that the other files of the chunk are closed
+            array_set(r, begin + i, io_result_to_except(write_bin_file(fname, cnstr_get(array_get(files, begin + i), 1))));
+            continue;
+        }
+        int err = fds[i] < 0 ? -fds[i] : errs[i];
+        array_set(r, begin + i, err != 0 ? mk_except_err(decode_io_error(err, fname)) : mk_except_ok(box(0)));
+    }
+}
+
+/* Apply `chunk` to consecutive chunks of at most `q.entries()` of the `n` files. Each chunk closes its
+   files before the next one is opened, and files that could not be opened because the process ran out
+   of file descriptors are processed synchronously after that, so a batch succeeds whenever the
+   synchronous fallback, which handles one file at a time, does. */
+template<typename F>
+static obj_res io_uring_chunked(io_uring_queue & q, size_t n, F && chunk) {
+    object * r = alloc_array(n, n);
+    for (size_t begin = 0; begin < n; begin += q.entries()) {
+        chunk(begin, std::min<size_t>(n - begin, q.entries()), r);
+    }
+    return r;
+}
+
+static obj_res io_uring_read_bin_file_batch(io_uring_queue & q, b_obj_arg fnames) {
+    return io_uring_chunked(q, array_size(fnames), [&](size_t begin, size_t n, object * r) {
+        io_uring_read_bin_file_chunk(q, fnames, begin, n, r);
+    });
+}
+
+static obj_res io_uring_write_bin_file_batch(io_uring_queue & q, b_obj_arg files) {
+    return io_uring_chunked(q, array_size(files), [&](size_t begin, size_t n, object * r) {
+        io_uring_write_bin_file_chunk(q, files, begin, n, r);
+    });
+}
+#endif
+
+/* IO.FS.metadataBatch : @& Array FilePath → BaseIO (Array (Except IO.Error IO.FS.Metadata)) */
+extern "C" LEAN_EXPORT obj_res lean_io_metadata_batch(b_obj_arg fnames, obj_arg) {
+#if defined(LEAN_IO_URING)
+    if (io_uring_queue * q = io_uring_queue::get()) {
+        return io_result_mk_ok(io_uring_metadata_batch(*q, fnames));
+    }
+#endif
+    size_t n = array_size(fnames);
+    object * r = alloc_array(n, n);
+    for (size_t i = 0; i < n; i++) {
+        array_set(r, i, io_result_to_except(lean_io_metadata(array_get(fnames, i), box(0))));
+    }
+    return io_result_mk_ok(r);
+}
+
+/* IO.FS.readBinFileBatch : @& Array FilePath → BaseIO (Array (Except IO.Error ByteArray)) */
+extern "C" LEAN_EXPORT obj_res lean_io_read_bin_file_batch(b_obj_arg fnames, obj_arg) {
+#if defined(LEAN_IO_URING)
+    if (io_uring_queue * q = io_uring_queue::get()) {
+        return io_result_mk_ok(io_uring_read_bin_file_batch(*q, fnames));
+    }
+#endif
+    size_t n = array_size(fnames);
+    object * r = alloc_array(n, n);
+    for (size_t i = 0; i < n; i++) {
+        array_set(r, i, io_result_to_except(read_bin_file(array_get(fnames, i))));
+    }
+    return io_result_mk_ok(r);
+}
+
+/* IO.FS.writeBinFileBatch : @& Array (FilePath × ByteArray) → BaseIO (Array (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT obj_res lean_io_write_bin_file_batch(b_obj_arg files, obj_arg) {
+#if defined(LEAN_IO_URING)
+    if (io_uring_queue * q = io_uring_queue::get()) {
+        return io_result_mk_ok(io_uring_write_bin_file_batch(*q, files));
+    }
+#endif
+    size_t n = array_size(files);
+    object * r = alloc_array(n, n);
+    for (size_t i = 0; i < n; i++) {
+        object * file = array_get(files, i);
+        array_set(r, i, io_result_to_except(write_bin_file(cnstr_get(file, 0), cnstr_get(file, 1))));
+    }
+    return io_result_mk_ok(r);
 }
 
 extern "C" LEAN_EXPORT obj_res lean_io_create_dir(b_obj_arg p, obj_arg) {
@@ -1295,25 +1820,30 @@ static inline atomic<object*> * mt_ref_val_addr(object * o) {
 */
 static inline bool ref_maybe_mt(b_obj_arg ref) { return lean_is_mt(ref) || lean_is_persistent(ref); }
 
+/* Wait until the value of a multi-threaded ref is not `nullptr`, i.e., until the thread that
+   took it puts a value back, and take ownership of it. */
+static object * mt_ref_take(b_obj_arg ref) {
+    atomic<object *> * val_addr = mt_ref_val_addr(ref);
+    object * val;
+    park_until(ref, [&]() { val = val_addr->exchange(nullptr); return val != nullptr; });
+    return val;
+}
+
 extern "C" LEAN_EXPORT obj_res lean_st_ref_get(b_obj_arg ref, obj_arg) {
     if (ref_maybe_mt(ref)) {
-        atomic<object *> * val_addr = mt_ref_val_addr(ref);
-        while (true) {
-            /*
-              We cannot simply read `val` from the ref and `inc` it like in the `else` branch since someone else could
-              write to the ref in between and remove the last owning reference to the object. Instead, we must take
-              ownership of the RC token in the ref via `exchange`, duplicate it, then put one RC token back. */
-            object * val = val_addr->exchange(nullptr);
-            if (val != nullptr) {
-                inc(val);
-                object * tmp = val_addr->exchange(val);
-                if (tmp != nullptr) {
-                    /* this may happen if another thread wrote `ref` */
-                    dec(tmp);
-                }
-                return io_result_mk_ok(val);
-            }
+        /*
+          We cannot simply read `val` from the ref and `inc` it like in the `else` branch since someone else could
+          write to the ref in between and remove the last owning reference to the object. Instead, we must take
+          ownership of the RC token in the ref via `exchange`, duplicate it, then put one RC token back. */
+        object * val = mt_ref_take(ref);
+        inc(val);
+        object * tmp = mt_ref_val_addr(ref)->exchange(val);
+        unpark_all(ref);
+        if (tmp != nullptr) {
+            /* this may happen if another thread wrote `ref` */
+            dec(tmp);
         }
+        return io_result_mk_ok(val);
     } else {
         object * val = lean_to_ref(ref)->m_value;
         lean_assert(val != nullptr);
@@ -1324,12 +1854,7 @@ extern "C" LEAN_EXPORT obj_res lean_st_ref_get(b_obj_arg ref, obj_arg) {
 
 extern "C" LEAN_EXPORT obj_res lean_st_ref_take(b_obj_arg ref, obj_arg) {
     if (ref_maybe_mt(ref)) {
-        atomic<object *> * val_addr = mt_ref_val_addr(ref);
-        while (true) {
-            object * val = val_addr->exchange(nullptr);
-            if (val != nullptr)
-                return io_result_mk_ok(val);
-        }
+        return io_result_mk_ok(mt_ref_take(ref));
     } else {
         object * val = lean_to_ref(ref)->m_value;
         lean_assert(val != nullptr);
@@ -1348,6 +1873,7 @@ extern "C" LEAN_EXPORT obj_res lean_st_ref_set(b_obj_arg ref, obj_arg a, obj_arg
         mark_mt(a);
         atomic<object *> * val_addr = mt_ref_val_addr(ref);
         object * old_a = val_addr->exchange(a);
+        unpark_all(ref);
         if (old_a != nullptr)
             dec(old_a);
         return io_result_mk_ok(box(0));
@@ -1363,12 +1889,14 @@ extern "C" LEAN_EXPORT obj_res lean_st_ref_swap(b_obj_arg ref, obj_arg a, obj_ar
     if (ref_maybe_mt(ref)) {
         /* See io_ref_write */
         mark_mt(a);
-        atomic<object *> * val_addr = mt_ref_val_addr(ref);
-        while (true) {
-            object * old_a = val_addr->exchange(a);
-            if (old_a != nullptr)
-                return io_result_mk_ok(old_a);
+        object * old_a = mt_ref_take(ref);
+        object * tmp = mt_ref_val_addr(ref)->exchange(a);
+        unpark_all(ref);
+        if (tmp != nullptr) {
+            /* this may happen if another thread wrote `ref` */
+            dec(tmp);
         }
+        return io_result_mk_ok(old_a);
     } else {
         object * old_a = lean_to_ref(ref)->m_value;
         if (old_a == nullptr)
@@ -1378,6 +1906,29 @@ extern "C" LEAN_EXPORT obj_res lean_st_ref_swap(b_obj_arg ref, obj_arg a, obj_ar
     }
 }
 
+/* Ref.ptrCompareExchange {σ α} (r : @& Ref σ α) (expected : @& α) (new : α) : ST σ Bool */
+extern "C" LEAN_EXPORT obj_res lean_st_ref_ptr_compare_exchange(b_obj_arg ref, b_obj_arg expected, obj_arg a, obj_arg) {
+    bool ok;
+    if (ref_maybe_mt(ref)) {
+        /* See io_ref_write */
+        mark_mt(a);
+        object * e = expected;
+        /* Remark: the compare and swap fails if the value has been taken by another thread. */
+        ok = mt_ref_val_addr(ref)->compare_exchange_strong(e, a);
+    } else {
+        ok = lean_to_ref(ref)->m_value == expected;
+        if (ok)
+            lean_to_ref(ref)->m_value = a;
+    }
+    if (ok) {
+        /* release the token owned by `ref` */
+        dec(expected);
+    } else {
+        dec(a);
+    }
+    return io_result_mk_ok(box(ok));
+}
+
 extern "C" LEAN_EXPORT obj_res lean_st_ref_ptr_eq(b_obj_arg ref1, b_obj_arg ref2, obj_arg) {
     // TODO(Leo): ref_maybe_mt
     bool r = lean_to_ref(ref1)->m_value == lean_to_ref(ref2)->m_value;
@@ -1468,6 +2019,7 @@ void initialize_io() {
     g_io_error_nullptr_read = lean_mk_io_user_error(mk_ascii_string_unchecked("null reference read"));
     mark_persistent(g_io_error_nullptr_read);
     g_io_handle_external_class = lean_register_external_class(io_handle_finalizer, io_handle_foreach);
+    g_io_mapped_file_external_class = lean_register_external_class(io_mapped_file_finalizer, io_mapped_file_foreach);
 #if defined(LEAN_WINDOWS)
     _setmode(_fileno(stdout), _O_BINARY);
     _setmode(_fileno(stderr), _O_BINARY);
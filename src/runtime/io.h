@@ -16,6 +16,18 @@ LEAN_EXPORT lean_obj_res io_result_mk_error(char const * msg);
 LEAN_EXPORT lean_obj_res io_result_mk_error(std::string const & msg);
 inline lean_obj_res decode_io_error(int errnum, b_lean_obj_arg fname) { return lean_decode_io_error(errnum, fname); }
 inline lean_obj_res decode_uv_error(int errnum, b_lean_obj_arg fname) { return lean_decode_uv_error(errnum, fname); }
+// `Except.ok value`
+inline lean_obj_res mk_except_ok(lean_obj_arg value) {
+    lean_object * r = lean_alloc_ctor(1, 1, 0);
+    lean_ctor_set(r, 0, value);
+    return r;
+}
+// `Except.error error`
+inline lean_obj_res mk_except_err(lean_obj_arg error) {
+    lean_object * r = lean_alloc_ctor(0, 1, 0);
+    lean_ctor_set(r, 0, error);
+    return r;
+}
 LEAN_EXPORT lean_obj_res io_wrap_handle(FILE * hfile);
 void initialize_io();
 void finalize_io();
@@ -0,0 +1,228 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include "runtime/io_uring.h"
+
+#if defined(LEAN_IO_URING)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "runtime/thread.h"
+#include "runtime/debug.h"
+
+namespace lean {
+/* Number of submission queue entries, the completion queue has twice as many. */
+static const unsigned g_io_uring_entries = 256;
+/* Set when io_uring is not supported by the kernel or the environment, so that other threads do not
+   try again. */
+static std::atomic<bool> g_io_uring_unavailable(false);
+
+io_uring_queue::io_uring_queue():
+    m_fd(-1), m_sq_ptr(MAP_FAILED), m_cq_ptr(MAP_FAILED), m_sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+    m_failed(false) {
+    bool permanent = false;
+    if (!init(permanent)) {
+        m_failed = true;
+        if (permanent)
+            g_io_uring_unavailable = true;
+    }
+}
+
+io_uring_queue::~io_uring_queue() {
+    if (m_sqes != MAP_FAILED)
+        munmap(m_sqes, m_entries * sizeof(io_uring_sqe));
+    if (m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr)
+        munmap(m_cq_ptr, m_cq_size);
+    if (m_sq_ptr != MAP_FAILED)
+        munmap(m_sq_ptr, m_sq_size);
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+/* Try to create the io_uring. On failure, `permanent` is set if no other thread will succeed either. */
+bool io_uring_queue::init(bool & permanent) {
+    permanent = true;
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+    // `LEAN_IO_URING=0` forces the synchronous fallback.
+    if (char const * v = std::getenv("LEAN_IO_URING")) {
+        if (strcmp(v, "0") == 0)
+            return false;
+    }
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    m_fd = syscall(__NR_io_uring_setup, g_io_uring_entries, &p);
+    if (m_fd < 0) {
+        // The kernel does not implement io_uring, or it is disabled by `io_uring_disabled` or seccomp.
+        // Other errors (e.g. `EMFILE`, `ENOMEM`) may be specific to this thread or transient.
+        permanent = errno == ENOSYS || errno == EPERM || errno == EACCES;
+        return false;
+    }
+
+    // Make sure the kernel supports all operations used by the runtime.
+    size_t probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe * probe = static_cast<io_uring_probe *>(calloc(1, probe_size));
+    bool supported = syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    for (unsigned op : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE }) {
+        supported = supported && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    // Reads and writes must be able to continue at the current file position.
+    if (!supported || !(p.features & IORING_FEAT_RW_CUR_POS))
+        return false;
+    permanent = false;
+
+    m_entries = p.sq_entries;
+    m_sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    m_cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+    }
+    m_sq_ptr = mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (m_sq_ptr == MAP_FAILED)
+        return false;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        m_cq_ptr = m_sq_ptr;
+    } else {
+        m_cq_ptr = mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if (m_cq_ptr == MAP_FAILED)
+            return false;
+    }
+    m_sqes = static_cast<io_uring_sqe *>(mmap(nullptr, m_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+    if (m_sqes == MAP_FAILED)
+        return false;
+
+    char * sq = static_cast<char *>(m_sq_ptr);
+    char * cq = static_cast<char *>(m_cq_ptr);
+    m_sq_head  = reinterpret_cast<unsigned *>(sq + p.sq_off.head);
+    m_sq_tail  = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+    m_sq_mask  = reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+    m_sq_array = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+    m_cq_head  = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+    m_cq_tail  = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+    m_cq_mask  = reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+    m_cqes     = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+    return true;
+#else
+    return false;
+#endif
+}
+
+MK_THREAD_LOCAL_GET_DEF(io_uring_queue, get_io_uring_queue);
+
+io_uring_queue * io_uring_queue::get() {
+    if (g_io_uring_unavailable)
+        return nullptr;
+    io_uring_queue & q = get_io_uring_queue();
+    return q.m_failed ? nullptr : &q;
+}
+
+/* Execute the operation described by `sqe` with the corresponding syscall. */
+int io_uring_queue::run_sync(io_uring_sqe const & sqe) {
+    long r;
+    void * buf = reinterpret_cast<void *>(sqe.addr);
+    switch (sqe.opcode) {
+    case IORING_OP_OPENAT:
+        r = openat(sqe.fd, static_cast<char const *>(buf), sqe.open_flags, sqe.len);
+        break;
+    case IORING_OP_STATX:
+        r = syscall(__NR_statx, sqe.fd, buf, sqe.statx_flags, sqe.len, reinterpret_cast<void *>(sqe.off));
+        break;
+    case IORING_OP_READ:
+        r = sqe.off == static_cast<uint64_t>(-1) ? read(sqe.fd, buf, sqe.len) : pread(sqe.fd, buf, sqe.len, sqe.off);
+        break;
+    case IORING_OP_WRITE:
+        r = sqe.off == static_cast<uint64_t>(-1) ? write(sqe.fd, buf, sqe.len) : pwrite(sqe.fd, buf, sqe.len, sqe.off);
+        break;
+    case IORING_OP_CLOSE:
+        r = close(sqe.fd);
+        break;
+    default:
+        lean_unreachable();
+    }
+    return r < 0 ? -errno : static_cast<int>(r);
+}
+
+void io_uring_queue::run(size_t n, std::function<void(size_t, io_uring_sqe &)> const & prep, int * res) {
+    size_t next      = 0;  // next operation to be added to the submission queue
+    size_t done      = 0;  // number of completed operations
+    unsigned pending = 0;  // operations in the submission queue that the kernel has not consumed yet
+    unsigned inflight = 0; // operations that have not completed yet, at most `m_entries` so that
+                           // the completion queue can never overflow
+    unsigned sq_tail = *m_sq_tail;
+    lean_assert(!m_failed);
+    while (done < n) {
+        while (next < n && inflight < m_entries) {
+            unsigned idx = sq_tail & *m_sq_mask;
+            io_uring_sqe & sqe = m_sqes[idx];
+            memset(&sqe, 0, sizeof(sqe));
+            prep(next, sqe);
+            sqe.user_data = next;
+            m_sq_array[idx] = idx;
+            sq_tail++; next++; inflight++; pending++;
+        }
+        __atomic_store_n(m_sq_tail, sq_tail, __ATOMIC_RELEASE);
+
+        int r = syscall(__NR_io_uring_enter, m_fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (r >= 0) {
+            pending -= r;
+        } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            // The io_uring is unusable. The kernel does not look at entries it has not consumed yet,
+            // so we take them back and execute them, and all operations not submitted yet, with the
+            // synchronous syscalls.
+            m_failed = true;
+            unsigned sq_head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+            for (unsigned t = sq_head; t != sq_tail; t++) {
+                io_uring_sqe const & sqe = m_sqes[t & *m_sq_mask];
+                res[sqe.user_data] = run_sync(sqe);
+                inflight--; done++;
+            }
+            sq_tail = sq_head;
+            __atomic_store_n(m_sq_tail, sq_tail, __ATOMIC_RELEASE);
+            pending = 0;
+            for (; next < n; next++) {
+                io_uring_sqe sqe;
+                memset(&sqe, 0, sizeof(sqe));
+                prep(next, sqe);
+                res[next] = run_sync(sqe);
+                done++;
+            }
+            // Block until the operations the kernel accepted before the failure have completed, as
+            // their buffers must stay valid until then.
+            reap(res, inflight, done);
+            while (inflight > 0) {
+                if (syscall(__NR_io_uring_enter, m_fd, 0, inflight, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR) {
+                    // Waiting failed as well. The completions are still posted, so check again later.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                reap(res, inflight, done);
+            }
+        }
+
+        reap(res, inflight, done);
+    }
+}
+
+/* Record the results of the operations in the completion queue. */
+void io_uring_queue::reap(int * res, unsigned & inflight, size_t & done) {
+    unsigned cq_head = *m_cq_head;
+    unsigned cq_tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+    for (; cq_head != cq_tail; cq_head++) {
+        io_uring_cqe & cqe = m_cqes[cq_head & *m_cq_mask];
+        res[cqe.user_data] = cqe.res;
+        inflight--; done++;
+    }
+    __atomic_store_n(m_cq_head, cq_head, __ATOMIC_RELEASE);
+}
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#pragma once
+#include <cstddef>
+#include <functional>
+
+#if defined(__linux__) && !defined(LEAN_EMSCRIPTEN) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+// `IORING_FEAT_FAST_POLL` was introduced in Linux 5.7, after all opcodes we use.
+#ifdef IORING_FEAT_FAST_POLL
+#define LEAN_IO_URING
+#endif
+#endif
+#endif
+
+namespace lean {
+#if defined(LEAN_IO_URING)
+/*
+A minimal io_uring instance used to submit filesystem syscalls in batches. Each thread lazily creates
+its own instance. If the kernel does not support io_uring (or the opcodes we need), it is disabled
+by a seccomp filter, or the environment variable `LEAN_IO_URING` is set to `0`, `get` returns
+`nullptr` and callers must fall back to the synchronous syscalls. Other failures, such as running
+out of memory or file descriptors while creating the instance, only disable io_uring for the
+current thread.
+*/
+class io_uring_queue {
+    int                m_fd;
+    unsigned           m_entries;
+    void *             m_sq_ptr;
+    size_t             m_sq_size;
+    void *             m_cq_ptr;
+    size_t             m_cq_size;
+    io_uring_sqe *     m_sqes;
+    unsigned *         m_sq_tail;
+    unsigned *         m_sq_mask;
+    unsigned *         m_sq_array;
+    unsigned *         m_cq_head;
+    unsigned *         m_cq_tail;
+    unsigned *         m_cq_mask;
+    unsigned *         m_sq_head;
+    io_uring_cqe *     m_cqes;
+    bool               m_failed;
+    bool init(bool & permanent);
+    static int run_sync(io_uring_sqe const & sqe);
+    void reap(int * res, unsigned & inflight, size_t & done);
+public:
+    io_uring_queue();
+    ~io_uring_queue();
+    /* Return the io_uring of the current thread, or `nullptr` if io_uring is not available. */
+    static io_uring_queue * get();
+    /* Maximal number of operations in flight at the same time. */
+    unsigned entries() const { return m_entries; }
+    /* Execute `n` operations. `prep(i, sqe)` must fill in the zero-initialized submission entry of the
+       `i`-th operation. When it completes, `res[i]` is set to its result, i.e. the return value of the
+       corresponding syscall or `-errno`. If the io_uring itself fails, the operations the kernel has
+       not accepted yet are executed synchronously instead, and `get` returns `nullptr` on this
+       thread from then on. */
+    void run(size_t n, std::function<void(size_t, io_uring_sqe &)> const & prep, int * res);
+};
+#endif
+}
@@ -15,6 +15,9 @@ namespace lean {
 
 extern "C" void initialize_libuv() {
     initialize_libuv_timer();
+    initialize_libuv_fs();
+    initialize_libuv_tcp_socket();
+    initialize_libuv_udp_socket();
     initialize_libuv_loop();
 
     lthread([]() { event_loop_run_loop(&global_ev); });
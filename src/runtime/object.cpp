@@ -142,12 +142,24 @@ extern "C" LEAN_EXPORT object * lean_sorry(uint8) {
     lean_unreachable();
 }
 
+#ifdef LEAN_BIASED_RC
+static inline void brc_inc(object * o, int n);
+#endif
+
 extern "C" LEAN_EXPORT void lean_inc_ref_cold(lean_object * o) {
+#ifdef LEAN_BIASED_RC
+    brc_inc(o, 1);
+#else
     std::atomic_fetch_sub_explicit(lean_get_rc_mt_addr(o), 1, std::memory_order_relaxed);
+#endif
 }
 
 extern "C" LEAN_EXPORT void lean_inc_ref_n_cold(lean_object * o, unsigned n) {
+#ifdef LEAN_BIASED_RC
+    brc_inc(o, (int)n);
+#else
     std::atomic_fetch_sub_explicit(lean_get_rc_mt_addr(o), (int)n, std::memory_order_relaxed);
+#endif
 }
 
 extern "C" LEAN_EXPORT size_t lean_object_byte_size(lean_object * o) {
@@ -181,6 +193,8 @@ extern "C" LEAN_EXPORT size_t lean_object_data_byte_size(lean_object * o) {
         case LeanArray:       return lean_array_data_byte_size(o);
         case LeanScalarArray: return lean_sarray_data_byte_size(o);
         case LeanString:      return lean_string_data_byte_size(o);
+        /* closures created by `fix_args` may have spare capacity for additional arguments */
+        case LeanClosure:     return sizeof(lean_closure_object) + sizeof(void*)*lean_closure_num_fixed(o);
         default:              return lean_small_object_size(o);
         }
     } else {
@@ -248,7 +262,134 @@ static inline lean_object * pop_back(lean_object * & todo) {
     return r;
 }
 
-static inline void dec(lean_object * o, lean_object* & todo) {
+#ifdef LEAN_BIASED_RC
+/*
+Biased reference counting of multi-threaded objects.
+
+Most multi-threaded objects are only ever updated by the thread that marked them, e.g., the environment that an
+elaboration task extends before passing it on to the next task. So `lean_mark_mt` makes the current thread the
+*owner* of the object, and the RC is split into two counters:
+- the biased counter `b = -1 - m_rc`, which only the owner updates, without atomic instructions, and
+- the shared counter `s`, which all other threads update atomically. `m_shared_rc` stores `s * BRC_ONE` plus the
+  flags `BRC_QUEUED` and `BRC_MERGED`.
+
+When `b` drops to zero, the owner *merges* the counters by clearing `m_owner` and setting `BRC_MERGED`. From then on,
+all threads use the shared counter, and the object is freed when `s` reaches zero.
+
+A negative `s` means that references counted in `b` have been released by other threads. The owner may then never
+release enough references to merge the counters itself, so the thread that made `s` negative queues the object at
+its owner, which merges it at its next safe point (`brc_process_queue`). If the owner has terminated, the thread
+merges the object itself. A queued object is only freed by the thread that dequeues it.
+*/
+static const int BRC_QUEUED = 1;
+static const int BRC_MERGED = 2;
+static const int BRC_ONE    = 4;
+
+struct brc_thread {
+    std::vector<object *> m_queue;  // protected by `g_brc_mutex`
+    atomic<bool>          m_has_queue{false};
+};
+
+static mutex * g_brc_mutex = nullptr;
+/* Threads that have owned objects, indexed by their id minus one. Ids are not reused, entries of terminated threads
+   are `nullptr`. Protected by `g_brc_mutex`. */
+static std::vector<brc_thread *> * g_brc_threads = nullptr;
+LEAN_THREAD_VALUE(unsigned, g_brc_thread_id, 0);
+LEAN_THREAD_PTR(brc_thread, g_brc_thread);
+
+static inline atomic<int> * brc_shared_rc(object * o) {
+    return reinterpret_cast<atomic<int> *>(&o->m_shared_rc);
+}
+
+static inline atomic<unsigned> * brc_owner(object * o) {
+    return reinterpret_cast<atomic<unsigned> *>(&o->m_owner);
+}
+
+static inline bool brc_is_owner(object * o) {
+    unsigned id = g_brc_thread_id;
+    return id != 0 && brc_owner(o)->load(std::memory_order_relaxed) == id;
+}
+
+/* Make the current thread the owner of `o`, an object that is being marked multi-threaded. */
+static inline void brc_mark_mt(object * o) {
+    if (unsigned id = g_brc_thread_id) {
+        brc_owner(o)->store(id, std::memory_order_relaxed);
+        brc_shared_rc(o)->store(0, std::memory_order_relaxed);
+        o->m_rc = -1 - o->m_rc;
+    } else {
+        brc_owner(o)->store(0, std::memory_order_relaxed);
+        brc_shared_rc(o)->store(o->m_rc * BRC_ONE + BRC_MERGED, std::memory_order_relaxed);
+        o->m_rc = -1;
+    }
+}
+
+static inline void brc_inc(object * o, int n) {
+    if (brc_is_owner(o)) {
+        o->m_rc -= n;
+    } else {
+        brc_shared_rc(o)->fetch_add(n * BRC_ONE, std::memory_order_relaxed);
+    }
+}
+
+static void brc_enqueue(object * o);
+
+/* Decrement the RC of the multi-threaded object `o`, return true if it must be freed. */
+static inline bool brc_dec(object * o) {
+    if (brc_is_owner(o)) {
+        if (++o->m_rc != -1)
+            return false;
+        brc_owner(o)->store(0, std::memory_order_relaxed);
+        return brc_shared_rc(o)->fetch_add(BRC_MERGED, std::memory_order_acq_rel) == 0;
+    }
+    int old_rc = brc_shared_rc(o)->load(std::memory_order_relaxed);
+    int new_rc;
+    bool enqueue;
+    do {
+        new_rc  = old_rc - BRC_ONE;
+        enqueue = new_rc < 0 && (new_rc & (BRC_QUEUED | BRC_MERGED)) == 0;
+        if (enqueue)
+            new_rc |= BRC_QUEUED;
+    } while (!brc_shared_rc(o)->compare_exchange_weak(old_rc, new_rc, std::memory_order_acq_rel));
+    if (enqueue)
+        brc_enqueue(o);
+    return new_rc == BRC_MERGED;
+}
+
+/* Merge the counters of the queued object `o`, return true if it must be freed. This is done by the owner of `o`,
+   or, after the owner terminated, by the thread that queued `o`. */
+static bool brc_merge(object * o) {
+    int delta = -BRC_QUEUED;
+    if (brc_owner(o)->load(std::memory_order_relaxed) != 0) {
+        delta += (-1 - o->m_rc) * BRC_ONE + BRC_MERGED;
+        o->m_rc = -1;
+        brc_owner(o)->store(0, std::memory_order_relaxed);
+    }
+    return brc_shared_rc(o)->fetch_add(delta, std::memory_order_acq_rel) + delta == BRC_MERGED;
+}
+#endif
+
+static inline void mark_mt_rc(object * o) {
+#ifdef LEAN_BIASED_RC
+    brc_mark_mt(o);
+#else
+    o->m_rc = -o->m_rc;
+#endif
+}
+
+/* Decrement the RC of the multi-threaded object `o`, return true if it must be freed. */
+static inline bool dec_mt(object * o) {
+#ifdef LEAN_BIASED_RC
+    return brc_dec(o);
+#else
+    return std::atomic_fetch_add_explicit(lean_get_rc_mt_addr(o), 1, std::memory_order_acq_rel) == -1;
+#endif
+}
+
+/* Decrement the RC of `o` and add it to `todo` if it must be freed. If `split_mt` is true,
+   multi-threaded objects are added to `todo_mt` instead. Note that `push_back` overwrites the RC,
+   so the kind of an object cannot be recovered after it has been added to a list. */
+template<bool split_mt>
+static inline void dec(lean_object * o, lean_object* & todo, lean_object* & todo_mt) {
     if (lean_is_scalar(o))
         return;
     if (LEAN_LIKELY(o->m_rc > 1)) {
@@ -257,8 +398,8 @@ static inline void dec(lean_object * o, lean_object* & todo) {
         push_back(todo, o);
     } else if (o->m_rc == 0) {
         return;
-    } else if (std::atomic_fetch_add_explicit(lean_get_rc_mt_addr(o), 1, std::memory_order_acq_rel) == -1) {
-        push_back(todo, o);
+    } else if (dec_mt(o)) {
+        push_back(split_mt ? todo_mt : todo, o);
     }
 }
 
@@ -266,7 +407,12 @@ static inline void dec(lean_object * o, lean_object* & todo) {
 LEAN_THREAD_PTR(object, g_to_free);
 #endif
 
-static void lean_del_core(object * o, object * & todo);
+template<bool split_mt>
+static void lean_del_core(object * o, object * & todo, object * & todo_mt);
+
+static inline void lean_del_core(object * o, object * & todo) {
+    lean_del_core<false>(o, todo, todo);
+}
 
 extern "C" LEAN_EXPORT lean_object * lean_alloc_object(size_t sz) {
 #ifdef LEAN_LAZY_RC
@@ -286,26 +432,27 @@ extern "C" LEAN_EXPORT lean_object * lean_alloc_object(size_t sz) {
 
 static void deactivate_task(lean_task_object * t);
 
-static void lean_del_core(object * o, object * & todo) {
+template<bool split_mt>
+static void lean_del_core(object * o, object * & todo, object * & todo_mt) {
     uint8 tag = lean_ptr_tag(o);
     if (tag <= LeanMaxCtorTag) {
         object ** it  = lean_ctor_obj_cptr(o);
         object ** end = it + lean_ctor_num_objs(o);
-        for (; it != end; ++it) dec(*it, todo);
+        for (; it != end; ++it) dec<split_mt>(*it, todo, todo_mt);
         lean_free_small_object(o);
     } else {
         switch (tag) {
         case LeanClosure: {
             object ** it  = lean_closure_arg_cptr(o);
             object ** end = it + lean_closure_num_fixed(o);
-            for (; it != end; ++it) dec(*it, todo);
+            for (; it != end; ++it) dec<split_mt>(*it, todo, todo_mt);
             lean_free_small_object(o);
             break;
         }
         case LeanArray: {
             object ** it  = lean_array_cptr(o);
             object ** end = it + lean_array_size(o);
-            for (; it != end; ++it) dec(*it, todo);
+            for (; it != end; ++it) dec<split_mt>(*it, todo, todo_mt);
             lean_dealloc(o, lean_array_byte_size(o));
             break;
         }
@@ -313,6 +460,7 @@ static void lean_del_core(object * o, object * & todo) {
             lean_dealloc(o, lean_sarray_byte_size(o));
             break;
         case LeanString:
+            if (lean_string_is_slice(o)) dec<split_mt>(lean_to_string_slice(o)->m_parent, todo, todo_mt);
             lean_dealloc(o, lean_string_byte_size(o));
             break;
         case LeanMPZ:
@@ -320,12 +468,12 @@ static void lean_del_core(object * o, object * & todo) {
             lean_free_small_object(o);
             break;
         case LeanThunk:
-            if (object * c = lean_to_thunk(o)->m_closure) dec(c, todo);
-            if (object * v = lean_to_thunk(o)->m_value) dec(v, todo);
+            if (object * c = lean_to_thunk(o)->m_closure) dec<split_mt>(c, todo, todo_mt);
+            if (object * v = lean_to_thunk(o)->m_value) dec<split_mt>(v, todo, todo_mt);
             lean_free_small_object(o);
             break;
         case LeanRef:
-            if (object * v = lean_to_ref(o)->m_value) dec(v, todo);
+            if (object * v = lean_to_ref(o)->m_value) dec<split_mt>(v, todo, todo_mt);
             lean_free_small_object(o);
             break;
         case LeanTask:
@@ -341,19 +489,269 @@ static void lean_del_core(object * o, object * & todo) {
     }
 }
 
-extern "C" LEAN_EXPORT void lean_dec_ref_cold(lean_object * o) {
-    if (o->m_rc == 1 || std::atomic_fetch_add_explicit(lean_get_rc_mt_addr(o), 1, std::memory_order_acq_rel) == -1) {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+/*
+Deferred deallocation: when enabled by `lean_runtime_set_deferred_free_threshold`, a thread that
+drops the last reference to a large object graph frees only the first `threshold` objects itself and
+hands the remaining multi-threaded objects to a background reclaimer thread. Multi-threaded objects
+only point to multi-threaded or persistent objects, whose reference counts are updated atomically, so
+the reclaimer can free them independently of the owning thread. Single-threaded objects are always
+freed by the owning thread. The small objects freed by the reclaimer are sent back to the heaps that
+allocated them through the usual export/import lists of the allocator.
+*/
+static std::atomic<size_t> g_deferred_free_threshold(0);
+/* Number of objects waiting to be freed by the reclaimer: the objects handed to it and the objects that became
+   unreachable from them but have not been freed yet. */
+static std::atomic<size_t> g_deferred_free_backlog(0);
+/* Total number of objects freed by the reclaimer. */
+static std::atomic<size_t> g_deferred_free_total(0);
+/* The reclaimer updates the counters above after freeing this many objects. */
+#define LEAN_DEFERRED_FREE_STATS_BATCH 4096
+
+class reclaimer {
+    mutex                    m_mutex;
+    condition_variable       m_queue_cv;
+    object *                 m_queue{nullptr};
+    bool                     m_shutting_down{false};
+    std::unique_ptr<lthread> m_thread;
+
+    static void update_stats(size_t & num_freed, size_t & num_pushed) {
+        // add before subtracting so that the backlog does not underflow
+        g_deferred_free_backlog += num_pushed;
+        g_deferred_free_backlog -= num_freed;
+        g_deferred_free_total   += num_freed;
+        num_freed  = 0;
+        num_pushed = 0;
+    }
+
+    void run() {
+        unique_lock<mutex> lock(m_mutex);
+        while (true) {
+            if (m_queue == nullptr) {
+                if (m_shutting_down)
+                    break;
+                m_queue_cv.wait(lock);
+                continue;
+            }
+            object * todo = m_queue;
+            m_queue       = nullptr;
+            lock.unlock();
+            size_t num_freed  = 0;
+            size_t num_pushed = 0;
+            while (todo != nullptr) {
+                object * o    = pop_back(todo);
+                object * rest = todo;
+                lean_del_core(o, todo);
+                // `lean_del_core` pushes the objects that became unreachable in front of `rest`
+                for (object * it = todo; it != rest; it = get_next(it))
+                    num_pushed++;
+                if (++num_freed == LEAN_DEFERRED_FREE_STATS_BATCH)
+                    update_stats(num_freed, num_pushed);
+            }
+            update_stats(num_freed, num_pushed);
+            // do not keep freed objects of other heaps waiting in the export list of this thread
+            flush_dealloc_exports();
+            lock.lock();
+        }
+    }
+
+public:
+    /* Free the objects of the list `todo` in the background. Return `false` if the reclaimer is
+       shutting down and the caller has to free them itself. */
+    bool enqueue(object * todo) {
+        size_t n = 1;
+        object * last = todo;
+        while (get_next(last) != nullptr) {
+            last = get_next(last);
+            n++;
+        }
+        unique_lock<mutex> lock(m_mutex);
+        if (m_shutting_down)
+            return false;
+        if (!m_thread) {
+            m_thread.reset(new lthread([this]() { run(); }));
+        }
+        set_next(last, m_queue);
+        m_queue = todo;
+        g_deferred_free_backlog += n;
+        m_queue_cv.notify_one();
+        return true;
+    }
+
+    /* Free all pending objects and stop the reclaimer thread. */
+    void shutdown() {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_shutting_down = true;
+            m_queue_cv.notify_one();
+        }
+        if (m_thread)
+            m_thread->join();
+    }
+};
+
+static reclaimer * g_reclaimer = nullptr;
+
+static void lean_del_deferred(object * o, size_t threshold) {
+    // `o` has not been added to a list yet, so its RC still tells whether it is multi-threaded
+    object * todo    = nullptr;
+    object * todo_mt = nullptr;
+    if (!lean_is_st(o)) {
+        push_back(todo_mt, o);
+    } else {
+        push_back(todo, o);
+    }
+    size_t num_freed = 0;
+    while (true) {
+        // single-threaded objects must be freed by this thread
+        if (todo != nullptr) {
+            o = pop_back(todo);
+        } else if (todo_mt != nullptr && num_freed < threshold) {
+            o = pop_back(todo_mt);
+        } else {
+            break;
+        }
+        lean_del_core<true>(o, todo, todo_mt);
+        num_freed++;
+    }
+    if (todo_mt != nullptr && !g_reclaimer->enqueue(todo_mt)) {
+        while (todo_mt != nullptr) {
+            o = pop_back(todo_mt);
+            lean_del_core(o, todo_mt);
+        }
+    }
+}
+
+static void finalize_reclaimer() {
+    g_deferred_free_threshold = 0;
+    if (g_reclaimer)
+        g_reclaimer->shutdown();
+}
+#endif
+
+/* Runtime.setDeferredFreeThreshold (threshold : USize) : BaseIO Unit */
+extern "C" LEAN_EXPORT obj_res lean_runtime_set_deferred_free_threshold(size_t threshold, obj_arg) {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    g_deferred_free_threshold = threshold;
+#endif
+    return io_result_mk_ok(box(0));
+}
+
+/* Runtime.getDeferredFreeBacklog : BaseIO Nat */
+extern "C" LEAN_EXPORT obj_res lean_runtime_get_deferred_free_backlog(obj_arg) {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    return io_result_mk_ok(lean_usize_to_nat(g_deferred_free_backlog));
+#else
+    return io_result_mk_ok(box(0));
+#endif
+}
+
+/* Runtime.getDeferredFreeTotal : BaseIO Nat */
+extern "C" LEAN_EXPORT obj_res lean_runtime_get_deferred_free_total(obj_arg) {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    return io_result_mk_ok(lean_usize_to_nat(g_deferred_free_total));
+#else
+    return io_result_mk_ok(box(0));
+#endif
+}
+
+/* Free `o`, whose RC has dropped to zero, and the objects that become unreachable. */
+static void lean_del(lean_object * o) {
 #ifdef LEAN_LAZY_RC
-        push_back(g_to_free, o);
+    push_back(g_to_free, o);
 #else
-        object * todo = nullptr;
-        while (true) {
-            lean_del_core(o, todo);
-            if (todo == nullptr)
+#if defined(LEAN_MULTI_THREAD)
+    if (size_t threshold = g_deferred_free_threshold.load(std::memory_order_relaxed)) {
+        return lean_del_deferred(o, threshold);
+    }
+#endif
+    object * todo = nullptr;
+    while (true) {
+        lean_del_core(o, todo);
+        if (todo == nullptr)
+            return;
+        o = pop_back(todo);
+    }
+#endif
+}
+
+#ifdef LEAN_BIASED_RC
+static void brc_enqueue(object * o) {
+    {
+        unique_lock<mutex> lock(*g_brc_mutex);
+        /* The owner may have merged the counters after we set `BRC_QUEUED`, in which case `m_owner` is 0 and
+           `brc_merge` only clears the flag. */
+        unsigned owner_id = brc_owner(o)->load(std::memory_order_acquire);
+        if (owner_id != 0) {
+            if (brc_thread * owner = (*g_brc_threads)[owner_id - 1]) {
+                owner->m_queue.push_back(o);
+                owner->m_has_queue.store(true, std::memory_order_release);
                 return;
-            o = pop_back(todo);
+            }
         }
+    }
+    // The counters are merged already, or the owner has terminated, so it does not update the biased counter anymore.
+    if (brc_merge(o))
+        lean_del(o);
+}
+
+/* Merge the objects queued at the current thread. */
+static void brc_process_queue() {
+    std::vector<object *> queue;
+    {
+        unique_lock<mutex> lock(*g_brc_mutex);
+        std::swap(queue, g_brc_thread->m_queue);
+        g_brc_thread->m_has_queue.store(false, std::memory_order_relaxed);
+    }
+    for (object * o : queue) {
+        // skip objects that have been marked persistent since
+        if (!lean_is_persistent(o) && brc_merge(o))
+            lean_del(o);
+    }
+}
+
+static inline void brc_process_queue_if_needed() {
+    if (g_brc_thread && g_brc_thread->m_has_queue.load(std::memory_order_acquire))
+        brc_process_queue();
+}
+
+static void brc_finalize_thread(void *) {
+    std::vector<object *> queue;
+    {
+        unique_lock<mutex> lock(*g_brc_mutex);
+        (*g_brc_threads)[g_brc_thread_id - 1] = nullptr;
+        std::swap(queue, g_brc_thread->m_queue);
+    }
+    delete g_brc_thread;
+    g_brc_thread    = nullptr;
+    // From now on, this thread updates the shared counter of the objects it owned, like any other thread.
+    g_brc_thread_id = 0;
+    for (object * o : queue) {
+        if (!lean_is_persistent(o) && brc_merge(o))
+            lean_del(o);
+    }
+}
+
+/* Register the current thread so that it can own objects. */
+static void brc_init_thread() {
+    if (g_brc_thread_id != 0 || in_thread_finalization())
+        return;
+    g_brc_thread = new brc_thread();
+    {
+        unique_lock<mutex> lock(*g_brc_mutex);
+        g_brc_threads->push_back(g_brc_thread);
+        g_brc_thread_id = g_brc_threads->size();
+    }
+    register_thread_finalizer(brc_finalize_thread, nullptr);
+}
 #endif
+
+extern "C" LEAN_EXPORT void lean_dec_ref_cold(lean_object * o) {
+#ifdef LEAN_BIASED_RC
+    brc_process_queue_if_needed();
+#endif
+    if (o->m_rc == 1 || dec_mt(o)) {
+        lean_del(o);
     }
 }
 
@@ -423,14 +821,13 @@ extern "C" LEAN_EXPORT b_obj_res lean_thunk_get_core(b_obj_arg t) {
         lean_assert(lean_to_thunk(t)->m_value == nullptr);
         mark_mt(r);
         lean_to_thunk(t)->m_value = r;
+        unpark_all(t);
         return r;
     } else {
         lean_assert(c == nullptr);
         /* There is another thread executing the closure. We keep waiting for the m_value to be
            set by another thread. */
-        while (!lean_to_thunk(t)->m_value) {
-            this_thread::yield();
-        }
+        park_until(t, [&]() { return lean_to_thunk(t)->m_value != nullptr; });
         return lean_to_thunk(t)->m_value;
     }
 }
@@ -477,9 +874,12 @@ extern "C" LEAN_EXPORT void lean_mark_persistent(object * o) {
             } else {
                 switch (tag) {
                 case LeanScalarArray:
-                case LeanString:
                 case LeanMPZ:
                     break;
+                case LeanString:
+                    if (lean_string_is_slice(o))
+                        todo.push_back(lean_to_string_slice(o)->m_parent);
+                    break;
                 case LeanExternal: {
                     object * fn = lean_alloc_closure((void*)mark_persistent_fn, 1, 0);
                     lean_to_external(o)->m_class->m_foreach(lean_to_external(o)->m_data, fn);
@@ -517,6 +917,30 @@ extern "C" LEAN_EXPORT void lean_mark_persistent(object * o) {
     }
 }
 
+/* Number of closed terms computed on first access by `lean_closed_term_init`. */
+static std::atomic<size_t> g_lazy_closed_term_inits(0);
+
+extern "C" LEAN_EXPORT object * lean_closed_term_init(object ** slot, object * (*init)(void)) {
+    object * r = init();
+    /* The value is persistent just like an eagerly initialized closed term, so other threads may use it without
+       updating its RC. */
+    lean_mark_persistent(r);
+    object * expected = nullptr;
+    if (reinterpret_cast<atomic<object *> *>(slot)->compare_exchange_strong(expected, r)) {
+        g_lazy_closed_term_inits++;
+        return r;
+    } else {
+        /* Another thread initialized the closed term concurrently. Closed terms are pure, so both values are
+           equivalent, and `r` is simply not used. */
+        return expected;
+    }
+}
+
+/* Runtime.getLazyClosedTermInits : BaseIO Nat */
+extern "C" LEAN_EXPORT obj_res lean_runtime_get_lazy_closed_term_inits(obj_arg) {
+    return io_result_mk_ok(lean_usize_to_nat(g_lazy_closed_term_inits));
+}
+
 // =======================================
 // Mark MT
 
@@ -528,62 +952,76 @@ static obj_res mark_mt_fn(obj_arg o) {
     return lean_box(0);
 }
 
+/*
+Marking only visits single-threaded objects: the traversal stops at objects that are already
+multi-threaded or persistent, whose object graphs are multi-threaded or persistent as well. So the
+cost of publishing a value to another thread is proportional to the objects that have become
+reachable from it since it (or parts of it) were last published, and capturing the same structure
+in many tasks marks it only once. Each object is marked when it is first reached, which keeps
+shared subobjects of a DAG from being pushed onto the stack more than once.
+*/
+static inline void mark_mt_child(object * o, buffer<object*> & todo) {
+    if (!lean_is_scalar(o) && lean_is_st(o)) {
+        mark_mt_rc(o);
+        todo.push_back(o);
+    }
+}
+
+static inline void mark_mt_children(object ** it, object ** end, buffer<object*> & todo) {
+    for (; it != end; ++it) mark_mt_child(*it, todo);
+}
+
 extern "C" LEAN_EXPORT void lean_mark_mt(object * o) {
 #ifndef LEAN_MULTI_THREAD
     return;
 #endif
     if (lean_is_scalar(o) || !lean_is_st(o)) return;
+#ifdef LEAN_BIASED_RC
+    brc_init_thread();
+#endif
 
     buffer<object*> todo;
-    todo.push_back(o);
+    mark_mt_child(o, todo);
     while (!todo.empty()) {
         object * o = todo.back();
         todo.pop_back();
-        if (!lean_is_scalar(o) && lean_is_st(o)) {
-            o->m_rc = -o->m_rc;
-            uint8_t tag = lean_ptr_tag(o);
-            if (tag <= LeanMaxCtorTag) {
-                object ** it  = lean_ctor_obj_cptr(o);
-                object ** end = it + lean_ctor_num_objs(o);
-                for (; it != end; ++it) todo.push_back(*it);
-            } else {
-                switch (tag) {
-                case LeanScalarArray:
-                case LeanString:
-                case LeanMPZ:
-                    break;
-                case LeanExternal: {
-                    object * fn = lean_alloc_closure((void*)mark_mt_fn, 1, 0);
-                    lean_to_external(o)->m_class->m_foreach(lean_to_external(o)->m_data, fn);
-                    lean_dec(fn);
-                    break;
-                }
-                case LeanTask:
-                    todo.push_back(lean_task_get(o));
-                    break;
-                case LeanClosure: {
-                    object ** it  = lean_closure_arg_cptr(o);
-                    object ** end = it + lean_closure_num_fixed(o);
-                    for (; it != end; ++it) todo.push_back(*it);
-                    break;
-                }
-                case LeanArray: {
-                    object ** it  = lean_array_cptr(o);
-                    object ** end = it + lean_array_size(o);
-                    for (; it != end; ++it) todo.push_back(*it);
-                    break;
-                }
-                case LeanThunk:
-                    if (object * c = lean_to_thunk(o)->m_closure) todo.push_back(c);
-                    if (object * v = lean_to_thunk(o)->m_value) todo.push_back(v);
-                    break;
-                case LeanRef:
-                    if (object * v = lean_to_ref(o)->m_value) todo.push_back(v);
-                    break;
-                default:
-                    lean_unreachable();
-                    break;
-                }
+        uint8_t tag = lean_ptr_tag(o);
+        if (tag <= LeanMaxCtorTag) {
+            mark_mt_children(lean_ctor_obj_cptr(o), lean_ctor_obj_cptr(o) + lean_ctor_num_objs(o), todo);
+        } else {
+            switch (tag) {
+            case LeanScalarArray:
+            case LeanMPZ:
+                break;
+            case LeanString:
+                if (lean_string_is_slice(o))
+                    mark_mt_child(lean_to_string_slice(o)->m_parent, todo);
+                break;
+            case LeanExternal: {
+                object * fn = lean_alloc_closure((void*)mark_mt_fn, 1, 0);
+                lean_to_external(o)->m_class->m_foreach(lean_to_external(o)->m_data, fn);
+                lean_dec(fn);
+                break;
+            }
+            case LeanTask:
+                mark_mt_child(lean_task_get(o), todo);
+                break;
+            case LeanClosure:
+                mark_mt_children(lean_closure_arg_cptr(o), lean_closure_arg_cptr(o) + lean_closure_num_fixed(o), todo);
+                break;
+            case LeanArray:
+                mark_mt_children(lean_array_cptr(o), lean_array_cptr(o) + lean_array_size(o), todo);
+                break;
+            case LeanThunk:
+                if (object * c = lean_to_thunk(o)->m_closure) mark_mt_child(c, todo);
+                if (object * v = lean_to_thunk(o)->m_value) mark_mt_child(v, todo);
+                break;
+            case LeanRef:
+                if (object * v = lean_to_ref(o)->m_value) mark_mt_child(v, todo);
+                break;
+            default:
+                lean_unreachable();
+                break;
             }
         }
     }
@@ -710,6 +1148,13 @@ class task_manager {
                 run_task(lock, t);
                 m_idle_std_workers++;
                 reset_heartbeat();
+#ifdef LEAN_BIASED_RC
+                if (g_brc_thread && g_brc_thread->m_has_queue.load(std::memory_order_acquire)) {
+                    lock.unlock();
+                    brc_process_queue();
+                    lock.lock();
+                }
+#endif
             }
             m_idle_std_workers--;
         }));
@@ -939,6 +1384,9 @@ extern "C" LEAN_EXPORT void lean_init_task_manager() {
 }
 
 extern "C" LEAN_EXPORT void lean_finalize_task_manager() {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    finalize_reclaimer();
+#endif
     if (g_task_manager) {
         delete g_task_manager;
         g_task_manager = nullptr;
@@ -955,6 +1403,9 @@ scoped_task_manager::scoped_task_manager(unsigned num_workers) {
 }
 
 scoped_task_manager::~scoped_task_manager() {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    finalize_reclaimer();
+#endif
     if (g_task_manager) {
         delete g_task_manager;
         g_task_manager = nullptr;
@@ -976,6 +1427,10 @@ static inline void lean_set_task_header(lean_object * o) {
     o->m_tag      = LeanTask;
     o->m_other    = 0;
     o->m_cs_sz    = 0;
+#ifdef LEAN_BIASED_RC
+    o->m_owner     = 0;
+    o->m_shared_rc = BRC_ONE + BRC_MERGED;
+#endif
 }
 
 static lean_task_object * alloc_task(obj_arg c, unsigned prio, bool keep_alive) {
@@ -1732,16 +2187,30 @@ extern "C" LEAN_EXPORT uint32_t lean_float32_to_bits(float d)
 // =======================================
 // Strings
 
-static inline char * w_string_cstr(object * o) { lean_assert(lean_is_string(o)); return lean_to_string(o)->m_data; }
+/* Extracting a suffix of at least this many bytes creates a slice instead of a copy. */
+static const size_t LEAN_MIN_STRING_SLICE_SIZE = 256;
+/* Maximal number of bytes of its parent that a slice keeps alive without using them. */
+static const size_t LEAN_MAX_STRING_SLICE_WASTE = 64 * 1024;
 
+static inline char * w_string_cstr(object * o) { return const_cast<char *>(lean_string_cstr(o)); }
+
+/* Return whether the characters of `o` can be updated in place, i.e., it is exclusive and not a slice. */
+static inline bool string_is_writable(object * o) {
+    return lean_is_exclusive(o) && !lean_string_is_slice(o);
+}
+
+/* Ensure that the exclusive string `o` has room for `extra` more bytes. The result uses the general layout,
+   so its size and length can be updated in place. */
 static object * string_ensure_capacity(object * o, size_t extra) {
     lean_assert(is_exclusive(o));
     size_t sz  = string_size(o);
     size_t cap = string_capacity(o);
-    if (sz + extra > cap) {
+    if (sz + extra > cap || lean_ptr_other(o) != 0) {
         object * new_o = alloc_string(sz, cap + sz + extra, string_len(o));
         lean_assert(string_capacity(new_o) >= sz + extra);
         memcpy(w_string_cstr(new_o), string_cstr(o), sz);
+        if (lean_string_is_slice(o))
+            lean_dec(lean_to_string_slice(o)->m_parent);
         lean_dealloc(o, lean_string_byte_size(o));
         return new_o;
     } else {
@@ -2118,6 +2587,37 @@ extern "C" LEAN_EXPORT uint8 lean_string_is_valid_pos(b_obj_arg s, b_obj_arg i0)
     return is_utf8_first_byte(str[i]);
 }
 
+/* Return the suffix of `s` starting at byte `b`, sharing the data of `s` or of its parent, or a copy of the suffix
+   if the slice would keep alive a parent that is more than 4 times larger, or more than
+   `LEAN_MAX_STRING_SLICE_WASTE` bytes of the parent that it does not use. Slices of slices reference the original
+   parent, so the bytes of a string are never reached through more than one indirection. Recall that suffixes
+   are '\0'-terminated, so slices are transparent to `lean_string_cstr` users.
+
+   Slices are restricted to suffixes so that `lean_string_cstr` can keep returning a '\0'-terminated buffer without a
+   flattening step. This covers the loops that repeatedly drop a prefix, e.g. a tokenizer that extracts the rest of
+   the input after each token, which copy O(n) bytes per step otherwise. With the bound on the unused bytes, such a
+   loop copies the rest of the input once per `LEAN_MAX_STRING_SLICE_WASTE` bytes consumed instead. Other ranges are
+   copied, which costs as much as the extracted piece itself. */
+static obj_res string_slice_suffix(b_obj_arg s, usize b) {
+    object * parent   = s;
+    char const * data = lean_string_cstr(s) + b;
+    if (lean_string_is_slice(s))
+        parent = lean_to_string_slice(s)->m_parent;
+    usize sz    = lean_string_size(s) - b;
+    usize waste = lean_string_size(parent) - sz;
+    if (waste > 3 * sz || waste > LEAN_MAX_STRING_SLICE_WASTE)
+        return lean_mk_string_from_bytes_unchecked(data, sz - 1);
+    lean_string_slice_object * r = (lean_string_slice_object*)lean_alloc_object(sizeof(lean_string_slice_object));
+    lean_set_st_header((lean_object*)r, LeanString, 2);
+    r->m_size     = sz;
+    r->m_capacity = sz;
+    r->m_length   = utf8_strlen(data, sz - 1);
+    r->m_parent   = parent;
+    r->m_data     = data;
+    lean_inc(parent);
+    return (lean_object*)r;
+}
+
 extern "C" LEAN_EXPORT obj_res lean_string_utf8_extract(b_obj_arg s, b_obj_arg b0, b_obj_arg e0) {
     if (!lean_is_scalar(b0) || !lean_is_scalar(e0)) {
         /* See comment at string_utf8_get */
@@ -2137,8 +2637,15 @@ extern "C" LEAN_EXPORT obj_res lean_string_utf8_extract(b_obj_arg s, b_obj_arg b
     /* In the reference implementation if `e` is not pointing to a valid UTF8
        character start position, it is assumed to be at the end. */
     if (e < sz && !is_utf8_first_byte(str[e])) e = sz;
+    if (b == 0 && e == sz) {
+        /* Strings are immutable values, so extracting the whole string can share `s`. */
+        lean_inc(s);
+        return s;
+    }
     usize new_sz = e - b;
     lean_assert(new_sz > 0);
+    if (e == sz && new_sz >= LEAN_MIN_STRING_SLICE_SIZE)
+        return string_slice_suffix(s, b);
     return lean_mk_string_from_bytes_unchecked(lean_string_cstr(s) + b, new_sz);
 }
 
@@ -2176,7 +2683,7 @@ extern "C" LEAN_EXPORT obj_res lean_string_utf8_set(obj_arg s, b_obj_arg i0, uin
     usize sz = lean_string_size(s) - 1;
     if (i >= sz) return s;
     char * str = w_string_cstr(s);
-    if (lean_is_exclusive(s)) {
+    if (string_is_writable(s)) {
         if (static_cast<unsigned char>(str[i]) < 128 && c < 128) {
             str[i] = c;
             return s;
@@ -2200,6 +2707,12 @@ extern "C" LEAN_EXPORT uint64 lean_string_hash(b_obj_arg s) {
     return hash_str(sz, (unsigned char const *) str, 11);
 }
 
+extern "C" LEAN_EXPORT uint64 lean_string_fast_hash(b_obj_arg s) {
+    usize sz = lean_string_size(s) - 1;
+    char const * str = lean_string_cstr(s);
+    return hash_bytes(sz, (unsigned char const *) str, 11);
+}
+
 extern "C" LEAN_EXPORT obj_res lean_string_of_usize(size_t n) {
     return mk_ascii_string_unchecked(std::to_string(n));
 }
@@ -2289,7 +2802,9 @@ extern "C" LEAN_EXPORT obj_res lean_byte_array_push(obj_arg a, uint8 b) {
     return r;
 }
 
-    extern "C" LEAN_EXPORT obj_res lean_byte_array_copy_slice(b_obj_arg src, obj_arg o_src_off, obj_arg dest, obj_arg o_dest_off, obj_arg o_len, bool exact) {
+/* Copy the elements `[src_off, src_off + len)` of `src` to `[dest_off, dest_off + len)` of `dest`, growing `dest` if necessary. */
+extern "C" LEAN_EXPORT obj_res lean_sarray_copy_slice(b_obj_arg src, obj_arg o_src_off, obj_arg dest, obj_arg o_dest_off, obj_arg o_len, bool exact) {
+    size_t esz = lean_sarray_elem_size(src);
     size_t ssz = lean_sarray_size(src);
     size_t dsz = lean_sarray_size(dest);
     size_t src_off = lean_nat_to_size_t(o_src_off);
@@ -2305,14 +2820,22 @@ extern "C" LEAN_EXPORT obj_res lean_byte_array_push(obj_arg a, uint8 b) {
     object * r = lean_sarray_ensure_exclusive(lean_sarray_ensure_capacity(dest, new_dsz, exact));
     lean_to_sarray(r)->m_size = new_dsz;
     // `r` is exclusive, so the ranges definitely cannot overlap
-    memcpy(lean_sarray_cptr(r) + dest_off, lean_sarray_cptr(src) + src_off, len);
+    memcpy(lean_sarray_cptr(r) + dest_off * esz, lean_sarray_cptr(src) + src_off * esz, len * esz);
     return r;
 }
 
+extern "C" LEAN_EXPORT obj_res lean_byte_array_copy_slice(b_obj_arg src, obj_arg o_src_off, obj_arg dest, obj_arg o_dest_off, obj_arg o_len, bool exact) {
+    return lean_sarray_copy_slice(src, o_src_off, dest, o_dest_off, o_len, exact);
+}
+
 extern "C" LEAN_EXPORT uint64_t lean_byte_array_hash(b_obj_arg a) {
     return hash_str(lean_sarray_size(a), lean_sarray_cptr(a), 11);
 }
 
+extern "C" LEAN_EXPORT uint64_t lean_byte_array_fast_hash(b_obj_arg a) {
+    return hash_bytes(lean_sarray_size(a), lean_sarray_cptr(a), 11);
+}
+
 extern "C" LEAN_EXPORT obj_res lean_copy_float_array(obj_arg a) {
     return lean_copy_sarray(a, lean_sarray_capacity(a));
 }
@@ -2352,6 +2875,123 @@ extern "C" LEAN_EXPORT obj_res lean_float_array_push(obj_arg a, double d) {
     return r;
 }
 
+// =======================================
+// Typed scalar arrays
+
+/* The conversions between typed scalar arrays and `ByteArray` use little-endian order on all platforms, as their
+   reference implementations do. Reverse the bytes of each element of size `esz` on big-endian platforms. */
+static inline void sarray_swap_to_little_endian(uint8 * p, size_t n, unsigned esz) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i + esz <= n; i += esz)
+        std::reverse(p + i, p + i + esz);
+#else
+    (void)p; (void)n; (void)esz;
+#endif
+}
+
+extern "C" LEAN_EXPORT obj_res lean_sarray_to_byte_array(b_obj_arg a) {
+    unsigned esz = lean_sarray_elem_size(a);
+    size_t sz = esz * lean_sarray_size(a);
+    obj_res r = lean_alloc_sarray(1, sz, sz);
+    memcpy(lean_sarray_cptr(r), lean_sarray_cptr(a), sz);
+    sarray_swap_to_little_endian(lean_sarray_cptr(r), sz, esz);
+    return r;
+}
+
+/* Reinterpret the bytes of `a` as elements of size `esz`, ignoring trailing bytes that do not form an element. */
+extern "C" LEAN_EXPORT obj_res lean_sarray_of_byte_array(b_obj_arg a, unsigned esz) {
+    size_t sz = lean_sarray_size(a) / esz;
+    obj_res r = lean_alloc_sarray(esz, sz, sz);
+    memcpy(lean_sarray_cptr(r), lean_sarray_cptr(a), sz * esz);
+    sarray_swap_to_little_endian(lean_sarray_cptr(r), sz * esz, esz);
+    return r;
+}
+
+template<typename T, typename U>
+static obj_res sarray_of_array(obj_arg a, U unbox) {
+    usize sz      = lean_array_size(a);
+    obj_res r     = lean_alloc_sarray(sizeof(T), sz, sz);
+    object ** it  = lean_array_cptr(a);
+    object ** end = it + sz;
+    T * dest      = reinterpret_cast<T*>(lean_sarray_cptr(r));
+    for (; it != end; ++it, ++dest) {
+        *dest = unbox(*it);
+    }
+    lean_dec(a);
+    return r;
+}
+
+template<typename T, typename B>
+static obj_res sarray_to_array(obj_arg a, B box) {
+    usize sz       = lean_sarray_size(a);
+    obj_res r      = lean_alloc_array(sz, sz);
+    T * it         = reinterpret_cast<T*>(lean_sarray_cptr(a));
+    T * end        = it + sz;
+    object ** dest = lean_array_cptr(r);
+    for (; it != end; ++it, ++dest) {
+        *dest = box(*it);
+    }
+    lean_dec(a);
+    return r;
+}
+
+template<typename T>
+static obj_res sarray_push(obj_arg a, T v) {
+    object * r = lean_sarray_ensure_exclusive(lean_sarray_ensure_capacity(a, lean_sarray_size(a) + 1, /* exact */ false));
+    size_t & sz = lean_to_sarray(r)->m_size;
+    reinterpret_cast<T*>(lean_sarray_cptr(r))[sz] = v;
+    sz++;
+    return r;
+}
+
+template<typename T>
+static obj_res sarray_replicate(b_obj_arg n, T v) {
+    if (!lean_is_scalar(n)) lean_internal_panic_out_of_memory();
+    size_t sz = lean_unbox(n);
+    obj_res r = lean_alloc_sarray(sizeof(T), sz, sz);
+    std::fill_n(reinterpret_cast<T*>(lean_sarray_cptr(r)), sz, v);
+    return r;
+}
+
+template<typename T>
+static obj_res sarray_fill(obj_arg a, b_obj_arg start, b_obj_arg stop, T v) {
+    size_t sz = lean_sarray_size(a);
+    size_t b  = lean_is_scalar(start) ? std::min(lean_unbox(start), sz) : sz;
+    size_t e  = lean_is_scalar(stop) ? std::min(lean_unbox(stop), sz) : sz;
+    if (b >= e)
+        return a;
+    object * r = lean_sarray_ensure_exclusive(a);
+    T * data = reinterpret_cast<T*>(lean_sarray_cptr(r));
+    std::fill(data + b, data + e, v);
+    return r;
+}
+
+/* Definitions of the non-inline primitives declared by `LEAN_SCALAR_ARRAY_API` in `lean.h`. */
+#define LEAN_SCALAR_ARRAY_IMPL(name, T) \
+extern "C" LEAN_EXPORT obj_res lean_##name##_array_mk(obj_arg a) { \
+    return sarray_of_array<T>(a, lean_unbox_##name); \
+} \
+\
+extern "C" LEAN_EXPORT obj_res lean_##name##_array_data(obj_arg a) { \
+    return sarray_to_array<T>(a, lean_box_##name); \
+} \
+\
+extern "C" LEAN_EXPORT obj_res lean_##name##_array_push(obj_arg a, T v) { \
+    return sarray_push(a, v); \
+} \
+\
+extern "C" LEAN_EXPORT obj_res lean_##name##_array_replicate(b_obj_arg n, T v) { \
+    return sarray_replicate(n, v); \
+} \
+\
+extern "C" LEAN_EXPORT obj_res lean_##name##_array_fill(obj_arg a, b_obj_arg start, b_obj_arg stop, T v) { \
+    return sarray_fill(a, start, stop, v); \
+}
+
+LEAN_SCALAR_ARRAY_IMPL(uint32, uint32)
+LEAN_SCALAR_ARRAY_IMPL(uint64, uint64)
+LEAN_SCALAR_ARRAY_IMPL(float32, float)
+
 // =======================================
 // Array functions for generated code
 
@@ -2514,6 +3154,13 @@ extern "C" LEAN_EXPORT lean_external_class * lean_register_external_class(lean_e
 }
 
 void initialize_object() {
+#if defined(LEAN_MULTI_THREAD) && !defined(LEAN_LAZY_RC)
+    g_reclaimer         = new reclaimer();
+#endif
+#ifdef LEAN_BIASED_RC
+    g_brc_mutex         = new mutex();
+    g_brc_threads       = new std::vector<brc_thread *>();
+#endif
     g_ext_classes       = new std::vector<external_object_class*>();
     g_ext_classes_mutex = new mutex();
     g_array_empty       = lean_alloc_array(0, 0);
@@ -25,6 +25,25 @@ Author: Jared Roesch
 #include <sys/wait.h>
 #include <signal.h>
 #include <limits.h> // NOLINT
+#include <spawn.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#endif
+
+#if !defined(LEAN_WINDOWS) && !defined(LEAN_EMSCRIPTEN)
+#define LEAN_POSIX_SPAWN
+// `posix_spawn_file_actions_addchdir_np` is available since glibc 2.29 and macOS 10.15
+#if (defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))) || \
+    (defined(__APPLE__) && defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 101500)
+#define LEAN_POSIX_SPAWN_CHDIR
+#endif
+#if defined(__APPLE__)
+#include <crt_externs.h>
+#define environ (*_NSGetEnviron())
+#else
+extern char ** environ;
+#endif
 #endif
 
 #ifdef __linux
@@ -412,72 +431,213 @@ static optional<pipe> setup_stdio(stdio cfg) {
     lean_unreachable();
 }
 
-static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const & args, stdio stdin_mode, stdio stdout_mode,
-  stdio stderr_mode, option_ref<string_ref> const & cwd, array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env,
-  bool do_setsid) {
-    /* Setup stdio based on process configuration. */
-    auto stdin_pipe  = setup_stdio(stdin_mode);
-    auto stdout_pipe = setup_stdio(stdout_mode);
-    auto stderr_pipe = setup_stdio(stderr_mode);
+// Sets up the child after `fork` and executes the process, does not return.
+[[noreturn]] static void exec_forked_child(string_ref const & proc_name, array_ref<string_ref> const & args,
+  stdio stdin_mode, stdio stdout_mode, stdio stderr_mode, optional<pipe> const & stdin_pipe,
+  optional<pipe> const & stdout_pipe, optional<pipe> const & stderr_pipe, option_ref<string_ref> const & cwd,
+  array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env, bool do_setsid) {
+    for (auto & entry : env) {
+        if (entry.snd()) {
+            setenv(entry.fst().data(), entry.snd().get()->data(), true);
+        } else {
+            unsetenv(entry.fst().data());
+        }
+    }
 
-    int pid = fork();
+    if (stdin_pipe) {
+        dup2(stdin_pipe->m_read_fd, STDIN_FILENO);
+        close(stdin_pipe->m_write_fd);
+    } else if (stdin_mode == stdio::NUL) {
+        int fd = open("/dev/null", O_RDONLY);
+        dup2(fd, STDIN_FILENO);
+    }
 
-    if (pid == 0) {
-        for (auto & entry : env) {
-            if (entry.snd()) {
-                setenv(entry.fst().data(), entry.snd().get()->data(), true);
-            } else {
-                unsetenv(entry.fst().data());
-            }
-        }
+    if (stdout_pipe) {
+        dup2(stdout_pipe->m_write_fd, STDOUT_FILENO);
+        close(stdout_pipe->m_read_fd);
+    } else if (stdout_mode == stdio::NUL) {
+        int fd = open("/dev/null", O_WRONLY);
+        dup2(fd, STDOUT_FILENO);
+    }
 
-        if (stdin_pipe) {
-            dup2(stdin_pipe->m_read_fd, STDIN_FILENO);
-            close(stdin_pipe->m_write_fd);
-        } else if (stdin_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_RDONLY);
-            dup2(fd, STDIN_FILENO);
-        }
+    if (stderr_pipe) {
+        dup2(stderr_pipe->m_write_fd, STDERR_FILENO);
+        close(stderr_pipe->m_read_fd);
+    } else if (stderr_mode == stdio::NUL) {
+        int fd = open("/dev/null", O_WRONLY);
+        dup2(fd, STDERR_FILENO);
+    }
 
-        if (stdout_pipe) {
-            dup2(stdout_pipe->m_write_fd, STDOUT_FILENO);
-            close(stdout_pipe->m_read_fd);
-        } else if (stdout_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_WRONLY);
-            dup2(fd, STDOUT_FILENO);
+    if (cwd) {
+        if (chdir(cwd.get()->data()) < 0) {
+            std::cerr << "could not change directory to " << cwd.get()->data() << std::endl;
+            exit(-1);
         }
+    }
 
-        if (stderr_pipe) {
-            dup2(stderr_pipe->m_write_fd, STDERR_FILENO);
-            close(stderr_pipe->m_read_fd);
-        } else if (stderr_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_WRONLY);
-            dup2(fd, STDERR_FILENO);
-        }
+    if (do_setsid) {
+        lean_always_assert(setsid() >= 0);
+    }
 
-        if (cwd) {
-            if (chdir(cwd.get()->data()) < 0) {
-                std::cerr << "could not change directory to " << cwd.get()->data() << std::endl;
-                exit(-1);
-            }
+    buffer<char *> pargs;
+    pargs.push_back(strdup(proc_name.data()));
+    for (auto & arg : args)
+        pargs.push_back(strdup(arg.data()));
+    pargs.push_back(NULL);
+
+    execvp(pargs[0], pargs.data());
+    std::cerr << "could not execute external process '" << pargs[0] << "'" << std::endl;
+    exit(-1);
+}
+
+#if defined(LEAN_POSIX_SPAWN)
+/*
+`fork` has to copy the page tables of the parent, which takes milliseconds for a process with a
+large heap or many mapped .olean files, and may fail under strict overcommit accounting. `posix_spawn`
+is implemented with `vfork`-like semantics (`clone(CLONE_VM | CLONE_VFORK)` on glibc) and does not
+have these problems, so we use it whenever it can express the requested configuration.
+*/
+
+// Whether `posix_spawn` can start the process with the same behavior as `exec_forked_child`.
+static bool can_posix_spawn(option_ref<string_ref> const & cwd,
+  array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env, bool do_setsid) {
+#if !defined(LEAN_POSIX_SPAWN_CHDIR)
+    if (cwd) return false;
+#endif
+#if !defined(POSIX_SPAWN_SETSID)
+    if (do_setsid) return false;
+#endif
+    // `posix_spawnp` looks up the executable in the `PATH` of the parent, `execvp` in the child uses
+    // the modified environment.
+    for (auto & entry : env) {
+        if (strcmp(entry.fst().data(), "PATH") == 0) return false;
+    }
+    return true;
+}
+
+// The environment of the child, `environ` updated with `env`.
+static std::vector<std::string> child_environment(array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env) {
+    std::vector<std::string> vars;
+    for (char ** e = environ; *e != nullptr; e++) {
+        vars.push_back(*e);
+    }
+    for (auto & entry : env) {
+        std::string prefix = std::string(entry.fst().data()) + "=";
+        vars.erase(std::remove_if(vars.begin(), vars.end(), [&](std::string const & var) {
+            return var.compare(0, prefix.size(), prefix) == 0;
+        }), vars.end());
+        if (entry.snd()) {
+            vars.push_back(prefix + entry.snd().get()->data());
         }
+    }
+    return vars;
+}
 
-        if (do_setsid) {
-            lean_always_assert(setsid() >= 0);
+// Starts the process with `posix_spawnp`, returns 0 and sets `pid` or returns an error code.
+static int posix_spawn_child(pid_t & pid, string_ref const & proc_name, array_ref<string_ref> const & args,
+  stdio stdin_mode, stdio stdout_mode, stdio stderr_mode, optional<pipe> const & stdin_pipe,
+  optional<pipe> const & stdout_pipe, optional<pipe> const & stderr_pipe, option_ref<string_ref> const & cwd,
+  array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env, bool do_setsid) {
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    if (int err = posix_spawn_file_actions_init(&actions)) return err;
+    if (int err = posix_spawnattr_init(&attr)) {
+        posix_spawn_file_actions_destroy(&actions);
+        return err;
+    }
+
+    // The pipe ends are `O_CLOEXEC`, `dup2` clears the flag on the standard streams only.
+    int err = 0;
+    auto setup = [&](optional<pipe> const & p, stdio mode, int fd, bool read) {
+        if (err) return;
+        if (p) {
+            err = posix_spawn_file_actions_adddup2(&actions, read ? p->m_read_fd : p->m_write_fd, fd);
+        } else if (mode == stdio::NUL) {
+            err = posix_spawn_file_actions_addopen(&actions, fd, "/dev/null", read ? O_RDONLY : O_WRONLY, 0);
         }
+    };
+    setup(stdin_pipe, stdin_mode, STDIN_FILENO, true);
+    setup(stdout_pipe, stdout_mode, STDOUT_FILENO, false);
+    setup(stderr_pipe, stderr_mode, STDERR_FILENO, false);
+#if defined(LEAN_POSIX_SPAWN_CHDIR)
+    if (!err && cwd) {
+        err = posix_spawn_file_actions_addchdir_np(&actions, cwd.get()->data());
+    }
+#endif
+#if defined(POSIX_SPAWN_SETSID)
+    if (!err && do_setsid) {
+        err = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+    }
+#endif
 
-        buffer<char *> pargs;
-        pargs.push_back(strdup(proc_name.data()));
+    if (!err) {
+        std::vector<char *> pargs;
+        pargs.push_back(const_cast<char *>(proc_name.data()));
         for (auto & arg : args)
-            pargs.push_back(strdup(arg.data()));
-        pargs.push_back(NULL);
+            pargs.push_back(const_cast<char *>(arg.data()));
+        pargs.push_back(nullptr);
+
+        char ** envp = environ;
+        std::vector<std::string> vars;
+        std::vector<char *> penv;
+        if (env.size() > 0) {
+            vars = child_environment(env);
+            for (auto & var : vars)
+                penv.push_back(const_cast<char *>(var.c_str()));
+            penv.push_back(nullptr);
+            envp = penv.data();
+        }
 
-        if (execvp(pargs[0], pargs.data()) < 0) {
-            std::cerr << "could not execute external process '" << pargs[0] << "'" << std::endl;
-            exit(-1);
+        err = posix_spawnp(&pid, pargs[0], &actions, &attr, pargs.data(), envp);
+    }
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    return err;
+}
+#endif
+
+static void close_pipe(optional<pipe> const & p) {
+    if (p) {
+        close(p->m_read_fd);
+        close(p->m_write_fd);
+    }
+}
+
+static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const & args, stdio stdin_mode, stdio stdout_mode,
+  stdio stderr_mode, option_ref<string_ref> const & cwd, array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env,
+  bool do_setsid) {
+    /* Setup stdio based on process configuration. */
+    auto stdin_pipe  = setup_stdio(stdin_mode);
+    auto stdout_pipe = setup_stdio(stdout_mode);
+    auto stderr_pipe = setup_stdio(stderr_mode);
+
+    pid_t pid;
+#if defined(LEAN_POSIX_SPAWN)
+    if (can_posix_spawn(cwd, env, do_setsid)) {
+        int err = posix_spawn_child(pid, proc_name, args, stdin_mode, stdout_mode, stderr_mode,
+                                    stdin_pipe, stdout_pipe, stderr_pipe, cwd, env, do_setsid);
+        if (err != 0) {
+            close_pipe(stdin_pipe);
+            close_pipe(stdout_pipe);
+            close_pipe(stderr_pipe);
+            return lean_io_result_mk_error(decode_io_error(err, proc_name.raw()));
+        }
+    } else
+#endif
+    {
+        pid = fork();
+
+        if (pid == 0) {
+            exec_forked_child(proc_name, args, stdin_mode, stdout_mode, stderr_mode,
+                              stdin_pipe, stdout_pipe, stderr_pipe, cwd, env, do_setsid);
+        } else if (pid == -1) {
+            int err = errno;
+            close_pipe(stdin_pipe);
+            close_pipe(stdout_pipe);
+            close_pipe(stderr_pipe);
+            throw err;
         }
-    } else if (pid == -1) {
-        throw errno;
     }
 
     object * parent_stdin  = box(0);
@@ -0,0 +1,633 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "runtime/object.h"
+#include "runtime/debug.h"
+
+/*
+Relaxed radix balanced vectors (RRB vectors), see "RRB-Trees: Efficient Immutable Vectors" by Bagwell and Rompf,
+and "Improving RRB-Tree Performance through Transience" by L'orange.
+
+A vector is a constructor object with the fields `root` and `tail`, and the scalar fields `size` and `shift`.
+`tail` is an `Array` storing the last (at most `RRB_BRANCHING`) elements, and `root` is a tree storing the others.
+Leaves of the tree are `Array`s of at most `RRB_BRANCHING` elements. Internal nodes are constructor objects whose
+fields are their children, and whose scalar area stores the cumulative number of elements stored in the children.
+The children of a node with shift `s` store at most `1 << s` elements each, and leaves have shift `0`.
+As concatenation and slicing produce children that are not full, the slot containing index `i` is found by scanning
+the size table starting at `i >> s`, the slot that would contain `i` in a full tree.
+
+As for arrays, all updates take ownership of the vector and modify the nodes in place when they are not shared.
+So, a sequence of updates on an unshared vector only copies the nodes that are shared with other vectors,
+and only once.
+*/
+namespace lean {
+static const unsigned RRB_BITS      = 5;
+static const unsigned RRB_BRANCHING = 1u << RRB_BITS;
+/* Parameters of the concatenation plan, see `rebalance`: a node is not redistributed if it has at least
+   `RRB_BRANCHING - RRB_INVARIANT` slots, and a concatenation may leave up to `RRB_EXTRAS` more nodes than
+   the optimal number. */
+static const unsigned RRB_INVARIANT = 1;
+static const unsigned RRB_EXTRAS    = 2;
+
+static inline b_obj_res vec_root(b_obj_arg v) { return lean_ctor_get(v, 0); }
+static inline b_obj_res vec_tail(b_obj_arg v) { return lean_ctor_get(v, 1); }
+static inline size_t vec_size(b_obj_arg v) { return lean_ctor_get_usize(v, 2); }
+static inline unsigned vec_shift(b_obj_arg v) { return lean_ctor_get_usize(v, 3); }
+static inline size_t vec_tail_offset(b_obj_arg v) { return vec_size(v) - lean_array_size(vec_tail(v)); }
+
+static obj_res mk_vec(obj_arg root, obj_arg tail, size_t size, unsigned shift) {
+    object * v = lean_alloc_ctor(0, 2, 2 * sizeof(size_t));
+    lean_ctor_set(v, 0, root);
+    lean_ctor_set(v, 1, tail);
+    lean_ctor_set_usize(v, 2, size);
+    lean_ctor_set_usize(v, 3, shift);
+    return v;
+}
+
+static inline obj_res mk_empty_tail() { return lean_alloc_array(0, RRB_BRANCHING); }
+
+static obj_res mk_empty_vec() { return mk_vec(lean_alloc_array(0, 0), mk_empty_tail(), 0, 0); }
+
+static obj_res ensure_exclusive_vec(obj_arg v) {
+    if (lean_is_exclusive(v))
+        return v;
+    lean_inc(vec_root(v));
+    lean_inc(vec_tail(v));
+    object * r = mk_vec(vec_root(v), vec_tail(v), vec_size(v), vec_shift(v));
+    lean_dec_ref(v);
+    return r;
+}
+
+static inline unsigned node_num(b_obj_arg n) { return lean_ctor_num_objs(n); }
+static inline b_obj_res node_child(b_obj_arg n, unsigned i) { return lean_ctor_get(n, i); }
+static inline size_t * node_sizes(b_obj_arg n) { return reinterpret_cast<size_t *>(lean_ctor_scalar_cptr(n)); }
+
+/* Number of elements stored in the tree `t`. */
+static inline size_t tree_size(b_obj_arg t, unsigned shift) {
+    return shift == 0 ? lean_array_size(t) : node_sizes(t)[node_num(t) - 1];
+}
+
+/* Number of elements of a leaf, or number of children of an internal node. */
+static inline unsigned tree_slots(b_obj_arg t, unsigned shift) {
+    return shift == 0 ? lean_array_size(t) : node_num(t);
+}
+
+/* Create a node with shift `shift` from the `n` children `cs`. */
+static obj_res mk_node(object * const * cs, unsigned n, unsigned shift) {
+    lean_assert(0 < n && n <= RRB_BRANCHING);
+    object * r = lean_alloc_ctor(0, n, n * sizeof(size_t));
+    size_t * sizes = node_sizes(r);
+    size_t sz = 0;
+    for (unsigned i = 0; i < n; i++) {
+        lean_ctor_set(r, i, cs[i]);
+        sz += tree_size(cs[i], shift - RRB_BITS);
+        sizes[i] = sz;
+    }
+    return r;
+}
+
+static obj_res ensure_exclusive_node(obj_arg n) {
+    if (lean_is_exclusive(n))
+        return n;
+    unsigned num = node_num(n);
+    object * r = lean_alloc_ctor(0, num, num * sizeof(size_t));
+    for (unsigned i = 0; i < num; i++) {
+        lean_inc(node_child(n, i));
+        lean_ctor_set(r, i, node_child(n, i));
+    }
+    std::copy(node_sizes(n), node_sizes(n) + num, node_sizes(r));
+    lean_dec_ref(n);
+    return r;
+}
+
+/* Return the slot of node `n` containing the index `i`, and update `i` to be relative to that slot. */
+static inline unsigned find_slot(b_obj_arg n, unsigned shift, size_t & i) {
+    size_t const * sizes = node_sizes(n);
+    unsigned j = i >> shift;
+    while (sizes[j] <= i) j++;
+    if (j > 0) i -= sizes[j - 1];
+    return j;
+}
+
+/* Copy the elements `[begin, end)` of `a` to a new array. */
+static obj_res array_slice(obj_arg a, size_t begin, size_t end, size_t capacity) {
+    if (begin == 0 && end == lean_array_size(a) && lean_array_capacity(a) >= capacity)
+        return a;
+    object * r = lean_alloc_array(end - begin, std::max(end - begin, capacity));
+    object ** it = lean_array_cptr(r);
+    for (size_t i = begin; i < end; i++) {
+        object * e = lean_array_get_core(a, i);
+        lean_inc(e);
+        *it++ = e;
+    }
+    lean_dec_ref(a);
+    return r;
+}
+
+/* Remove single-child nodes at the top of the tree. */
+static obj_res collapse(obj_arg t, unsigned & shift) {
+    while (shift > 0 && node_num(t) == 1) {
+        object * c = node_child(t, 0);
+        lean_inc(c);
+        lean_dec_ref(t);
+        t = c;
+        shift -= RRB_BITS;
+    }
+    return t;
+}
+
+static b_obj_res vec_get(b_obj_arg v, size_t i) {
+    size_t tail_off = vec_tail_offset(v);
+    if (i >= tail_off)
+        return lean_array_get_core(vec_tail(v), i - tail_off);
+    object * t = vec_root(v);
+    for (unsigned shift = vec_shift(v); shift > 0; shift -= RRB_BITS)
+        t = node_child(t, find_slot(t, shift, i));
+    return lean_array_get_core(t, i);
+}
+
+static obj_res tree_set(obj_arg t, unsigned shift, size_t i, obj_arg a) {
+    if (shift == 0)
+        return lean_array_uset(t, i, a);
+    t = ensure_exclusive_node(t);
+    unsigned j = find_slot(t, shift, i);
+    lean_ctor_set(t, j, tree_set(node_child(t, j), shift - RRB_BITS, i, a));
+    return t;
+}
+
+/* Return true if a leaf can be added to `t` without increasing its height. */
+static bool has_room(b_obj_arg t, unsigned shift) {
+    if (shift == 0)
+        return false;
+    unsigned n = node_num(t);
+    return n < RRB_BRANCHING || has_room(node_child(t, n - 1), shift - RRB_BITS);
+}
+
+/* Create a tree with shift `shift` containing only the leaf `l`. */
+static obj_res mk_path(obj_arg l, unsigned shift) {
+    for (unsigned s = RRB_BITS; s <= shift; s += RRB_BITS)
+        l = mk_node(&l, 1, s);
+    return l;
+}
+
+/* Add the leaf `l` after the last leaf of `t`. `has_room(t, shift)` must hold. */
+static obj_res push_leaf(obj_arg t, unsigned shift, obj_arg l) {
+    unsigned n = node_num(t);
+    size_t sz  = lean_array_size(l);
+    if (has_room(node_child(t, n - 1), shift - RRB_BITS)) {
+        t = ensure_exclusive_node(t);
+        lean_ctor_set(t, n - 1, push_leaf(node_child(t, n - 1), shift - RRB_BITS, l));
+        node_sizes(t)[n - 1] += sz;
+        return t;
+    }
+    object * r = lean_alloc_ctor(0, n + 1, (n + 1) * sizeof(size_t));
+    bool exclusive = lean_is_exclusive(t);
+    for (unsigned i = 0; i < n; i++) {
+        if (!exclusive) lean_inc(node_child(t, i));
+        lean_ctor_set(r, i, node_child(t, i));
+    }
+    std::copy(node_sizes(t), node_sizes(t) + n, node_sizes(r));
+    if (exclusive)
+        lean_free_object(t);
+    else
+        lean_dec_ref(t);
+    lean_ctor_set(r, n, mk_path(l, shift - RRB_BITS));
+    node_sizes(r)[n] = node_sizes(r)[n - 1] + sz;
+    return r;
+}
+
+/* Add the leaf `l` after the last leaf of the tree with shift `shift` storing `sz` elements. */
+static obj_res tree_push_leaf(obj_arg t, unsigned & shift, size_t sz, obj_arg l) {
+    if (sz == 0) {
+        lean_dec_ref(t);
+        shift = 0;
+        return l;
+    } else if (has_room(t, shift)) {
+        return push_leaf(t, shift, l);
+    } else {
+        object * cs[2] = { t, mk_path(l, shift) };
+        shift += RRB_BITS;
+        return mk_node(cs, 2, shift);
+    }
+}
+
+/* Keep the first `n` elements of `t`, `0 < n <= tree_size(t, shift)`. */
+static obj_res tree_take(obj_arg t, unsigned shift, size_t n) {
+    if (n == tree_size(t, shift))
+        return t;
+    if (shift == 0)
+        return array_slice(t, 0, n, 0);
+    size_t i = n - 1;
+    unsigned j = find_slot(t, shift, i);
+    object * cs[RRB_BRANCHING];
+    for (unsigned k = 0; k <= j; k++) {
+        cs[k] = node_child(t, k);
+        lean_inc(cs[k]);
+    }
+    cs[j] = tree_take(cs[j], shift - RRB_BITS, i + 1);
+    lean_dec_ref(t);
+    return mk_node(cs, j + 1, shift);
+}
+
+/* Remove the first `n` elements of `t`, `n < tree_size(t, shift)`. */
+static obj_res tree_drop(obj_arg t, unsigned shift, size_t n) {
+    if (n == 0)
+        return t;
+    if (shift == 0)
+        return array_slice(t, n, lean_array_size(t), 0);
+    unsigned j = find_slot(t, shift, n);
+    unsigned num = node_num(t);
+    object * cs[RRB_BRANCHING];
+    for (unsigned k = j; k < num; k++) {
+        cs[k - j] = node_child(t, k);
+        lean_inc(cs[k - j]);
+    }
+    cs[0] = tree_drop(cs[0], shift - RRB_BITS, n);
+    lean_dec_ref(t);
+    return mk_node(cs, num - j, shift);
+}
+
+static b_obj_res last_leaf(b_obj_arg t, unsigned shift) {
+    for (; shift > 0; shift -= RRB_BITS)
+        t = node_child(t, node_num(t) - 1);
+    return t;
+}
+
+/*
+Redistribute the slots of the `n` trees `ts` with shift `shift` so that the search step invariant holds, i.e.,
+the number of trees is at most `RRB_EXTRAS` more than the optimal one. Trees that are not affected by the
+redistribution are reused. Return the new number of trees.
+*/
+static unsigned redistribute(object ** ts, unsigned n, unsigned shift) {
+    unsigned counts[2 * RRB_BRANCHING + 1] = {};
+    size_t total = 0;
+    for (unsigned i = 0; i < n; i++) {
+        counts[i] = tree_slots(ts[i], shift);
+        total += counts[i];
+    }
+    size_t optimal = (total + RRB_BRANCHING - 1) / RRB_BRANCHING;
+    if (optimal + RRB_EXTRAS >= n)
+        return n;
+    // Compute the concatenation plan: repeatedly merge the first node with fewer than
+    // `RRB_BRANCHING - RRB_INVARIANT` slots into the following ones.
+    unsigned len = n;
+    unsigned i   = 0;
+    while (optimal + RRB_EXTRAS < len) {
+        while (counts[i] > RRB_BRANCHING - RRB_INVARIANT) i++;
+        unsigned remaining = counts[i];
+        do {
+            unsigned min_size = std::min(remaining + counts[i + 1], RRB_BRANCHING);
+            remaining = remaining + counts[i + 1] - min_size;
+            counts[i] = min_size;
+            i++;
+        } while (remaining > 0);
+        for (unsigned j = i; j < len - 1; j++)
+            counts[j] = counts[j + 1];
+        len--;
+        i--;
+    }
+    // Execute the plan.
+    object * rs[2 * RRB_BRANCHING];
+    unsigned src = 0;
+    unsigned off = 0;
+    for (unsigned k = 0; k < len; k++) {
+        if (off == 0 && tree_slots(ts[src], shift) == counts[k]) {
+            rs[k] = ts[src++];
+            continue;
+        }
+        object * slots[RRB_BRANCHING];
+        for (unsigned m = 0; m < counts[k]; m++) {
+            object * s = shift == 0 ? lean_array_get_core(ts[src], off) : node_child(ts[src], off);
+            lean_inc(s);
+            slots[m] = s;
+            if (++off == tree_slots(ts[src], shift)) {
+                lean_dec_ref(ts[src++]);
+                off = 0;
+            }
+        }
+        if (shift == 0) {
+            object * l = lean_alloc_array(counts[k], counts[k]);
+            std::copy(slots, slots + counts[k], lean_array_cptr(l));
+            rs[k] = l;
+        } else {
+            rs[k] = mk_node(slots, counts[k], shift);
+        }
+    }
+    lean_assert(src == n && off == 0);
+    std::copy(rs, rs + len, ts);
+    return len;
+}
+
+/*
+Merge the children of `l` but its last one, of `c`, and of `r` but its first one, where `l` and `r` may be null.
+The children have shift `shift - RRB_BITS`. Return a node with shift `shift + RRB_BITS` with one or two children.
+*/
+static obj_res rebalance(obj_arg l, obj_arg c, obj_arg r, unsigned shift) {
+    object * ts[2 * RRB_BRANCHING];
+    unsigned n = 0;
+    if (l) {
+        for (unsigned i = 0; i + 1 < node_num(l); i++) {
+            lean_inc(node_child(l, i));
+            ts[n++] = node_child(l, i);
+        }
+        lean_dec_ref(l);
+    }
+    for (unsigned i = 0; i < node_num(c); i++) {
+        lean_inc(node_child(c, i));
+        ts[n++] = node_child(c, i);
+    }
+    lean_dec_ref(c);
+    if (r) {
+        for (unsigned i = 1; i < node_num(r); i++) {
+            lean_inc(node_child(r, i));
+            ts[n++] = node_child(r, i);
+        }
+        lean_dec_ref(r);
+    }
+    n = redistribute(ts, n, shift - RRB_BITS);
+    object * ns[2];
+    unsigned num = 0;
+    for (unsigned i = 0; i < n; i += RRB_BRANCHING)
+        ns[num++] = mk_node(ts + i, std::min(n - i, RRB_BRANCHING), shift);
+    return mk_node(ns, num, shift + RRB_BITS);
+}
+
+/* Concatenate the trees `l` and `r`. Return a node with shift `max(lshift, rshift) + RRB_BITS` with one or two children. */
+static obj_res concat_trees(obj_arg l, unsigned lshift, obj_arg r, unsigned rshift) {
+    if (lshift > rshift) {
+        object * last = node_child(l, node_num(l) - 1);
+        lean_inc(last);
+        object * c = concat_trees(last, lshift - RRB_BITS, r, rshift);
+        return rebalance(l, c, nullptr, lshift);
+    } else if (lshift < rshift) {
+        object * first = node_child(r, 0);
+        lean_inc(first);
+        object * c = concat_trees(l, lshift, first, rshift - RRB_BITS);
+        return rebalance(nullptr, c, r, rshift);
+    } else if (lshift == 0) {
+        size_t lsz = lean_array_size(l);
+        size_t rsz = lean_array_size(r);
+        if (lsz + rsz <= RRB_BRANCHING) {
+            object * m = array_slice(l, 0, lsz, lsz + rsz);
+            for (size_t i = 0; i < rsz; i++) {
+                lean_inc(lean_array_get_core(r, i));
+                m = lean_array_push(m, lean_array_get_core(r, i));
+            }
+            lean_dec_ref(r);
+            return mk_node(&m, 1, RRB_BITS);
+        }
+        object * cs[2] = { l, r };
+        return mk_node(cs, 2, RRB_BITS);
+    } else {
+        object * last  = node_child(l, node_num(l) - 1);
+        object * first = node_child(r, 0);
+        lean_inc(last);
+        lean_inc(first);
+        object * c = concat_trees(last, lshift - RRB_BITS, first, rshift - RRB_BITS);
+        return rebalance(l, c, r, lshift);
+    }
+}
+
+static void collect_leaves(b_obj_arg t, unsigned shift, std::function<void(b_obj_arg)> const & f) {
+    if (shift == 0) {
+        if (lean_array_size(t) > 0)
+            f(t);
+    } else {
+        for (unsigned i = 0; i < node_num(t); i++)
+            collect_leaves(node_child(t, i), shift - RRB_BITS, f);
+    }
+}
+
+// RRBVector.mkEmpty : Unit → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_mk_empty(obj_arg) {
+    return mk_empty_vec();
+}
+
+// RRBVector.size : @& RRBVector α → Nat
+extern "C" LEAN_EXPORT obj_res lean_rrb_size(b_obj_arg v) {
+    return lean_usize_to_nat(vec_size(v));
+}
+
+// RRBVector.get? : @& RRBVector α → @& Nat → Option α
+extern "C" LEAN_EXPORT obj_res lean_rrb_get_opt(b_obj_arg v, b_obj_arg i) {
+    if (!lean_is_scalar(i) || lean_unbox(i) >= vec_size(v))
+        return lean_box(0);
+    object * a = vec_get(v, lean_unbox(i));
+    lean_inc(a);
+    object * r = lean_alloc_ctor(1, 1, 0);
+    lean_ctor_set(r, 0, a);
+    return r;
+}
+
+// RRBVector.getD : @& RRBVector α → @& Nat → α → α
+extern "C" LEAN_EXPORT obj_res lean_rrb_get_d(b_obj_arg v, b_obj_arg i, obj_arg d) {
+    if (!lean_is_scalar(i) || lean_unbox(i) >= vec_size(v))
+        return d;
+    lean_dec(d);
+    object * a = vec_get(v, lean_unbox(i));
+    lean_inc(a);
+    return a;
+}
+
+// RRBVector.set : RRBVector α → @& Nat → α → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_set(obj_arg v, b_obj_arg i, obj_arg a) {
+    if (!lean_is_scalar(i) || lean_unbox(i) >= vec_size(v)) {
+        lean_dec(a);
+        return v;
+    }
+    size_t idx = lean_unbox(i);
+    v = ensure_exclusive_vec(v);
+    size_t tail_off = vec_tail_offset(v);
+    if (idx >= tail_off)
+        lean_ctor_set(v, 1, lean_array_uset(vec_tail(v), idx - tail_off, a));
+    else
+        lean_ctor_set(v, 0, tree_set(vec_root(v), vec_shift(v), idx, a));
+    return v;
+}
+
+// RRBVector.push : RRBVector α → α → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_push(obj_arg v, obj_arg a) {
+    v = ensure_exclusive_vec(v);
+    object * tail = vec_tail(v);
+    if (lean_array_size(tail) == RRB_BRANCHING) {
+        unsigned shift = vec_shift(v);
+        lean_ctor_set(v, 0, tree_push_leaf(vec_root(v), shift, vec_tail_offset(v), tail));
+        lean_ctor_set_usize(v, 3, shift);
+        tail = mk_empty_tail();
+    }
+    lean_ctor_set(v, 1, lean_array_push(tail, a));
+    lean_ctor_set_usize(v, 2, vec_size(v) + 1);
+    return v;
+}
+
+// RRBVector.pop : RRBVector α → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_pop(obj_arg v) {
+    size_t sz = vec_size(v);
+    if (sz == 0)
+        return v;
+    v = ensure_exclusive_vec(v);
+    object * root  = vec_root(v);
+    object * tail  = vec_tail(v);
+    unsigned shift = vec_shift(v);
+    if (lean_array_size(tail) == 0) {
+        // Move the last leaf of the tree to the tail.
+        lean_dec_ref(tail);
+        tail = last_leaf(root, shift);
+        lean_inc(tail);
+        size_t tree_sz = sz - lean_array_size(tail);
+        if (tree_sz == 0) {
+            lean_dec_ref(root);
+            root  = lean_alloc_array(0, 0);
+            shift = 0;
+        } else {
+            root = collapse(tree_take(root, shift, tree_sz), shift);
+        }
+        lean_ctor_set(v, 0, root);
+        lean_ctor_set_usize(v, 3, shift);
+    }
+    lean_ctor_set(v, 1, lean_array_pop(tail));
+    lean_ctor_set_usize(v, 2, sz - 1);
+    return v;
+}
+
+// RRBVector.append : RRBVector α → RRBVector α → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_append(obj_arg v, obj_arg w) {
+    if (vec_size(w) == 0) {
+        lean_dec_ref(w);
+        return v;
+    }
+    if (vec_size(v) == 0) {
+        lean_dec_ref(v);
+        return w;
+    }
+    if (vec_tail_offset(w) == 0) {
+        object * tail = vec_tail(w);
+        for (size_t i = 0; i < lean_array_size(tail); i++) {
+            lean_inc(lean_array_get_core(tail, i));
+            v = lean_rrb_push(v, lean_array_get_core(tail, i));
+        }
+        lean_dec_ref(w);
+        return v;
+    }
+    size_t size = vec_size(v) + vec_size(w);
+    // Move the tail of `v` to its tree, and concatenate it with the tree of `w`.
+    unsigned lshift = vec_shift(v);
+    object * l = vec_root(v);
+    object * t = vec_tail(v);
+    size_t lsz = vec_tail_offset(v);
+    lean_inc(l);
+    lean_inc(t);
+    lean_dec_ref(v);
+    if (lean_array_size(t) > 0)
+        l = tree_push_leaf(l, lshift, lsz, t);
+    else
+        lean_dec_ref(t);
+    unsigned rshift = vec_shift(w);
+    object * r = vec_root(w);
+    t = vec_tail(w);
+    lean_inc(r);
+    lean_inc(t);
+    lean_dec_ref(w);
+    unsigned shift = std::max(lshift, rshift) + RRB_BITS;
+    object * root  = collapse(concat_trees(l, lshift, r, rshift), shift);
+    return mk_vec(root, t, size, shift);
+}
+
+// RRBVector.extract : RRBVector α → @& Nat → @& Nat → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_extract(obj_arg v, b_obj_arg b, b_obj_arg e) {
+    size_t size  = vec_size(v);
+    size_t end   = lean_is_scalar(e) ? std::min(lean_unbox(e), size) : size;
+    size_t begin = lean_is_scalar(b) ? lean_unbox(b) : size;
+    if (begin >= end) {
+        lean_dec_ref(v);
+        return mk_empty_vec();
+    }
+    if (begin == 0 && end == size)
+        return v;
+    object * root  = vec_root(v);
+    object * tail  = vec_tail(v);
+    unsigned shift = vec_shift(v);
+    size_t tree_sz = vec_tail_offset(v);
+    lean_inc(root);
+    lean_inc(tail);
+    lean_dec_ref(v);
+    if (end <= tree_sz) {
+        lean_dec_ref(tail);
+        tail    = mk_empty_tail();
+        root    = tree_take(root, shift, end);
+        tree_sz = end;
+    } else {
+        tail = array_slice(tail, 0, end - tree_sz, 0);
+    }
+    if (begin >= tree_sz) {
+        tail = array_slice(tail, begin - tree_sz, lean_array_size(tail), 0);
+        lean_dec_ref(root);
+        root  = lean_alloc_array(0, 0);
+        shift = 0;
+    } else {
+        root = tree_drop(root, shift, begin);
+    }
+    root = collapse(root, shift);
+    return mk_vec(root, tail, end - begin, shift);
+}
+
+// RRBVector.ofArray : Array α → RRBVector α
+extern "C" LEAN_EXPORT obj_res lean_rrb_of_array(obj_arg a) {
+    size_t n = lean_array_size(a);
+    if (n == 0) {
+        lean_dec_ref(a);
+        return mk_empty_vec();
+    }
+    size_t tree_sz = (n - 1) / RRB_BRANCHING * RRB_BRANCHING;
+    std::vector<object *> level;
+    for (size_t i = 0; i < tree_sz; i += RRB_BRANCHING) {
+        lean_inc(a);
+        level.push_back(array_slice(a, i, i + RRB_BRANCHING, 0));
+    }
+    object * tail  = array_slice(a, tree_sz, n, RRB_BRANCHING);
+    unsigned shift = 0;
+    while (level.size() > 1) {
+        shift += RRB_BITS;
+        size_t num = 0;
+        for (size_t i = 0; i < level.size(); i += RRB_BRANCHING)
+            level[num++] = mk_node(level.data() + i, std::min<size_t>(level.size() - i, RRB_BRANCHING), shift);
+        level.resize(num);
+    }
+    object * root = level.empty() ? lean_alloc_array(0, 0) : level[0];
+    return mk_vec(root, tail, n, shift);
+}
+
+// RRBVector.toArray : @& RRBVector α → Array α
+extern "C" LEAN_EXPORT obj_res lean_rrb_to_array(b_obj_arg v) {
+    size_t n = vec_size(v);
+    object * r = lean_alloc_array(n, n);
+    object ** it = lean_array_cptr(r);
+    auto copy = [&](b_obj_arg l) {
+        for (size_t i = 0; i < lean_array_size(l); i++) {
+            object * e = lean_array_get_core(l, i);
+            lean_inc(e);
+            *it++ = e;
+        }
+    };
+    collect_leaves(vec_root(v), vec_shift(v), copy);
+    copy(vec_tail(v));
+    return r;
+}
+
+// RRBVector.toChunks : @& RRBVector α → Array (Array α)
+extern "C" LEAN_EXPORT obj_res lean_rrb_to_chunks(b_obj_arg v) {
+    object * r = lean_mk_empty_array();
+    auto push = [&](b_obj_arg l) {
+        lean_inc(l);
+        r = lean_array_push(r, l);
+    };
+    collect_leaves(vec_root(v), vec_shift(v), push);
+    if (lean_array_size(vec_tail(v)) > 0)
+        push(vec_tail(v));
+    return r;
+}
+}
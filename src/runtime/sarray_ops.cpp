@@ -0,0 +1,410 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "runtime/object.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAN_SARRAY_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LEAN_SARRAY_NEON
+#endif
+
+/* Bulk operations on `ByteArray` and `FloatArray`.
+   As in `utf8.cpp`, the 16-byte kernels only use instructions that are part of the base x86-64 (SSE2)
+   and AArch64 (NEON) instruction sets, so no runtime CPU dispatch is needed. Every kernel has a
+   portable fallback that produces the same result. */
+
+namespace lean {
+static obj_res mk_option_some_nat(size_t i) {
+    object * r = lean_alloc_ctor(1, 1, 0);
+    lean_ctor_set(r, 0, lean_usize_to_nat(i));
+    return r;
+}
+
+static size_t clamp_index(b_obj_arg i, size_t sz) {
+    return lean_is_scalar(i) && lean_unbox(i) < sz ? lean_unbox(i) : sz;
+}
+
+static obj_res sarray_exclusive(obj_arg a) {
+    return lean_is_exclusive(a) ? a : lean_copy_sarray(a, lean_sarray_capacity(a));
+}
+
+// =======================================
+// ByteArray
+
+// def ByteArray.indexOf? (a : @& ByteArray) (b : UInt8) (start : @& Nat := 0) : Option Nat
+extern "C" LEAN_EXPORT obj_res lean_byte_array_index_of(b_obj_arg a, uint8 b, b_obj_arg start) {
+    size_t sz = lean_sarray_size(a);
+    size_t i  = clamp_index(start, sz);
+    uint8 const * data = lean_sarray_cptr(a);
+    void const * p = memchr(data + i, b, sz - i);
+    if (p == nullptr)
+        return lean_box(0);
+    return mk_option_some_nat(static_cast<uint8 const *>(p) - data);
+}
+
+/* `memchr` is vectorized by the C library, so we use it to find the candidates for the first byte of
+   the pattern instead of relying on `memmem`, which is not available on all platforms. */
+// def ByteArray.indexOfBytes? (a pat : @& ByteArray) (start : @& Nat := 0) : Option Nat
+extern "C" LEAN_EXPORT obj_res lean_byte_array_index_of_bytes(b_obj_arg a, b_obj_arg pat, b_obj_arg start) {
+    size_t sz   = lean_sarray_size(a);
+    size_t psz  = lean_sarray_size(pat);
+    if (!lean_is_scalar(start) || lean_unbox(start) > sz)
+        return lean_box(0);
+    size_t i = lean_unbox(start);
+    if (psz == 0)
+        return mk_option_some_nat(i);
+    uint8 const * data = lean_sarray_cptr(a);
+    uint8 const * p    = lean_sarray_cptr(pat);
+    while (sz - i >= psz) {
+        void const * c = memchr(data + i, p[0], sz - i - psz + 1);
+        if (c == nullptr)
+            break;
+        i = static_cast<uint8 const *>(c) - data;
+        if (memcmp(data + i + 1, p + 1, psz - 1) == 0)
+            return mk_option_some_nat(i);
+        i++;
+    }
+    return lean_box(0);
+}
+
+// def ByteArray.compare (a b : @& ByteArray) : Ordering
+extern "C" LEAN_EXPORT uint8 lean_byte_array_compare(b_obj_arg a, b_obj_arg b) {
+    size_t asz = lean_sarray_size(a);
+    size_t bsz = lean_sarray_size(b);
+    int c = memcmp(lean_sarray_cptr(a), lean_sarray_cptr(b), std::min(asz, bsz));
+    if (c == 0)
+        return asz < bsz ? 0 : (asz == bsz ? 1 : 2);
+    return c < 0 ? 0 : 2;
+}
+
+enum class bitwise_op { Xor, And, Or };
+
+template<bitwise_op op> static inline uint64 apply_op(uint64 a, uint64 b) {
+    return op == bitwise_op::Xor ? a ^ b : (op == bitwise_op::And ? a & b : a | b);
+}
+
+/* Combine the slice `[src_off, src_off + len)` of `src` into `[dest_off, dest_off + len)` of `dest`.
+   The slice is clamped to the bounds of both arrays, `dest` never grows. */
+template<bitwise_op op>
+static obj_res byte_array_bitwise_slice(b_obj_arg src, b_obj_arg o_src_off, obj_arg dest, b_obj_arg o_dest_off, b_obj_arg o_len) {
+    size_t ssz      = lean_sarray_size(src);
+    size_t dsz      = lean_sarray_size(dest);
+    size_t src_off  = clamp_index(o_src_off, ssz);
+    size_t dest_off = clamp_index(o_dest_off, dsz);
+    size_t len      = std::min(ssz - src_off, dsz - dest_off);
+    if (lean_is_scalar(o_len))
+        len = std::min(len, lean_unbox(o_len));
+    if (len == 0)
+        return dest;
+    object * r = sarray_exclusive(dest);
+    uint8 const * s = lean_sarray_cptr(src) + src_off;
+    uint8 * d       = lean_sarray_cptr(r) + dest_off;
+    /* If `src` is `r` itself, the slices may overlap, and `s` must still be read as it was before the
+       update. The loops below load each chunk before storing it, so going forwards is correct when
+       `dest_off <= src_off`. Otherwise, we go backwards. */
+    if (s < d && d < s + len) {
+        for (size_t i = len; i-- > 0;)
+            d[i] = static_cast<uint8>(apply_op<op>(d[i], s[i]));
+        return r;
+    }
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(d + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<__m128i const *>(s + i));
+        __m128i z = op == bitwise_op::Xor ? _mm_xor_si128(x, y) : (op == bitwise_op::And ? _mm_and_si128(x, y) : _mm_or_si128(x, y));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), z);
+    }
+#elif defined(LEAN_SARRAY_NEON)
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t x = vld1q_u8(d + i);
+        uint8x16_t y = vld1q_u8(s + i);
+        uint8x16_t z = op == bitwise_op::Xor ? veorq_u8(x, y) : (op == bitwise_op::And ? vandq_u8(x, y) : vorrq_u8(x, y));
+        vst1q_u8(d + i, z);
+    }
+#endif
+    for (; i + 8 <= len; i += 8) {
+        uint64 x, y;
+        memcpy(&x, d + i, sizeof(x));
+        memcpy(&y, s + i, sizeof(y));
+        x = apply_op<op>(x, y);
+        memcpy(d + i, &x, sizeof(x));
+    }
+    for (; i < len; i++)
+        d[i] = static_cast<uint8>(apply_op<op>(d[i], s[i]));
+    return r;
+}
+
+// def ByteArray.xorSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray
+extern "C" LEAN_EXPORT obj_res lean_byte_array_xor_slice(b_obj_arg src, b_obj_arg src_off, obj_arg dest, b_obj_arg dest_off, b_obj_arg len) {
+    return byte_array_bitwise_slice<bitwise_op::Xor>(src, src_off, dest, dest_off, len);
+}
+
+// def ByteArray.andSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray
+extern "C" LEAN_EXPORT obj_res lean_byte_array_and_slice(b_obj_arg src, b_obj_arg src_off, obj_arg dest, b_obj_arg dest_off, b_obj_arg len) {
+    return byte_array_bitwise_slice<bitwise_op::And>(src, src_off, dest, dest_off, len);
+}
+
+// def ByteArray.orSlice (src : @& ByteArray) (srcOff : @& Nat) (dest : ByteArray) (destOff len : @& Nat) : ByteArray
+extern "C" LEAN_EXPORT obj_res lean_byte_array_or_slice(b_obj_arg src, b_obj_arg src_off, obj_arg dest, b_obj_arg dest_off, b_obj_arg len) {
+    return byte_array_bitwise_slice<bitwise_op::Or>(src, src_off, dest, dest_off, len);
+}
+
+static inline unsigned popcount64(uint64 x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+}
+
+// def ByteArray.popcount (a : @& ByteArray) : Nat
+extern "C" LEAN_EXPORT obj_res lean_byte_array_popcount(b_obj_arg a) {
+    size_t sz = lean_sarray_size(a);
+    uint8 const * p = lean_sarray_cptr(a);
+    size_t r = 0;
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    /* SSE2 has neither `popcnt` nor `pshufb`, so count the bits of each byte with the usual bit tricks
+       and sum the bytes with `psadbw`. */
+    __m128i const m1 = _mm_set1_epi8(0x55);
+    __m128i const m2 = _mm_set1_epi8(0x33);
+    __m128i const m4 = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= sz; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + i));
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+        x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+    uint64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    r += static_cast<size_t>(lanes[0] + lanes[1]);
+#elif defined(LEAN_SARRAY_NEON)
+    for (; i + 16 <= sz; i += 16) {
+        r += vaddlvq_u8(vcntq_u8(vld1q_u8(p + i)));
+    }
+#endif
+    for (; i + 8 <= sz; i += 8) {
+        uint64 x;
+        memcpy(&x, p + i, sizeof(x));
+        r += popcount64(x);
+    }
+    for (; i < sz; i++)
+        r += popcount64(p[i]);
+    return lean_usize_to_nat(r);
+}
+
+// =======================================
+// FloatArray
+
+static inline double const * float_array_cptr(b_obj_arg a) {
+    return reinterpret_cast<double const *>(lean_sarray_cptr(a));
+}
+
+/* `sum` and `dot` accumulate the elements with index `4*k + j` in the `j`-th of four partial sums,
+   which are combined as `(s₀ + s₂) + (s₁ + s₃)`. The remaining `sz % 4` elements are then added in
+   order. All implementations, including the reference implementation in Lean, use this order. */
+template<typename F>
+static double float_array_reduce_add(size_t sz, F elem) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        s0 += elem(i);
+        s1 += elem(i + 1);
+        s2 += elem(i + 2);
+        s3 += elem(i + 3);
+    }
+    double r = (s0 + s2) + (s1 + s3);
+    for (; i < sz; i++)
+        r += elem(i);
+    return r;
+}
+
+// def FloatArray.sum (a : @& FloatArray) : Float
+extern "C" LEAN_EXPORT double lean_float_array_sum(b_obj_arg a) {
+    size_t sz = lean_sarray_size(a);
+    double const * x = float_array_cptr(a);
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d v0 = _mm_setzero_pd(), v1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        v0 = _mm_add_pd(v0, _mm_loadu_pd(x + i));
+        v1 = _mm_add_pd(v1, _mm_loadu_pd(x + i + 2));
+    }
+    __m128d v = _mm_add_pd(v0, v1);
+    double r = _mm_cvtsd_f64(v) + _mm_cvtsd_f64(_mm_unpackhi_pd(v, v));
+    for (; i < sz; i++)
+        r += x[i];
+    return r;
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t v0 = vdupq_n_f64(0.0), v1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        v0 = vaddq_f64(v0, vld1q_f64(x + i));
+        v1 = vaddq_f64(v1, vld1q_f64(x + i + 2));
+    }
+    float64x2_t v = vaddq_f64(v0, v1);
+    double r = vgetq_lane_f64(v, 0) + vgetq_lane_f64(v, 1);
+    for (; i < sz; i++)
+        r += x[i];
+    return r;
+#else
+    return float_array_reduce_add(sz, [&](size_t i) { return x[i]; });
+#endif
+}
+
+// def FloatArray.dot (a b : @& FloatArray) : Float
+extern "C" LEAN_EXPORT double lean_float_array_dot(b_obj_arg a, b_obj_arg b) {
+    size_t sz = std::min(lean_sarray_size(a), lean_sarray_size(b));
+    double const * x = float_array_cptr(a);
+    double const * y = float_array_cptr(b);
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d v0 = _mm_setzero_pd(), v1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        v0 = _mm_add_pd(v0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        v1 = _mm_add_pd(v1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    __m128d v = _mm_add_pd(v0, v1);
+    double r = _mm_cvtsd_f64(v) + _mm_cvtsd_f64(_mm_unpackhi_pd(v, v));
+    for (; i < sz; i++)
+        r += x[i] * y[i];
+    return r;
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t v0 = vdupq_n_f64(0.0), v1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= sz; i += 4) {
+        v0 = vaddq_f64(v0, vmulq_f64(vld1q_f64(x + i), vld1q_f64(y + i)));
+        v1 = vaddq_f64(v1, vmulq_f64(vld1q_f64(x + i + 2), vld1q_f64(y + i + 2)));
+    }
+    float64x2_t v = vaddq_f64(v0, v1);
+    double r = vgetq_lane_f64(v, 0) + vgetq_lane_f64(v, 1);
+    for (; i < sz; i++)
+        r += x[i] * y[i];
+    return r;
+#else
+    return float_array_reduce_add(sz, [&](size_t i) { return x[i] * y[i]; });
+#endif
+}
+
+/* `min` and `max` ignore NaNs: an element only replaces the current result if it compares less
+   (greater) than it. The SSE2 `minpd`/`maxpd` instructions return their second operand when either
+   operand is NaN, which is exactly this behavior. When several elements compare equal to the result,
+   such as `0.0` and `-0.0`, it is unspecified which one is returned. */
+template<bool is_min>
+static double float_array_min_max(b_obj_arg a) {
+    size_t sz = lean_sarray_size(a);
+    double const * x = float_array_cptr(a);
+    double const init = is_min ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+    double r = init;
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d v = _mm_set1_pd(init);
+    for (; i + 2 <= sz; i += 2) {
+        __m128d e = _mm_loadu_pd(x + i);
+        v = is_min ? _mm_min_pd(e, v) : _mm_max_pd(e, v);
+    }
+    double lo = _mm_cvtsd_f64(v), hi = _mm_cvtsd_f64(_mm_unpackhi_pd(v, v));
+    r = (is_min ? hi < lo : hi > lo) ? hi : lo;
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t v = vdupq_n_f64(init);
+    for (; i + 2 <= sz; i += 2) {
+        float64x2_t e = vld1q_f64(x + i);
+        v = vbslq_f64(is_min ? vcltq_f64(e, v) : vcgtq_f64(e, v), e, v);
+    }
+    double lo = vgetq_lane_f64(v, 0), hi = vgetq_lane_f64(v, 1);
+    r = (is_min ? hi < lo : hi > lo) ? hi : lo;
+#endif
+    for (; i < sz; i++) {
+        if (is_min ? x[i] < r : x[i] > r)
+            r = x[i];
+    }
+    return r;
+}
+
+// def FloatArray.min (a : @& FloatArray) : Float
+extern "C" LEAN_EXPORT double lean_float_array_min(b_obj_arg a) {
+    return float_array_min_max<true>(a);
+}
+
+// def FloatArray.max (a : @& FloatArray) : Float
+extern "C" LEAN_EXPORT double lean_float_array_max(b_obj_arg a) {
+    return float_array_min_max<false>(a);
+}
+
+// def FloatArray.mulScalar (a : FloatArray) (s : Float) : FloatArray
+extern "C" LEAN_EXPORT obj_res lean_float_array_mul_scalar(obj_arg a, double s) {
+    size_t sz = lean_sarray_size(a);
+    if (sz == 0)
+        return a;
+    object * r = sarray_exclusive(a);
+    double * x = reinterpret_cast<double *>(lean_sarray_cptr(r));
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d vs = _mm_set1_pd(s);
+    for (; i + 2 <= sz; i += 2)
+        _mm_storeu_pd(x + i, _mm_mul_pd(_mm_loadu_pd(x + i), vs));
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t vs = vdupq_n_f64(s);
+    for (; i + 2 <= sz; i += 2)
+        vst1q_f64(x + i, vmulq_f64(vld1q_f64(x + i), vs));
+#endif
+    for (; i < sz; i++)
+        x[i] = x[i] * s;
+    return r;
+}
+
+// def FloatArray.addScalar (a : FloatArray) (s : Float) : FloatArray
+extern "C" LEAN_EXPORT obj_res lean_float_array_add_scalar(obj_arg a, double s) {
+    size_t sz = lean_sarray_size(a);
+    if (sz == 0)
+        return a;
+    object * r = sarray_exclusive(a);
+    double * x = reinterpret_cast<double *>(lean_sarray_cptr(r));
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d vs = _mm_set1_pd(s);
+    for (; i + 2 <= sz; i += 2)
+        _mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i), vs));
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t vs = vdupq_n_f64(s);
+    for (; i + 2 <= sz; i += 2)
+        vst1q_f64(x + i, vaddq_f64(vld1q_f64(x + i), vs));
+#endif
+    for (; i < sz; i++)
+        x[i] = x[i] + s;
+    return r;
+}
+
+// def FloatArray.axpy (alpha : Float) (x : @& FloatArray) (y : FloatArray) : FloatArray
+extern "C" LEAN_EXPORT obj_res lean_float_array_axpy(double alpha, b_obj_arg x, obj_arg y) {
+    size_t sz = std::min(lean_sarray_size(x), lean_sarray_size(y));
+    if (sz == 0)
+        return y;
+    object * r = sarray_exclusive(y);
+    // `x` may be `r` itself, which is fine since each element is read before it is written
+    double const * xs = float_array_cptr(x);
+    double * ys = reinterpret_cast<double *>(lean_sarray_cptr(r));
+    size_t i = 0;
+#if defined(LEAN_SARRAY_SSE2)
+    __m128d va = _mm_set1_pd(alpha);
+    for (; i + 2 <= sz; i += 2)
+        _mm_storeu_pd(ys + i, _mm_add_pd(_mm_loadu_pd(ys + i), _mm_mul_pd(va, _mm_loadu_pd(xs + i))));
+#elif defined(LEAN_SARRAY_NEON)
+    float64x2_t va = vdupq_n_f64(alpha);
+    for (; i + 2 <= sz; i += 2)
+        vst1q_f64(ys + i, vaddq_f64(vld1q_f64(ys + i), vmulq_f64(va, vld1q_f64(xs + i))));
+#endif
+    for (; i < sz; i++)
+        ys[i] = ys[i] + alpha * xs[i];
+    return r;
+}
+}
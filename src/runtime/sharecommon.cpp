@@ -32,7 +32,7 @@ extern "C" LEAN_EXPORT uint64_t lean_sharecommon_hash(b_obj_arg o) {
     // hash relevant parts of the header
     unsigned init = hash(lean_ptr_tag(o), lean_ptr_other(o));
     // hash body
-    return hash_str(sz - header_sz, reinterpret_cast<unsigned char const *>(o) + header_sz, init);
+    return hash_bytes(sz - header_sz, reinterpret_cast<unsigned char const *>(o) + header_sz, init);
 }
 
 static obj_res mk_pair(obj_arg a, obj_arg b) {
@@ -75,9 +75,16 @@ public:
         return r;
     }
 
-    obj_res map_find(b_obj_arg k) {
+    // The result is borrowed from the map, or `nullptr` if `k` is not in the map.
+    b_obj_res map_find(b_obj_arg k) {
         lean_inc(m_map_find); lean_inc(m_map); lean_inc(k);
-        return lean_apply_2(m_map_find, m_map, k);
+        obj_res o = lean_apply_2(m_map_find, m_map, k);
+        if (o == lean_box(0))
+            return nullptr;
+        b_obj_res r = lean_ctor_get(o, 0);
+        lean_dec(o);
+        // The map still has a reference to `r`
+        return r;
     }
 
     void map_insert(obj_arg k, obj_arg v) {
@@ -85,9 +92,15 @@ public:
         m_map = lean_apply_3(m_map_insert, m_map, k, v);
     }
 
-    obj_res set_find(b_obj_arg o) {
+    // The result is borrowed from the set, or `nullptr` if there is no object equal to `o` in the set.
+    b_obj_res set_find(b_obj_arg o) {
         lean_inc(m_set_find); lean_inc(m_set); lean_inc(o);
-        return lean_apply_2(m_set_find, m_set, o);
+        obj_res opt = lean_apply_2(m_set_find, m_set, o);
+        if (opt == lean_box(0))
+            return nullptr;
+        b_obj_res r = lean_ctor_get(opt, 0);
+        lean_dec(opt);
+        return r;
     }
 
     void set_insert(obj_arg o) {
@@ -96,8 +109,191 @@ public:
     }
 };
 
+/*
+Hash-consing table used by the states of `StateFactory.native`. It contains the same two collections as the
+states created by `StateFactory.mk`, implemented as open addressing hash tables with linear probing:
+- `m_map` maps objects to their maximally shared representation, using pointer equality.
+- `m_set` contains the maximally shared objects, using `lean_sharecommon_eq`. We store their hash codes
+  so that they do not have to be recomputed when the table grows.
+The table owns a reference to all objects stored in it.
+*/
+class sharecommon_table {
+    struct map_entry {
+        lean_object * m_key;
+        lean_object * m_value;
+    };
+    struct set_entry {
+        lean_object * m_obj;
+        uint64        m_hash;
+    };
+    std::vector<map_entry> m_map;
+    size_t                 m_map_size = 0;
+    std::vector<set_entry> m_set;
+    size_t                 m_set_size = 0;
+
+    static uint64 ptr_hash(b_obj_arg o) { return hash(reinterpret_cast<size_t>(o) >> 3, 11); }
+
+    static size_t capacity_for(size_t n) {
+        size_t r = 16;
+        while (r < 2 * n) r *= 2;
+        return r;
+    }
+
+    void map_insert_core(std::vector<map_entry> & map, lean_object * k, lean_object * v) {
+        size_t mask = map.size() - 1;
+        size_t i    = ptr_hash(k) & mask;
+        while (map[i].m_key != nullptr) i = (i + 1) & mask;
+        map[i] = {k, v};
+    }
+
+    void set_insert_core(std::vector<set_entry> & set, lean_object * o, uint64 h) {
+        size_t mask = set.size() - 1;
+        size_t i    = h & mask;
+        while (set[i].m_obj != nullptr) i = (i + 1) & mask;
+        set[i] = {o, h};
+    }
+
+public:
+    explicit sharecommon_table(size_t capacity):
+        m_map(capacity_for(capacity), map_entry{nullptr, nullptr}),
+        m_set(capacity_for(capacity), set_entry{nullptr, 0}) {}
+
+    sharecommon_table(sharecommon_table const & t):
+        m_map(t.m_map), m_map_size(t.m_map_size), m_set(t.m_set), m_set_size(t.m_set_size) {
+        for (map_entry const & e : m_map) {
+            if (e.m_key) { lean_inc(e.m_key); lean_inc(e.m_value); }
+        }
+        for (set_entry const & e : m_set) {
+            if (e.m_obj) lean_inc(e.m_obj);
+        }
+    }
+
+    ~sharecommon_table() {
+        for (map_entry const & e : m_map) {
+            if (e.m_key) { lean_dec(e.m_key); lean_dec(e.m_value); }
+        }
+        for (set_entry const & e : m_set) {
+            if (e.m_obj) lean_dec(e.m_obj);
+        }
+    }
+
+    void for_each(b_obj_arg fn) const {
+        auto apply = [&](lean_object * o) { lean_inc(fn); lean_inc(o); lean_dec(lean_apply_1(fn, o)); };
+        for (map_entry const & e : m_map) {
+            if (e.m_key) { apply(e.m_key); apply(e.m_value); }
+        }
+        for (set_entry const & e : m_set) {
+            if (e.m_obj) apply(e.m_obj);
+        }
+    }
+
+    b_obj_res map_find(b_obj_arg k) const {
+        size_t mask = m_map.size() - 1;
+        for (size_t i = ptr_hash(k) & mask; m_map[i].m_key != nullptr; i = (i + 1) & mask) {
+            if (m_map[i].m_key == k)
+                return m_map[i].m_value;
+        }
+        return nullptr;
+    }
+
+    /* Remark: `k` must not be in the map yet. */
+    void map_insert(obj_arg k, obj_arg v) {
+        if (2 * (m_map_size + 1) > m_map.size()) {
+            std::vector<map_entry> new_map(2 * m_map.size(), map_entry{nullptr, nullptr});
+            for (map_entry const & e : m_map) {
+                if (e.m_key) map_insert_core(new_map, e.m_key, e.m_value);
+            }
+            m_map.swap(new_map);
+        }
+        map_insert_core(m_map, k, v);
+        m_map_size++;
+    }
+
+    b_obj_res set_find(b_obj_arg o, uint64 h) const {
+        size_t mask = m_set.size() - 1;
+        for (size_t i = h & mask; m_set[i].m_obj != nullptr; i = (i + 1) & mask) {
+            if (m_set[i].m_hash == h && lean_sharecommon_eq(m_set[i].m_obj, o))
+                return m_set[i].m_obj;
+        }
+        return nullptr;
+    }
+
+    /* Remark: there must not be an object equal to `o` in the set yet. */
+    void set_insert(obj_arg o, uint64 h) {
+        if (2 * (m_set_size + 1) > m_set.size()) {
+            std::vector<set_entry> new_set(2 * m_set.size(), set_entry{nullptr, 0});
+            for (set_entry const & e : m_set) {
+                if (e.m_obj) set_insert_core(new_set, e.m_obj, e.m_hash);
+            }
+            m_set.swap(new_set);
+        }
+        set_insert_core(m_set, o, h);
+        m_set_size++;
+    }
+};
+
+static lean_external_class * g_sharecommon_table_class = nullptr;
+
+static void sharecommon_table_finalizer(void * t) {
+    delete static_cast<sharecommon_table *>(t);
+}
+
+static void sharecommon_table_foreach(void * t, b_obj_arg fn) {
+    static_cast<sharecommon_table *>(t)->for_each(fn);
+}
+
+static bool is_sharecommon_table(b_obj_arg s) {
+    return !lean_is_scalar(s) && lean_is_external(s) && lean_get_external_class(s) == g_sharecommon_table_class;
+}
+
+/* opaque mkNativeState (capacity : USize) : NonScalar */
+extern "C" LEAN_EXPORT obj_res lean_sharecommon_mk_native_state(size_t capacity) {
+    return lean_alloc_external(g_sharecommon_table_class, new sharecommon_table(capacity));
+}
+
+/* State of `sharecommon_fn` for the states of `StateFactory.native`. The table is updated in place unless it is
+   shared, in which case it is copied first. */
+class sharecommon_native_state {
+    object *            m_obj;
+    sharecommon_table * m_table;
+    uint64              m_hash = 0; // hash code of the last object passed to `set_find`
+public:
+    sharecommon_native_state(b_obj_arg, obj_arg s) {
+        if (lean_is_exclusive(s)) {
+            m_obj = s;
+        } else {
+            sharecommon_table * t = static_cast<sharecommon_table *>(lean_get_external_data(s));
+            m_obj = lean_alloc_external(g_sharecommon_table_class, new sharecommon_table(*t));
+            lean_dec(s);
+        }
+        m_table = static_cast<sharecommon_table *>(lean_get_external_data(m_obj));
+    }
+
+    ~sharecommon_native_state() {
+        if (m_obj) lean_dec(m_obj);
+    }
+
+    obj_res pack(obj_arg a) {
+        obj_res r = mk_pair(a, m_obj);
+        m_obj = nullptr;
+        return r;
+    }
+
+    b_obj_res map_find(b_obj_arg k) { return m_table->map_find(k); }
+    void map_insert(obj_arg k, obj_arg v) { m_table->map_insert(k, v); }
+
+    b_obj_res set_find(b_obj_arg o) {
+        m_hash = lean_sharecommon_hash(o);
+        return m_table->set_find(o, m_hash);
+    }
+
+    // Remark: `o` must be the object passed to the last `set_find`.
+    void set_insert(obj_arg o) { m_table->set_insert(o, m_hash); }
+};
+
+template<class state>
 class sharecommon_fn {
-    sharecommon_state         m_state;
+    state                     m_state;
     std::vector<lean_object*> m_children;
     std::vector<lean_object*> m_todo;
 
@@ -124,11 +320,7 @@ class sharecommon_fn {
         }
 
         // Check whether we have already maximized sharing for `a`
-        obj_res o = m_state.map_find(a);
-        if (o != lean_box(0)) {
-            obj_res r = lean_ctor_get(o, 0);
-            lean_dec(o);
-            // The map still has a reference to `r`
+        if (b_obj_res r = m_state.map_find(a)) {
             m_children.push_back(r);
             // std::cout << "cached maximized " << r << "\n";
             return true;
@@ -142,12 +334,10 @@ class sharecommon_fn {
         lean_assert(m_todo.size() > 0);
         lean_assert(m_todo.back() == a);
         m_todo.pop_back();
-        obj_res opt_new_r = m_state.set_find(new_a);
-        if (opt_new_r != lean_box(0)) {
+        if (b_obj_res new_r = m_state.set_find(new_a)) {
             lean_dec(new_a); // we already have a maximally shared term equivalent to `new_a`
-            new_a = lean_ctor_get(opt_new_r, 0);
+            new_a = new_r;
             lean_inc(new_a);
-            lean_dec(opt_new_r);
             lean_inc(a);
             m_state.map_insert(a, new_a);
             // std::cout << "already maximized " << new_a << "\n";
@@ -191,13 +381,9 @@ class sharecommon_fn {
     void visit_string(b_obj_arg a) {
         size_t sz     = lean_string_size(a);
         size_t len    = lean_string_len(a);
-        lean_string_object * new_a = (lean_string_object*)lean_alloc_string(sz, sz, len);
-        lean_set_st_header((lean_object*)new_a, LeanString, 0);
-        new_a->m_size     = sz;
-        new_a->m_capacity = sz;
-        new_a->m_length   = len;
-        memcpy(new_a->m_data, lean_to_string(a)->m_data, sz);
-        save(a, (lean_object*)new_a);
+        lean_object * new_a = lean_alloc_string(sz, sz, len);
+        memcpy(const_cast<char *>(lean_string_cstr(new_a)), lean_string_cstr(a), sz);
+        save(a, new_a);
     }
 
     void visit_ctor(b_obj_arg a) {
@@ -256,11 +442,9 @@ public:
             }
         }
 
-        obj_res o = m_state.map_find(a);
-        lean_assert(o != lean_box(0));
-        obj_res r = lean_ctor_get(o, 0);
+        b_obj_res r = m_state.map_find(a);
+        lean_assert(r != nullptr);
         lean_inc(r);
-        lean_dec(o);
         lean_dec(a);
         return m_state.pack(r);
     }
@@ -268,7 +452,9 @@ public:
 
 // def State.shareCommon {α} {σ : @& StateFactory} (s : State σ) (a : α) : α × State σ
 extern "C" LEAN_EXPORT obj_res lean_state_sharecommon(b_obj_arg tc, obj_arg s, obj_arg a) {
-    return sharecommon_fn(tc, s)(a);
+    if (is_sharecommon_table(s))
+        return sharecommon_fn<sharecommon_native_state>(tc, s)(a);
+    return sharecommon_fn<sharecommon_state>(tc, s)(a);
 }
 
 
@@ -435,4 +621,11 @@ lean_object * sharecommon_persistent_fn::operator()(lean_object * e) {
     m_saved.push_back(object_ref(r, true));
     return r;
 }
+
+void initialize_sharecommon() {
+    g_sharecommon_table_class = lean_register_external_class(sharecommon_table_finalizer, sharecommon_table_foreach);
+}
+
+void finalize_sharecommon() {
+}
 };
@@ -14,6 +14,9 @@ namespace lean {
 extern "C" LEAN_EXPORT uint8 lean_sharecommon_eq(b_obj_arg o1, b_obj_arg o2);
 extern "C" LEAN_EXPORT uint64_t lean_sharecommon_hash(b_obj_arg o);
 
+void initialize_sharecommon();
+void finalize_sharecommon();
+
 /*
 A faster version of `sharecommon_fn` which only uses a local state.
 It optimizes the number of RC operations, the strategy for caching results,
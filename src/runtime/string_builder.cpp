@@ -0,0 +1,260 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <algorithm>
+#include <cstring>
+#include "runtime/object.h"
+#include "runtime/utf8.h"
+#include "runtime/debug.h"
+
+/*
+String builders accumulate pieces of text and produce the final `String` with a single allocation of the exact size.
+
+A builder is a constructor object with the fields `pieces`, `bounds` and `chunk`, and the scalar fields `size` and
+`length`, the total number of bytes and UTF-8 characters appended so far. `pieces` is an `Array` of `String`s and
+`ByteArray`s, and `bounds` is a scalar array storing for each piece the byte range `[begin, end)` that was appended.
+So appending a large string, substring or byte array only stores a reference to it, and is not copied until the
+builder is materialized.
+
+Short pieces and characters are instead copied into `chunk`, a `String` with spare capacity (or `box(0)` if there is
+none yet). When the chunk is full or a large piece is appended, the chunk becomes a piece and a new one is allocated
+on demand. Its capacity grows with the size of the builder, so the number of pieces stays logarithmic in the number of
+short appends.
+
+As for arrays, all updates take ownership of the builder and modify it in place when it is not shared.
+*/
+namespace lean {
+/* Pieces smaller than this many bytes are copied into the current chunk instead of being referenced. */
+static const size_t SB_COPY_THRESHOLD = 64;
+static const size_t SB_MIN_CHUNK      = 256;
+static const size_t SB_MAX_CHUNK      = 64 * 1024;
+
+static inline b_obj_res sb_pieces(b_obj_arg b) { return lean_ctor_get(b, 0); }
+static inline b_obj_res sb_bounds(b_obj_arg b) { return lean_ctor_get(b, 1); }
+static inline b_obj_res sb_chunk(b_obj_arg b) { return lean_ctor_get(b, 2); }
+static inline size_t sb_size(b_obj_arg b) { return lean_ctor_get_usize(b, 3); }
+static inline size_t sb_length(b_obj_arg b) { return lean_ctor_get_usize(b, 4); }
+
+static obj_res mk_builder(obj_arg pieces, obj_arg bounds, obj_arg chunk, size_t size, size_t length) {
+    object * b = lean_alloc_ctor(0, 3, 2 * sizeof(size_t));
+    lean_ctor_set(b, 0, pieces);
+    lean_ctor_set(b, 1, bounds);
+    lean_ctor_set(b, 2, chunk);
+    lean_ctor_set_usize(b, 3, size);
+    lean_ctor_set_usize(b, 4, length);
+    return b;
+}
+
+static obj_res ensure_exclusive_builder(obj_arg b) {
+    if (lean_is_exclusive(b))
+        return b;
+    lean_inc(sb_pieces(b));
+    lean_inc(sb_bounds(b));
+    lean_inc(sb_chunk(b));
+    object * r = mk_builder(sb_pieces(b), sb_bounds(b), sb_chunk(b), sb_size(b), sb_length(b));
+    lean_dec_ref(b);
+    return r;
+}
+
+static inline char * w_string_cstr(object * o) { return const_cast<char *>(lean_string_cstr(o)); }
+
+static inline char const * piece_data(b_obj_arg p) {
+    return lean_is_string(p) ? lean_string_cstr(p) : reinterpret_cast<char const *>(lean_sarray_cptr(p));
+}
+
+static obj_res bounds_push(obj_arg bs, size_t begin, size_t end) {
+    size_t sz = lean_sarray_size(bs);
+    if (!lean_is_exclusive(bs) || sz + 2 > lean_sarray_capacity(bs)) {
+        object * r = lean_alloc_sarray(sizeof(size_t), sz, std::max<size_t>(2 * sz + 2, 8));
+        memcpy(lean_sarray_cptr(r), lean_sarray_cptr(bs), sz * sizeof(size_t));
+        lean_dec_ref(bs);
+        bs = r;
+    }
+    size_t * d = reinterpret_cast<size_t *>(lean_sarray_cptr(bs));
+    d[sz]     = begin;
+    d[sz + 1] = end;
+    lean_to_sarray(bs)->m_size = sz + 2;
+    return bs;
+}
+
+/* Append `[begin, end)` of the string or byte array `p` as a new piece. `b` must be exclusive. */
+static void push_piece(object * b, obj_arg p, size_t begin, size_t end) {
+    lean_ctor_set(b, 0, lean_array_push(sb_pieces(b), p));
+    lean_ctor_set(b, 1, bounds_push(sb_bounds(b), begin, end));
+}
+
+/* Turn the current chunk into a piece, if it is not empty. `b` must be exclusive. */
+static void flush_chunk(object * b) {
+    object * c = sb_chunk(b);
+    if (lean_is_scalar(c))
+        return;
+    size_t sz = lean_string_size(c) - 1;
+    lean_ctor_set(b, 2, lean_box(0));
+    if (sz == 0)
+        lean_dec_ref(c);
+    else
+        push_piece(b, c, 0, sz);
+}
+
+/* Return a pointer to the end of a chunk with room for `n` more bytes. `b` must be exclusive. */
+static char * chunk_reserve(object * b, size_t n) {
+    object * c = sb_chunk(b);
+    if (lean_is_scalar(c) || !lean_is_exclusive(c) || lean_string_capacity(c) - lean_string_size(c) < n) {
+        flush_chunk(b);
+        size_t cap = std::max(n, std::min(std::max(sb_size(b), SB_MIN_CHUNK), SB_MAX_CHUNK));
+        c = lean_alloc_string(1, cap + 1, 0);
+        w_string_cstr(c)[0] = 0;
+        lean_ctor_set(b, 2, c);
+    }
+    return w_string_cstr(c) + lean_string_size(c) - 1;
+}
+
+/* Record that `n` bytes encoding `len` characters were written at the end of the chunk. `b` must be exclusive. */
+static void chunk_commit(object * b, size_t n, size_t len) {
+    lean_string_object * c = lean_to_string(sb_chunk(b));
+    c->m_size   += n;
+    c->m_length += len;
+    c->m_data[c->m_size - 1] = 0;
+    lean_ctor_set_usize(b, 3, sb_size(b) + n);
+    lean_ctor_set_usize(b, 4, sb_length(b) + len);
+}
+
+/* Append `[begin, end)` of the string or byte array `p`, which encodes `len` characters. */
+static obj_res builder_append(obj_arg b, obj_arg p, size_t begin, size_t end, size_t len) {
+    size_t n = end - begin;
+    if (n == 0) {
+        lean_dec(p);
+        return b;
+    }
+    b = ensure_exclusive_builder(b);
+    if (n < SB_COPY_THRESHOLD) {
+        memcpy(chunk_reserve(b, n), piece_data(p) + begin, n);
+        chunk_commit(b, n, len);
+        lean_dec(p);
+    } else {
+        flush_chunk(b);
+        push_piece(b, p, begin, end);
+        lean_ctor_set_usize(b, 3, sb_size(b) + n);
+        lean_ctor_set_usize(b, 4, sb_length(b) + len);
+    }
+    return b;
+}
+
+static inline bool is_utf8_first_byte(unsigned char c) {
+    return (c & 0x80) == 0 || (c & 0xe0) == 0xc0 || (c & 0xf0) == 0xe0 || (c & 0xf8) == 0xf0;
+}
+
+extern "C" LEAN_EXPORT obj_res lean_string_builder_mk(obj_arg) {
+    return mk_builder(lean_alloc_array(0, 0), lean_alloc_sarray(sizeof(size_t), 0, 0), lean_box(0), 0, 0);
+}
+
+// String.Builder.utf8ByteSize : @& String.Builder → Nat
+extern "C" LEAN_EXPORT obj_res lean_string_builder_size(b_obj_arg b) {
+    return lean_usize_to_nat(sb_size(b));
+}
+
+// String.Builder.length : @& String.Builder → Nat
+extern "C" LEAN_EXPORT obj_res lean_string_builder_length(b_obj_arg b) {
+    return lean_usize_to_nat(sb_length(b));
+}
+
+// String.Builder.append : String.Builder → String → String.Builder
+extern "C" LEAN_EXPORT obj_res lean_string_builder_append(obj_arg b, obj_arg s) {
+    return builder_append(b, s, 0, lean_string_size(s) - 1, lean_string_len(s));
+}
+
+// String.Builder.appendSubstring : String.Builder → @& Substring → String.Builder
+extern "C" LEAN_EXPORT obj_res lean_string_builder_append_substring(obj_arg b, b_obj_arg ss) {
+    object * s  = lean_ctor_get(ss, 0);
+    object * b0 = lean_ctor_get(ss, 1);
+    object * e0 = lean_ctor_get(ss, 2);
+    /* Same normalization of the positions as in `lean_string_utf8_extract`. */
+    if (!lean_is_scalar(b0) || !lean_is_scalar(e0))
+        return b;
+    size_t begin = lean_unbox(b0);
+    size_t end   = lean_unbox(e0);
+    char const * str = lean_string_cstr(s);
+    size_t sz = lean_string_size(s) - 1;
+    if (begin >= end || begin >= sz || !is_utf8_first_byte(str[begin]))
+        return b;
+    if (end > sz || !is_utf8_first_byte(str[end]))
+        end = sz;
+    size_t len = begin == 0 && end == sz ? lean_string_len(s) : utf8_strlen(str + begin, end - begin);
+    lean_inc(s);
+    return builder_append(b, s, begin, end, len);
+}
+
+// String.Builder.appendUTF8 : String.Builder → ByteArray → String.Builder
+extern "C" LEAN_EXPORT obj_res lean_string_builder_append_utf8(obj_arg b, obj_arg a) {
+    size_t sz = lean_sarray_size(a);
+    size_t len = utf8_strlen(reinterpret_cast<char const *>(lean_sarray_cptr(a)), sz);
+    return builder_append(b, a, 0, sz, len);
+}
+
+// String.Builder.push : String.Builder → Char → String.Builder
+extern "C" LEAN_EXPORT obj_res lean_string_builder_push(obj_arg b, unsigned c) {
+    b = ensure_exclusive_builder(b);
+    unsigned n = push_unicode_scalar(chunk_reserve(b, 4), c);
+    chunk_commit(b, n, 1);
+    return b;
+}
+
+// String.Builder.pushn : String.Builder → Char → @& Nat → String.Builder
+extern "C" LEAN_EXPORT obj_res lean_string_builder_pushn(obj_arg b, unsigned c, b_obj_arg n0) {
+    if (!lean_is_scalar(n0))
+        lean_internal_panic_out_of_memory();
+    size_t n = lean_unbox(n0);
+    if (n == 0)
+        return b;
+    b = ensure_exclusive_builder(b);
+    char enc[4];
+    unsigned k = push_unicode_scalar(enc, c);
+    while (n > 0) {
+        size_t m = std::min(n, SB_MAX_CHUNK);
+        char * d = chunk_reserve(b, m * k);
+        if (k == 1) {
+            memset(d, enc[0], m);
+        } else {
+            for (size_t i = 0; i < m; i++)
+                memcpy(d + i * k, enc, k);
+        }
+        chunk_commit(b, m * k, m);
+        n -= m;
+    }
+    return b;
+}
+
+// String.Builder.toString : @& String.Builder → String
+extern "C" LEAN_EXPORT obj_res lean_string_builder_to_string(b_obj_arg b) {
+    object * pieces = sb_pieces(b);
+    size_t const * bounds = reinterpret_cast<size_t const *>(lean_sarray_cptr(sb_bounds(b)));
+    size_t num = lean_array_size(pieces);
+    object * c = sb_chunk(b);
+    bool has_chunk = !lean_is_scalar(c) && lean_string_size(c) > 1;
+    if (num == 1 && !has_chunk) {
+        /* A single string that was appended as a whole can be shared. */
+        object * p = lean_array_get_core(pieces, 0);
+        if (lean_is_string(p) && bounds[0] == 0 && bounds[1] == lean_string_size(p) - 1) {
+            lean_inc(p);
+            return p;
+        }
+    }
+    size_t sz = sb_size(b);
+    object * r = lean_alloc_string(sz + 1, sz + 1, sb_length(b));
+    char * d = w_string_cstr(r);
+    for (size_t i = 0; i < num; i++) {
+        size_t n = bounds[2*i + 1] - bounds[2*i];
+        memcpy(d, piece_data(lean_array_get_core(pieces, i)) + bounds[2*i], n);
+        d += n;
+    }
+    if (has_chunk) {
+        size_t n = lean_string_size(c) - 1;
+        memcpy(d, lean_string_cstr(c), n);
+        d += n;
+    }
+    lean_assert(d == w_string_cstr(r) + sz);
+    *d = 0;
+    return r;
+}
+}
@@ -162,6 +162,16 @@ void lthread::join() { m_imp->join(); }
 
 LEAN_THREAD_VALUE(bool, g_finalizing, false);
 
+#define LEAN_PARK_NUM_BUCKETS 256
+/* We never delete the buckets since threads may still be parked when the process exits. */
+static parking_bucket * g_parking_buckets = new parking_bucket[LEAN_PARK_NUM_BUCKETS];
+
+parking_bucket & get_parking_bucket(void const * addr) {
+    size_t h = reinterpret_cast<size_t>(addr);
+    h = (h >> 4) ^ (h >> 12);
+    return g_parking_buckets[h % LEAN_PARK_NUM_BUCKETS];
+}
+
 bool in_thread_finalization() {
     return g_finalizing;
 }
@@ -252,4 +252,44 @@ LEAN_EXPORT void register_thread_local_reset_fn(std::function<void()> fn);
    We invoke this function before processing a command
    and before executing a task. */
 LEAN_EXPORT void reset_thread_local();
+
+/* Support for waiting until a condition on a memory location holds, without burning a core.
+
+   `park_until(addr, ready)` spins for a short while and then blocks the current thread until
+   `ready()` returns true. Any thread that may make `ready()` true for `addr` must invoke
+   `unpark_all(addr)` afterwards. Waiters are stored in a fixed table of buckets indexed by the
+   address, so the memory location itself does not need to store any extra data. */
+struct parking_bucket {
+    mutex              m_mutex;
+    condition_variable m_cv;
+    atomic<unsigned>   m_num_waiters{0};
+};
+
+#define LEAN_PARK_NUM_SPINS  64
+#define LEAN_PARK_NUM_YIELDS 16
+
+LEAN_EXPORT parking_bucket & get_parking_bucket(void const * addr);
+
+template<typename F> void park_until(void const * addr, F && ready) {
+    for (unsigned i = 0; i < LEAN_PARK_NUM_SPINS + LEAN_PARK_NUM_YIELDS; i++) {
+        if (ready())
+            return;
+        if (i >= LEAN_PARK_NUM_SPINS)
+            this_thread::yield();
+    }
+    parking_bucket & b = get_parking_bucket(addr);
+    unique_lock<mutex> lock(b.m_mutex);
+    b.m_num_waiters++;
+    while (!ready())
+        b.m_cv.wait(lock);
+    b.m_num_waiters--;
+}
+
+inline void unpark_all(void const * addr) {
+    parking_bucket & b = get_parking_bucket(addr);
+    if (b.m_num_waiters.load() != 0) {
+        lock_guard<mutex> lock(b.m_mutex);
+        b.m_cv.notify_all();
+    }
+}
 }
@@ -5,12 +5,50 @@ Released under Apache 2.0 license as described in the file LICENSE.
 Author: Leonardo de Moura
 */
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include "runtime/debug.h"
 #include "runtime/optional.h"
 #include "runtime/utf8.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEAN_UTF8_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LEAN_UTF8_NEON
+#endif
+
 namespace lean {
+/* ASCII fast path used by the validation, counting and decoding procedures below.
+   The 16-byte kernels only use instructions that are part of the base x86-64 (SSE2) and
+   AArch64 (NEON) instruction sets, so no runtime CPU dispatch is needed. */
+size_t utf8_ascii_prefix(char const * str, size_t size) {
+    size_t i = 0;
+#if defined(LEAN_UTF8_SSE2)
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(str + i));
+        if (_mm_movemask_epi8(v) != 0)
+            break;
+    }
+#elif defined(LEAN_UTF8_NEON)
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<uint8_t const *>(str + i));
+        if (vmaxvq_u8(v) >= 0x80)
+            break;
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, str + i, sizeof(w));
+        if ((w & 0x8080808080808080ull) != 0)
+            break;
+    }
+    while (i < size && static_cast<unsigned char>(str[i]) < 0x80)
+        i++;
+    return i;
+}
+
 bool is_utf8_next(unsigned char c) { return (c & 0xC0) == 0x80; }
 
 unsigned get_utf8_size(unsigned char c) {
@@ -50,6 +88,12 @@ extern "C" LEAN_EXPORT size_t lean_utf8_n_strlen(char const * str, size_t sz) {
     size_t r = 0;
     size_t i = 0;
     while (i < sz) {
+        if (static_cast<unsigned char>(str[i]) < 0x80) {
+            size_t n = utf8_ascii_prefix(str + i, sz - i);
+            r += n;
+            i += n;
+            continue;
+        }
         unsigned d = get_utf8_size(str[i]);
         r++;
         i += d;
@@ -216,6 +260,12 @@ unsigned next_utf8(std::string const & str, size_t & i) {
 void utf8_decode(std::string const & str, std::vector<unsigned> & out) {
     size_t i = 0;
     while (i < str.size()) {
+        if (static_cast<unsigned char>(str[i]) < 0x80) {
+            size_t n = utf8_ascii_prefix(str.data() + i, str.size() - i);
+            out.insert(out.end(), reinterpret_cast<uchar const *>(str.data() + i), reinterpret_cast<uchar const *>(str.data() + i + n));
+            i += n;
+            continue;
+        }
         out.push_back(next_utf8(str, i));
     }
 }
@@ -269,6 +319,12 @@ bool validate_utf8_one(uint8_t const * str, size_t size, size_t & pos) {
 
 bool validate_utf8(uint8_t const * str, size_t size, size_t & pos, size_t & i) {
     while (pos < size) {
+        if (str[pos] < 0x80) {
+            size_t n = utf8_ascii_prefix(reinterpret_cast<char const *>(str + pos), size - pos);
+            pos += n;
+            i   += n;
+            continue;
+        }
         if (!validate_utf8_one(str, size, pos)) return false;
         i++;
     }
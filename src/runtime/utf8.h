@@ -23,6 +23,8 @@ LEAN_EXPORT size_t utf8_strlen(std::string const & str);
 /* Return the length of the string `str` encoded using UTF8.
    `str` may contain null characters. */
 LEAN_EXPORT size_t utf8_strlen(char const * str, size_t sz);
+/* Return the length of the longest prefix of `str[0, size)` containing only ASCII characters. */
+LEAN_EXPORT size_t utf8_ascii_prefix(char const * str, size_t size);
 LEAN_EXPORT optional<size_t> utf8_char_pos(char const * str, size_t char_idx);
 LEAN_EXPORT char const * get_utf8_last_char(char const * str);
 LEAN_EXPORT std::string utf8_trim(std::string const & s);
@@ -4,6 +4,8 @@ Released under Apache 2.0 license as described in the file LICENSE.
 
 Author: Sofia Rodrigues, Henrik Böving
 */
+#include <cstring>
+#include "runtime/thread.h"
 #include "runtime/uv/event_loop.h"
 
 
@@ -15,9 +17,43 @@ thread. Once this notification arrives the event loop suspends its own execution
 that protects it. This mutex can then be taken by another thread that wants to work with the event
 loop. After that work is done it signals a condition variable that the event loop is waiting on
 to continue its execution.
+
+Stopping the loop for every request is expensive when many requests are made at once, so work that
+does not need to report a result synchronously is instead pushed onto a lock-free stack with
+`event_loop_submit`. The same `uv_async_t` notification then runs everything submitted so far in a
+single batch without stopping the loop. `event_loop_lock` runs pending work as well, so that work
+submitted by a thread is always done before that thread uses the loop directly. The only exception is
+submitted work that locks the loop itself: it must not overtake work submitted before it, so the
+nested lock leaves the pending work to the drain that is already running.
 */
 
 namespace lean {
+
+lean_object * create_promise() {
+    lean_object * prom_res = lean_io_promise_new(lean_io_mk_world());
+    lean_object * promise = lean_ctor_get(prom_res, 0);
+    lean_inc(promise);
+    lean_dec(prom_res);
+
+    return promise;
+}
+
+void resolve_promise(b_obj_arg promise, obj_arg value) {
+    lean_object * res = lean_io_promise_resolve(value, promise, lean_io_mk_world());
+    lean_dec(res);
+}
+
+lean_object * byte_array_fit(obj_arg byte_array, size_t size) {
+    lean_sarray_set_size(byte_array, size);
+    if (lean_sarray_capacity(byte_array) / 2 <= size) {
+        return byte_array;
+    }
+    lean_object * r = lean_alloc_sarray(1, size, size);
+    memcpy(lean_sarray_cptr(r), lean_sarray_cptr(byte_array), size);
+    lean_dec(byte_array);
+    return r;
+}
+
 #ifndef LEAN_EMSCRIPTEN
 using namespace std;
 
@@ -32,9 +68,46 @@ static void check_uv(int result, const char * msg) {
     }
 }
 
-// The callback that stops the loop when it's called.
+// Set while this thread runs submitted work, see `event_loop_run_submissions`.
+LEAN_THREAD_VALUE(bool, g_running_submissions, false);
+
+// Runs all submitted work in submission order, the event loop has to be locked.
+static void event_loop_run_submissions(event_loop_t * event_loop) {
+    /*
+     * Work that locks the event loop again would otherwise start a nested drain here, which runs work
+     * submitted in the meantime before the rest of the current batch. Instead the outer drain picks
+     * it up once its batch is done.
+     */
+    if (g_running_submissions) {
+        return;
+    }
+    g_running_submissions = true;
+
+    event_loop_work * work;
+    while ((work = event_loop->submissions.exchange(nullptr, std::memory_order_acquire)) != nullptr) {
+        // The stack has the newest submission on top.
+        event_loop_work * prev = nullptr;
+        while (work != nullptr) {
+            event_loop_work * next = work->m_next;
+            work->m_next = prev;
+            prev = work;
+            work = next;
+        }
+
+        while (prev != nullptr) {
+            event_loop_work * next = prev->m_next;
+            prev->run();
+            delete prev;
+            prev = next;
+        }
+    }
+
+    g_running_submissions = false;
+}
+
+// The callback that runs submitted work when the loop is woken up.
 void async_callback(uv_async_t * handle) {
-    uv_stop(handle->loop);
+    event_loop_run_submissions((event_loop_t*)handle->data);
 }
 
 // Interrupts the event loop and stops it so it can receive future requests.
@@ -49,8 +122,10 @@ void event_loop_init(event_loop_t * event_loop) {
     event_loop->loop = uv_default_loop();
     check_uv(uv_mutex_init_recursive(&event_loop->mutex), "Failed to initialize mutex");
     check_uv(uv_cond_init(&event_loop->cond_var), "Failed to initialize condition variable");
-    check_uv(uv_async_init(event_loop->loop, &event_loop->async, NULL), "Failed to initialize async");
+    check_uv(uv_async_init(event_loop->loop, &event_loop->async, async_callback), "Failed to initialize async");
+    event_loop->async.data = event_loop;
     event_loop->n_waiters = 0;
+    event_loop->submissions = nullptr;
 }
 
 // Locks the event loop for the side of the requesters.
@@ -61,6 +136,7 @@ void event_loop_lock(event_loop_t * event_loop) {
         uv_mutex_lock(&event_loop->mutex);
         event_loop->n_waiters--;
     }
+    event_loop_run_submissions(event_loop);
 }
 
 // Unlock event loop
@@ -71,6 +147,21 @@ void event_loop_unlock(event_loop_t * event_loop) {
     uv_mutex_unlock(&event_loop->mutex);
 }
 
+// Submits `work` to be run on the event loop, see `event_loop_submit`.
+void event_loop_submit_work(event_loop_t * event_loop, event_loop_work * work) {
+    event_loop_work * head = event_loop->submissions.load(std::memory_order_relaxed);
+    do {
+        work->m_next = head;
+    } while (!event_loop->submissions.compare_exchange_weak(head, work, std::memory_order_release, std::memory_order_relaxed));
+
+    // If the stack was not empty, a notification is already on its way.
+    if (head == nullptr) {
+        int result = uv_async_send(&event_loop->async);
+        (void)result;
+        lean_assert(result == 0);
+    }
+}
+
 // Runs the loop and stops when it needs to register new requests.
 void event_loop_run_loop(event_loop_t * event_loop) {
     while (uv_loop_alive(event_loop->loop)) {
@@ -82,9 +173,10 @@ void event_loop_run_loop(event_loop_t * event_loop) {
 
         uv_run(event_loop->loop, UV_RUN_ONCE);
         /*
-         * We leave `uv_run` only when `uv_stop` is called as there is always the `uv_async_t` so
-         * we can never run out of things to wait on. `uv_stop` is only called from `async_callback`
-         * when another thread wants to work with the event loop so we need to give up the mutex.
+         * There is always the `uv_async_t` so we can never run out of things to wait on, and we
+         * leave `uv_run` after every iteration. An iteration is cut short by `uv_async_send`, either
+         * because work was submitted, which `async_callback` has run by now, or because another
+         * thread wants to work with the event loop so we need to give up the mutex.
          */
 
         uv_mutex_unlock(&event_loop->mutex);
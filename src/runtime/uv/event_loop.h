@@ -5,6 +5,8 @@ Released under Apache 2.0 license as described in the file LICENSE.
 Author: Sofia Rodrigues
 */
 #pragma once
+#include <atomic>
+#include <utility>
 #include <lean/lean.h>
 #include "runtime/io.h"
 #include "runtime/object.h"
@@ -17,6 +19,20 @@ void initialize_libuv_loop();
 using namespace std;
 #include <uv.h>
 
+// Work submitted to the event loop with `event_loop_submit`.
+struct event_loop_work {
+    event_loop_work * m_next = nullptr;
+    virtual ~event_loop_work() {}
+    virtual void run() = 0;
+};
+
+template<typename F>
+struct event_loop_work_fn : public event_loop_work {
+    F m_fn;
+    explicit event_loop_work_fn(F && fn) : m_fn(std::move(fn)) {}
+    void run() override { m_fn(); }
+};
+
 // Event loop structure for managing asynchronous events and synchronization across multiple threads.
 typedef struct {
     uv_loop_t  * loop;      // The libuv event loop.
@@ -24,6 +40,7 @@ typedef struct {
     uv_cond_t    cond_var;  // Condition variable for signaling that `loop` is free.
     uv_async_t   async;     // Async handle to interrupt `loop`.
     _Atomic(int) n_waiters; // Atomic counter for managing waiters for `loop`.
+    std::atomic<event_loop_work *> submissions; // Lock-free stack of work that was not run yet.
 } event_loop_t;
 
 // The multithreaded event loop object for all tasks in the task manager.
@@ -36,9 +53,27 @@ void event_loop_cleanup(event_loop_t *event_loop);
 void event_loop_lock(event_loop_t *event_loop);
 void event_loop_unlock(event_loop_t *event_loop);
 void event_loop_run_loop(event_loop_t *event_loop);
+void event_loop_submit_work(event_loop_t *event_loop, event_loop_work *work);
+
+// Runs `fn` on the event loop without waiting for it. Submitting does not stop the loop, all work
+// submitted in the meantime is run in one batch on its next iteration. Work is run in submission
+// order, and always before any other thread acquires the loop with `event_loop_lock`. Use this for
+// operations that cannot fail synchronously or that report their errors through a promise.
+template<typename F>
+void event_loop_submit(event_loop_t *event_loop, F fn) {
+    event_loop_submit_work(event_loop, new event_loop_work_fn<F>(std::move(fn)));
+}
 
 #endif
 
+// =======================================
+// Helpers for primitives that report their result through a promise.
+lean_object * create_promise();
+void resolve_promise(b_obj_arg promise, obj_arg value);
+// Sets the size of the exclusive `byte_array` that received `size` bytes, and replaces it with a copy
+// of exactly that size if it would otherwise keep much more unused capacity alive.
+lean_object * byte_array_fit(obj_arg byte_array, size_t size);
+
 // =======================================
 // Global event loop manipulation functions
 extern "C" LEAN_EXPORT lean_obj_res lean_uv_event_loop_configure(b_obj_arg options, obj_arg /* w */ );
@@ -0,0 +1,326 @@
+/*
+Copyright (c) 2024 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "runtime/uv/fs.h"
+
+/*
+Asynchronous filesystem operations. Every operation is submitted to the global event loop, which
+hands it to the libuv thread pool, and immediately returns an `IO.Promise (Except IO.Error α)`. The
+promise is resolved from the event loop once the operation completes, so no Lean task is blocked
+while the kernel does the work.
+*/
+
+namespace lean {
+#ifndef LEAN_EMSCRIPTEN
+
+using namespace std;
+
+// The finalizer of the `File`.
+void lean_uv_file_finalizer(void* ptr) {
+    lean_uv_file_object * file = (lean_uv_file_object*) ptr;
+
+    uv_file fd = file->m_fd.load();
+    if (fd >= 0) {
+        // Closing is cheap, do it synchronously instead of keeping the object alive for a callback.
+        uv_fs_t req;
+
+        event_loop_lock(&global_ev);
+        uv_fs_close(global_ev.loop, &req, fd, NULL);
+        event_loop_unlock(&global_ev);
+
+        uv_fs_req_cleanup(&req);
+    }
+
+    delete file;
+}
+
+void initialize_libuv_fs() {
+    g_uv_file_external_class = lean_register_external_class(lean_uv_file_finalizer, [](void* obj, lean_object* f) {});
+}
+
+// Allocates a request. `file` and `buffer` are owned by the request until it is finished.
+static lean_uv_fs_req * fs_req_new(lean_object * file, lean_object * buffer) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)malloc(sizeof(lean_uv_fs_req));
+    req->m_promise = create_promise();
+    req->m_file = file;
+    req->m_buffer = buffer;
+    req->m_uv_fs.data = req;
+    return req;
+}
+
+static void fs_req_free(lean_uv_fs_req * req) {
+    lean_dec(req->m_promise);
+    if (req->m_file != NULL) {
+        lean_dec(req->m_file);
+    }
+    if (req->m_buffer != NULL) {
+        lean_dec(req->m_buffer);
+    }
+    uv_fs_req_cleanup(&req->m_uv_fs);
+    free(req);
+}
+
+// Resolves the promise of `req` with `value` and frees the request. Called from the event loop.
+static void fs_req_finish(lean_uv_fs_req * req, lean_object * value) {
+    resolve_promise(req->m_promise, value);
+    fs_req_free(req);
+}
+
+// Converts the error code `err` of a failed request into an `IO.Error`, mentioning the path of the
+// request if it has one.
+static lean_object * fs_req_error(lean_uv_fs_req * req, int err) {
+    if (req->m_uv_fs.path != NULL) {
+        lean_object * path = lean_mk_string(req->m_uv_fs.path);
+        lean_object * e = lean_decode_uv_error(err, path);
+        lean_dec(path);
+        return e;
+    } else {
+        return lean_decode_uv_error(err, NULL);
+    }
+}
+
+// Submits `req` to the event loop. `submit` starts the libuv operation and returns its status; it
+// runs on the event loop, so it must not refer to anything that `req` does not keep alive. If
+// starting the operation fails, the callback is never called and the promise is resolved with the
+// error right away.
+template<typename F>
+static lean_obj_res fs_req_submit(lean_uv_fs_req * req, b_obj_arg path, F submit) {
+    // The callback may run and free `req` as soon as it is submitted.
+    lean_object * promise = req->m_promise;
+    lean_inc(promise);
+    if (path != NULL) {
+        // `path` is read and released by the event loop thread.
+        lean_mark_mt(path);
+        lean_inc(path);
+    }
+
+    event_loop_submit(&global_ev, [req, path, submit]() {
+        int result = submit(&req->m_uv_fs);
+        if (result < 0) {
+            fs_req_finish(req, mk_except_err(lean_decode_uv_error(result, path)));
+        }
+        if (path != NULL) {
+            lean_dec(path);
+        }
+    });
+
+    return lean_io_result_mk_ok(promise);
+}
+
+static void fs_open_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+        return;
+    }
+
+    lean_uv_file_object * file = new lean_uv_file_object;
+    file->m_fd.store((uv_file)uv_fs->result);
+
+    lean_object * obj = lean_uv_file_new(file);
+    lean_mark_mt(obj);
+
+    fs_req_finish(req, mk_except_ok(obj));
+}
+
+/* Std.Internal.UV.FS.File.open (path : @& System.FilePath) (mode : IO.FS.Mode) : IO (IO.Promise (Except IO.Error File)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_open(b_obj_arg path, uint8_t mode, obj_arg /* w */) {
+    // Keep in sync with `lean_io_prim_handle_mk`.
+    int flags = 0;
+#ifdef LEAN_WINDOWS
+    flags |= O_BINARY;
+    flags |= O_NOINHERIT;
+#else
+    flags |= O_CLOEXEC;
+#endif
+    switch (mode) {
+    case 0: flags |= O_RDONLY; break;  // read
+    case 1: flags |= O_WRONLY | O_CREAT | O_TRUNC; break;  // write
+    case 2: flags |= O_WRONLY | O_CREAT | O_TRUNC | O_EXCL; break;  // writeNew
+    case 3: flags |= O_RDWR; break;  // readWrite
+    case 4: flags |= O_WRONLY | O_CREAT | O_APPEND; break;  // append
+    }
+
+    lean_uv_fs_req * req = fs_req_new(NULL, NULL);
+    return fs_req_submit(req, path, [=](uv_fs_t * uv_fs) {
+        return uv_fs_open(global_ev.loop, uv_fs, lean_string_cstr(path), flags, 0666, fs_open_cb);
+    });
+}
+
+static void fs_read_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+        return;
+    }
+
+    lean_object * buffer = byte_array_fit(req->m_buffer, uv_fs->result);
+    req->m_buffer = NULL;
+
+    fs_req_finish(req, mk_except_ok(buffer));
+}
+
+/* Std.Internal.UV.FS.File.read (file : @& File) (nbytes : USize) (offset : Int64) : IO (IO.Promise (Except IO.Error ByteArray)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read(b_obj_arg file, size_t nbytes, int64_t offset, obj_arg /* w */) {
+    lean_inc(file);
+    // The buffer is only referenced by the request until it is handed to the promise, so it can
+    // stay single threaded.
+    lean_object * buffer = lean_alloc_sarray(1, 0, nbytes);
+
+    lean_uv_fs_req * req = fs_req_new(file, buffer);
+    uv_file fd = lean_to_uv_file(file)->m_fd.load();
+    return fs_req_submit(req, NULL, [=](uv_fs_t * uv_fs) {
+        uv_buf_t buf = uv_buf_init((char*)lean_sarray_cptr(buffer), nbytes);
+        return uv_fs_read(global_ev.loop, uv_fs, fd, &buf, 1, offset, fs_read_cb);
+    });
+}
+
+static void fs_write_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+    } else {
+        fs_req_finish(req, mk_except_ok(lean_box_uint64(uv_fs->result)));
+    }
+}
+
+/* Std.Internal.UV.FS.File.write (file : @& File) (data : ByteArray) (offset : Int64) : IO (IO.Promise (Except IO.Error UInt64)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_write(b_obj_arg file, obj_arg data, int64_t offset, obj_arg /* w */) {
+    lean_inc(file);
+    // `data` may be shared and is released by the event loop thread.
+    lean_mark_mt(data);
+
+    lean_uv_fs_req * req = fs_req_new(file, data);
+    uv_file fd = lean_to_uv_file(file)->m_fd.load();
+    return fs_req_submit(req, NULL, [=](uv_fs_t * uv_fs) {
+        uv_buf_t buf = uv_buf_init((char*)lean_sarray_cptr(data), lean_sarray_size(data));
+        return uv_fs_write(global_ev.loop, uv_fs, fd, &buf, 1, offset, fs_write_cb);
+    });
+}
+
+static void fs_unit_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+    } else {
+        fs_req_finish(req, mk_except_ok(lean_box(0)));
+    }
+}
+
+/* Std.Internal.UV.FS.File.close (file : @& File) : IO (IO.Promise (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_close(b_obj_arg file, obj_arg /* w */) {
+    lean_uv_file_object * f = lean_to_uv_file(file);
+    // Later operations on the file fail with `EBADF` instead of using a reused descriptor, and a
+    // concurrent `close` gets -1 instead of closing the descriptor a second time.
+    uv_file fd = f->m_fd.exchange(-1);
+
+    lean_inc(file);
+    lean_uv_fs_req * req = fs_req_new(file, NULL);
+    return fs_req_submit(req, NULL, [=](uv_fs_t * uv_fs) {
+        return uv_fs_close(global_ev.loop, uv_fs, fd, fs_unit_cb);
+    });
+}
+
+static lean_object * uv_timespec_to_obj(uv_timespec_t const & ts) {
+    lean_object * o = lean_alloc_ctor(0, 1, sizeof(uint32_t));
+    lean_ctor_set(o, 0, lean_int64_to_int(ts.tv_sec));
+    lean_ctor_set_uint32(o, sizeof(lean_object *), ts.tv_nsec);
+    return o;
+}
+
+static void fs_stat_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+        return;
+    }
+
+    // Keep in sync with `lean_io_metadata`.
+    uv_stat_t const & st = uv_fs->statbuf;
+    lean_object * mdata = lean_alloc_ctor(0, 2, sizeof(uint64_t) + sizeof(uint8_t));
+    lean_ctor_set(mdata, 0, uv_timespec_to_obj(st.st_atim));
+    lean_ctor_set(mdata, 1, uv_timespec_to_obj(st.st_mtim));
+    lean_ctor_set_uint64(mdata, 2 * sizeof(lean_object *), st.st_size);
+    lean_ctor_set_uint8(mdata, 2 * sizeof(lean_object *) + sizeof(uint64_t),
+                        S_ISDIR(st.st_mode) ? 0 :
+                        S_ISREG(st.st_mode) ? 1 :
+#ifndef LEAN_WINDOWS
+                        S_ISLNK(st.st_mode) ? 2 :
+#endif
+                        3);
+
+    fs_req_finish(req, mk_except_ok(mdata));
+}
+
+/* Std.Internal.UV.FS.metadata (path : @& System.FilePath) : IO (IO.Promise (Except IO.Error IO.FS.Metadata)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_stat(b_obj_arg path, obj_arg /* w */) {
+    lean_uv_fs_req * req = fs_req_new(NULL, NULL);
+    return fs_req_submit(req, path, [=](uv_fs_t * uv_fs) {
+        return uv_fs_stat(global_ev.loop, uv_fs, lean_string_cstr(path), fs_stat_cb);
+    });
+}
+
+static void fs_scandir_cb(uv_fs_t * uv_fs) {
+    lean_uv_fs_req * req = (lean_uv_fs_req*)uv_fs->data;
+
+    if (uv_fs->result < 0) {
+        fs_req_finish(req, mk_except_err(fs_req_error(req, uv_fs->result)));
+        return;
+    }
+
+    lean_object * arr = lean_alloc_array(0, uv_fs->result);
+    uv_dirent_t ent;
+    while (uv_fs_scandir_next(uv_fs, &ent) != UV_EOF) {
+        arr = lean_array_push(arr, lean_mk_string(ent.name));
+    }
+
+    fs_req_finish(req, mk_except_ok(arr));
+}
+
+/* Std.Internal.UV.FS.readDir (path : @& System.FilePath) : IO (IO.Promise (Except IO.Error (Array String))) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read_dir(b_obj_arg path, obj_arg /* w */) {
+    lean_uv_fs_req * req = fs_req_new(NULL, NULL);
+    return fs_req_submit(req, path, [=](uv_fs_t * uv_fs) {
+        return uv_fs_scandir(global_ev.loop, uv_fs, lean_string_cstr(path), 0, fs_scandir_cb);
+    });
+}
+
+#else
+
+void lean_uv_file_finalizer(void* ptr);
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_open(b_obj_arg path, uint8_t mode, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_fs_open is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read(b_obj_arg file, size_t nbytes, int64_t offset, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_fs_read is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_write(b_obj_arg file, obj_arg data, int64_t offset, obj_arg /* w */) {
+    lean_dec(data);
+    return io_result_mk_error("lean_uv_fs_write is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_close(b_obj_arg file, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_fs_close is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_stat(b_obj_arg path, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_fs_stat is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read_dir(b_obj_arg path, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_fs_read_dir is not supported");
+}
+
+#endif
+}
@@ -0,0 +1,52 @@
+/*
+Copyright (c) 2024 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#pragma once
+#include <atomic>
+#include <lean/lean.h>
+#include "runtime/uv/event_loop.h"
+
+namespace lean {
+
+static lean_external_class * g_uv_file_external_class = NULL;
+void initialize_libuv_fs();
+
+#ifndef LEAN_EMSCRIPTEN
+using namespace std;
+#include <uv.h>
+
+// Structure for managing a file opened through the event loop.
+typedef struct {
+    // The file descriptor, -1 once `File.close` was called. The file may be used by several threads,
+    // so `close` atomically takes the descriptor to make sure that it is closed only once.
+    std::atomic<uv_file> m_fd;
+} lean_uv_file_object;
+
+// Structure for managing a single filesystem request that is in flight on the event loop.
+typedef struct {
+    uv_fs_t       m_uv_fs;     // LibUV request, `m_uv_fs.data` points back to this structure.
+    lean_object * m_promise;   // The promise that is resolved with the `Except IO.Error α` result.
+    lean_object * m_file;      // The `File` the request operates on, or NULL.
+    lean_object * m_buffer;    // The `ByteArray` that is read into or written from, or NULL.
+} lean_uv_fs_req;
+
+// =======================================
+// File object manipulation functions.
+static inline lean_object* lean_uv_file_new(lean_uv_file_object * s) { return lean_alloc_external(g_uv_file_external_class, s); }
+static inline lean_uv_file_object* lean_to_uv_file(lean_object * o) { return (lean_uv_file_object*)(lean_get_external_data(o)); }
+
+#else
+
+// =======================================
+// Filesystem functions
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_open(b_obj_arg path, uint8_t mode, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read(b_obj_arg file, size_t nbytes, int64_t offset, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_write(b_obj_arg file, obj_arg data, int64_t offset, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_close(b_obj_arg file, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_stat(b_obj_arg path, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_fs_read_dir(b_obj_arg path, obj_arg /* w */);
+
+#endif
+
+}
@@ -0,0 +1,556 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <vector>
+#include "runtime/uv/tcp.h"
+
+/*
+TCP sockets on the global event loop. Every operation that has to wait for the network returns an
+`IO.Promise (Except IO.Error α)` that is resolved from the event loop.
+
+Reading is demand driven: the socket is only read from while a `recv?` is pending, and the bytes
+are read directly into the `ByteArray` that is returned. A peer that sends faster than the program
+consumes is therefore throttled by the kernel's receive window. Writes send the given `ByteArray`s
+without copying them; `writeQueueSize` exposes the number of bytes libuv still has to send so that
+writers can apply backpressure themselves.
+*/
+
+namespace lean {
+#ifndef LEAN_EMSCRIPTEN
+
+using namespace std;
+
+// The finalizer of the `Socket`. All pending operations keep the socket alive, so there are no
+// promises left to take care of here.
+void lean_uv_tcp_socket_finalizer(void* ptr) {
+    lean_uv_tcp_socket_object * tcp_socket = (lean_uv_tcp_socket_object*) ptr;
+
+    lean_assert(tcp_socket->m_promise_accept == NULL);
+    lean_assert(tcp_socket->m_promise_read == NULL);
+
+    event_loop_lock(&global_ev);
+
+    uv_close((uv_handle_t*)tcp_socket->m_uv_tcp, [](uv_handle_t* handle) {
+        free(handle);
+    });
+
+    event_loop_unlock(&global_ev);
+
+    free(tcp_socket);
+}
+
+void initialize_libuv_tcp_socket() {
+    g_uv_tcp_socket_external_class = lean_register_external_class(lean_uv_tcp_socket_finalizer, [](void* obj, lean_object* f) {
+        lean_uv_tcp_socket_object * tcp_socket = (lean_uv_tcp_socket_object*)obj;
+        if (tcp_socket->m_promise_accept != NULL) {
+            lean_inc(f);
+            lean_apply_1(f, tcp_socket->m_promise_accept);
+        }
+        if (tcp_socket->m_promise_read != NULL) {
+            lean_inc(f);
+            lean_apply_1(f, tcp_socket->m_promise_read);
+        }
+    });
+}
+
+// Creates a new socket object, the event loop has to be locked.
+static int tcp_socket_new_locked(lean_object ** out) {
+    lean_uv_tcp_socket_object * tcp_socket = (lean_uv_tcp_socket_object*)malloc(sizeof(lean_uv_tcp_socket_object));
+    tcp_socket->m_promise_accept = NULL;
+    tcp_socket->m_promise_read = NULL;
+    tcp_socket->m_byte_array = NULL;
+    tcp_socket->m_buffer_size = 0;
+    tcp_socket->m_pending_connections = 0;
+    tcp_socket->m_accept_error = 0;
+
+    uv_tcp_t * uv_tcp = (uv_tcp_t*)malloc(sizeof(uv_tcp_t));
+    int result = uv_tcp_init(global_ev.loop, uv_tcp);
+
+    if (result != 0) {
+        free(uv_tcp);
+        free(tcp_socket);
+        return result;
+    }
+
+    tcp_socket->m_uv_tcp = uv_tcp;
+
+    lean_object * obj = lean_uv_tcp_socket_new(tcp_socket);
+    lean_mark_mt(obj);
+    tcp_socket->m_uv_tcp->data = obj;
+
+    *out = obj;
+    return 0;
+}
+
+/* Std.Internal.UV.TCP.Socket.new : IO Socket */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_new(obj_arg /* w */) {
+    lean_object * obj;
+
+    event_loop_lock(&global_ev);
+    int result = tcp_socket_new_locked(&obj);
+    event_loop_unlock(&global_ev);
+
+    if (result != 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(obj);
+}
+
+// =======================================
+// Requests that complete with `Unit`.
+
+typedef struct {
+    union {
+        uv_connect_t  m_connect;
+        uv_write_t    m_write;
+        uv_shutdown_t m_shutdown;
+    } m_uv_req;
+    lean_object * m_promise;   // Resolved with `Except IO.Error Unit` once the request completes.
+    lean_object * m_socket;    // The socket, kept alive while the request is in flight.
+    lean_object * m_data;      // The `Array ByteArray` that is written, or NULL.
+} tcp_unit_req;
+
+static tcp_unit_req * tcp_unit_req_new(b_obj_arg socket, lean_object * data) {
+    tcp_unit_req * req = (tcp_unit_req*)malloc(sizeof(tcp_unit_req));
+    req->m_promise = create_promise();
+    lean_inc(socket);
+    req->m_socket = socket;
+    req->m_data = data;
+    return req;
+}
+
+static void tcp_unit_req_free(tcp_unit_req * req) {
+    lean_dec(req->m_promise);
+    lean_dec(req->m_socket);
+    if (req->m_data != NULL) {
+        lean_dec(req->m_data);
+    }
+    free(req);
+}
+
+static void tcp_unit_req_finish(tcp_unit_req * req, int status) {
+    if (status < 0) {
+        resolve_promise(req->m_promise, mk_except_err(lean_decode_uv_error(status, NULL)));
+    } else {
+        resolve_promise(req->m_promise, mk_except_ok(lean_box(0)));
+    }
+    tcp_unit_req_free(req);
+}
+
+// Submits `req` to the event loop. `submit` starts the libuv operation, stores `req` as its data and
+// returns its status; it runs on the event loop, so it must not refer to anything that `req` does
+// not keep alive. If starting the operation fails, the callback is never called and the promise is
+// resolved with the error right away.
+template<typename F>
+static lean_obj_res tcp_unit_req_submit(tcp_unit_req * req, F submit) {
+    // The callback may run and free `req` as soon as it is submitted.
+    lean_object * promise = req->m_promise;
+    lean_inc(promise);
+
+    event_loop_submit(&global_ev, [req, submit]() {
+        int result = submit(req);
+        if (result < 0) {
+            tcp_unit_req_finish(req, result);
+        }
+    });
+
+    return lean_io_result_mk_ok(promise);
+}
+
+/* Std.Internal.UV.TCP.Socket.connect (socket : @& Socket) (addr : @& SocketAddress) : IO (IO.Promise (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_connect(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    sockaddr_storage addr_ptr;
+    lean_socket_address_to_sockaddr_storage(addr, &addr_ptr);
+
+    tcp_unit_req * req = tcp_unit_req_new(socket, NULL);
+    return tcp_unit_req_submit(req, [=](tcp_unit_req * req) {
+        req->m_uv_req.m_connect.data = req;
+        return uv_tcp_connect(&req->m_uv_req.m_connect, tcp_socket->m_uv_tcp, (const sockaddr*)&addr_ptr, [](uv_connect_t* uv_req, int status) {
+            tcp_unit_req_finish((tcp_unit_req*)uv_req->data, status);
+        });
+    });
+}
+
+/* Std.Internal.UV.TCP.Socket.send (socket : @& Socket) (data : Array ByteArray) : IO (IO.Promise (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_send(b_obj_arg socket, obj_arg data, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    size_t num_bufs = lean_array_size(data);
+    std::vector<uv_buf_t> bufs;
+    bufs.reserve(num_bufs);
+    for (size_t i = 0; i < num_bufs; i++) {
+        lean_object * byte_array = lean_array_get_core(data, i);
+        if (lean_sarray_size(byte_array) > 0) {
+            bufs.push_back(uv_buf_init((char*)lean_sarray_cptr(byte_array), lean_sarray_size(byte_array)));
+        }
+    }
+
+    if (bufs.empty()) {
+        // libuv does not accept empty writes.
+        lean_dec(data);
+        lean_object * promise = create_promise();
+        resolve_promise(promise, mk_except_ok(lean_box(0)));
+        return lean_io_result_mk_ok(promise);
+    }
+
+    // The buffers are not copied: `data` stays alive until they are written and is released by the
+    // event loop thread.
+    lean_mark_mt(data);
+
+    tcp_unit_req * req = tcp_unit_req_new(socket, data);
+    return tcp_unit_req_submit(req, [=](tcp_unit_req * req) {
+        req->m_uv_req.m_write.data = req;
+        return uv_write(&req->m_uv_req.m_write, (uv_stream_t*)tcp_socket->m_uv_tcp, bufs.data(), bufs.size(), [](uv_write_t* uv_req, int status) {
+            tcp_unit_req_finish((tcp_unit_req*)uv_req->data, status);
+        });
+    });
+}
+
+/* Std.Internal.UV.TCP.Socket.shutdown (socket : @& Socket) : IO (IO.Promise (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_shutdown(b_obj_arg socket, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    tcp_unit_req * req = tcp_unit_req_new(socket, NULL);
+    return tcp_unit_req_submit(req, [=](tcp_unit_req * req) {
+        req->m_uv_req.m_shutdown.data = req;
+        return uv_shutdown(&req->m_uv_req.m_shutdown, (uv_stream_t*)tcp_socket->m_uv_tcp, [](uv_shutdown_t* uv_req, int status) {
+            tcp_unit_req_finish((tcp_unit_req*)uv_req->data, status);
+        });
+    });
+}
+
+/* Std.Internal.UV.TCP.Socket.writeQueueSize (socket : @& Socket) : IO UInt64 */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_write_queue_size(b_obj_arg socket, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    event_loop_lock(&global_ev);
+    size_t size = uv_stream_get_write_queue_size((uv_stream_t*)tcp_socket->m_uv_tcp);
+    event_loop_unlock(&global_ev);
+
+    return lean_io_result_mk_ok(lean_box_uint64(size));
+}
+
+// =======================================
+// Reading
+
+static void tcp_alloc_cb(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket((lean_object*)handle->data);
+    lean_assert(tcp_socket->m_byte_array != NULL);
+    buf->base = (char*)lean_sarray_cptr(tcp_socket->m_byte_array);
+    buf->len = tcp_socket->m_buffer_size;
+}
+
+static void tcp_read_cb(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    // Nothing was read, libuv will call us again.
+    if (nread == 0) {
+        return;
+    }
+
+    lean_object * obj = (lean_object*)stream->data;
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(obj);
+
+    // Only read as much as was asked for, the rest stays in the kernel buffers.
+    uv_read_stop(stream);
+
+    lean_object * promise = tcp_socket->m_promise_read;
+    lean_object * byte_array = tcp_socket->m_byte_array;
+    tcp_socket->m_promise_read = NULL;
+    tcp_socket->m_byte_array = NULL;
+
+    if (nread > 0) {
+        // Short reads are common, e.g. for small messages received with a large buffer.
+        byte_array = byte_array_fit(byte_array, nread);
+        resolve_promise(promise, mk_except_ok(mk_option_some(byte_array)));
+    } else if (nread == UV_EOF) {
+        lean_dec(byte_array);
+        resolve_promise(promise, mk_except_ok(mk_option_none()));
+    } else {
+        lean_dec(byte_array);
+        resolve_promise(promise, mk_except_err(lean_decode_uv_error(nread, NULL)));
+    }
+
+    lean_dec(promise);
+    // The loop does not need to keep the socket alive anymore.
+    lean_dec(obj);
+}
+
+/* Std.Internal.UV.TCP.Socket.recv? (socket : @& Socket) (size : UInt64) : IO (IO.Promise (Except IO.Error (Option ByteArray))) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_recv(b_obj_arg socket, uint64_t buffer_size, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    if (buffer_size == 0) {
+        return io_result_mk_error("recv? requires a positive buffer size");
+    }
+
+    event_loop_lock(&global_ev);
+
+    if (tcp_socket->m_promise_read != NULL) {
+        event_loop_unlock(&global_ev);
+        return io_result_mk_error("parallel recv? is not allowed, wait for the previous one to finish");
+    }
+
+    // The buffer is only referenced by the socket until it is handed to the promise, so it can
+    // stay single threaded.
+    tcp_socket->m_byte_array = lean_alloc_sarray(1, 0, buffer_size);
+    tcp_socket->m_buffer_size = buffer_size;
+    tcp_socket->m_promise_read = create_promise();
+
+    int result = uv_read_start((uv_stream_t*)tcp_socket->m_uv_tcp, tcp_alloc_cb, tcp_read_cb);
+
+    if (result < 0) {
+        lean_dec(tcp_socket->m_byte_array);
+        lean_dec(tcp_socket->m_promise_read);
+        tcp_socket->m_byte_array = NULL;
+        tcp_socket->m_promise_read = NULL;
+        event_loop_unlock(&global_ev);
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    // The event loop must keep the socket alive until the read completes.
+    lean_inc(socket);
+    lean_object * promise = tcp_socket->m_promise_read;
+    lean_inc(promise);
+
+    event_loop_unlock(&global_ev);
+
+    return lean_io_result_mk_ok(promise);
+}
+
+// =======================================
+// Listening
+
+/* Std.Internal.UV.TCP.Socket.bind (socket : @& Socket) (addr : @& SocketAddress) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_bind(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    sockaddr_storage addr_ptr;
+    lean_socket_address_to_sockaddr_storage(addr, &addr_ptr);
+
+    event_loop_lock(&global_ev);
+    int result = uv_tcp_bind(tcp_socket->m_uv_tcp, (const sockaddr*)&addr_ptr, 0);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+// Accepts a connection on the listening socket `server`, the event loop has to be locked.
+static lean_object * tcp_accept_locked(lean_uv_tcp_socket_object * server) {
+    lean_object * client;
+    int result = tcp_socket_new_locked(&client);
+
+    if (result == 0) {
+        result = uv_accept((uv_stream_t*)server->m_uv_tcp, (uv_stream_t*)lean_to_uv_tcp_socket(client)->m_uv_tcp);
+        if (result < 0) {
+            lean_dec(client);
+        }
+    }
+
+    if (result < 0) {
+        return mk_except_err(lean_decode_uv_error(result, NULL));
+    }
+
+    return mk_except_ok(client);
+}
+
+static void tcp_connection_cb(uv_stream_t* stream, int status) {
+    lean_object * obj = (lean_object*)stream->data;
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(obj);
+
+    if (tcp_socket->m_promise_accept == NULL) {
+        // Nobody is waiting, the next `accept` picks the connection up or reports the error.
+        if (status >= 0) {
+            tcp_socket->m_pending_connections++;
+        } else {
+            tcp_socket->m_accept_error = status;
+        }
+        return;
+    }
+
+    lean_object * promise = tcp_socket->m_promise_accept;
+    tcp_socket->m_promise_accept = NULL;
+
+    if (status < 0) {
+        resolve_promise(promise, mk_except_err(lean_decode_uv_error(status, NULL)));
+    } else {
+        resolve_promise(promise, tcp_accept_locked(tcp_socket));
+    }
+
+    lean_dec(promise);
+    // The loop does not need to keep the socket alive anymore.
+    lean_dec(obj);
+}
+
+/* Std.Internal.UV.TCP.Socket.listen (socket : @& Socket) (backlog : UInt32) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_listen(b_obj_arg socket, uint32_t backlog, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    event_loop_lock(&global_ev);
+    int result = uv_listen((uv_stream_t*)tcp_socket->m_uv_tcp, (int)backlog, tcp_connection_cb);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+/* Std.Internal.UV.TCP.Socket.accept (socket : @& Socket) : IO (IO.Promise (Except IO.Error Socket)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_accept(b_obj_arg socket, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    event_loop_lock(&global_ev);
+
+    if (tcp_socket->m_promise_accept != NULL) {
+        event_loop_unlock(&global_ev);
+        return io_result_mk_error("parallel accept is not allowed, wait for the previous one to finish");
+    }
+
+    lean_object * promise = create_promise();
+
+    if (tcp_socket->m_accept_error != 0) {
+        resolve_promise(promise, mk_except_err(lean_decode_uv_error(tcp_socket->m_accept_error, NULL)));
+        tcp_socket->m_accept_error = 0;
+    } else if (tcp_socket->m_pending_connections > 0) {
+        tcp_socket->m_pending_connections--;
+        resolve_promise(promise, tcp_accept_locked(tcp_socket));
+    } else {
+        tcp_socket->m_promise_accept = promise;
+        lean_inc(promise);
+        // The event loop must keep the socket alive until a connection arrives.
+        lean_inc(socket);
+    }
+
+    event_loop_unlock(&global_ev);
+
+    return lean_io_result_mk_ok(promise);
+}
+
+// =======================================
+// Socket information and options
+
+template<typename F>
+static lean_obj_res tcp_get_name(b_obj_arg socket, F get_name) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    sockaddr_storage addr_storage;
+    int addr_len = sizeof(addr_storage);
+
+    event_loop_lock(&global_ev);
+    int result = get_name(tcp_socket->m_uv_tcp, (sockaddr*)&addr_storage, &addr_len);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_sockaddr_to_socket_address((const sockaddr*)&addr_storage));
+}
+
+/* Std.Internal.UV.TCP.Socket.getPeerName (socket : @& Socket) : IO SocketAddress */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getpeername(b_obj_arg socket, obj_arg /* w */) {
+    return tcp_get_name(socket, uv_tcp_getpeername);
+}
+
+/* Std.Internal.UV.TCP.Socket.getSockName (socket : @& Socket) : IO SocketAddress */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getsockname(b_obj_arg socket, obj_arg /* w */) {
+    return tcp_get_name(socket, uv_tcp_getsockname);
+}
+
+/* Std.Internal.UV.TCP.Socket.noDelay (socket : @& Socket) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_nodelay(b_obj_arg socket, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    event_loop_lock(&global_ev);
+    int result = uv_tcp_nodelay(tcp_socket->m_uv_tcp, 1);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+/* Std.Internal.UV.TCP.Socket.keepAlive (socket : @& Socket) (enable : Bool) (delay : UInt32) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_keepalive(b_obj_arg socket, uint8_t enable, uint32_t delay, obj_arg /* w */) {
+    lean_uv_tcp_socket_object * tcp_socket = lean_to_uv_tcp_socket(socket);
+
+    event_loop_lock(&global_ev);
+    int result = uv_tcp_keepalive(tcp_socket->m_uv_tcp, enable, delay);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+#else
+
+void lean_uv_tcp_socket_finalizer(void* ptr);
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_new(obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_new is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_connect(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_connect is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_send(b_obj_arg socket, obj_arg data, obj_arg /* w */) {
+    lean_dec(data);
+    return io_result_mk_error("lean_uv_tcp_send is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_recv(b_obj_arg socket, uint64_t buffer_size, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_recv is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_write_queue_size(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_write_queue_size is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_bind(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_bind is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_listen(b_obj_arg socket, uint32_t backlog, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_listen is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_accept(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_accept is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_shutdown(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_shutdown is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getpeername(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_getpeername is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getsockname(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_getsockname is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_nodelay(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_nodelay is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_keepalive(b_obj_arg socket, uint8_t enable, uint32_t delay, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_tcp_keepalive is not supported");
+}
+
+#endif
+}
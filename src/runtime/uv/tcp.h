@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#pragma once
+#include <lean/lean.h>
+#include "runtime/uv/event_loop.h"
+#include "runtime/uv/net_addr.h"
+
+namespace lean {
+
+static lean_external_class * g_uv_tcp_socket_external_class = NULL;
+void initialize_libuv_tcp_socket();
+
+#ifndef LEAN_EMSCRIPTEN
+using namespace std;
+#include <uv.h>
+
+// Structure for managing a single TCP socket object, including the promises of the operations that
+// are waiting for the socket to become readable.
+typedef struct {
+    uv_tcp_t *    m_uv_tcp;              // LibUV TCP handle.
+    lean_object * m_promise_accept;      // Promise of the pending `accept`, or NULL.
+    lean_object * m_promise_read;        // Promise of the pending `recv?`, or NULL.
+    lean_object * m_byte_array;          // Buffer of the pending `recv?`, or NULL.
+    uint64_t      m_buffer_size;         // Maximum number of bytes returned by the pending `recv?`.
+    unsigned      m_pending_connections; // Incoming connections that no `accept` has picked up yet.
+    int           m_accept_error;        // Error of an incoming connection that no `accept` has reported yet, or 0.
+} lean_uv_tcp_socket_object;
+
+// =======================================
+// TCP socket object manipulation functions.
+static inline lean_object* lean_uv_tcp_socket_new(lean_uv_tcp_socket_object * s) { return lean_alloc_external(g_uv_tcp_socket_external_class, s); }
+static inline lean_uv_tcp_socket_object* lean_to_uv_tcp_socket(lean_object * o) { return (lean_uv_tcp_socket_object*)(lean_get_external_data(o)); }
+
+#else
+
+// =======================================
+// TCP socket manipulation functions
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_new(obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_connect(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_send(b_obj_arg socket, obj_arg data, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_recv(b_obj_arg socket, uint64_t buffer_size, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_write_queue_size(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_bind(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_listen(b_obj_arg socket, uint32_t backlog, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_accept(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_shutdown(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getpeername(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_getsockname(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_nodelay(b_obj_arg socket, obj_arg /* w */);
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_tcp_keepalive(b_obj_arg socket, uint8_t enable, uint32_t delay, obj_arg /* w */);
+
+#endif
+
+}
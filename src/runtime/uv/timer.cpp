@@ -74,23 +74,19 @@ extern "C" LEAN_EXPORT lean_obj_res lean_uv_timer_mk(uint64_t timeout, uint8_t r
     timer->m_promise = NULL;
 
     uv_timer_t * uv_timer = (uv_timer_t*)malloc(sizeof(uv_timer_t));
-
-    event_loop_lock(&global_ev);
-    int result = uv_timer_init(global_ev.loop, uv_timer);
-    event_loop_unlock(&global_ev);
-
-    if (result != 0) {
-        free(uv_timer);
-        free(timer);
-        std::string err = std::string("failed to initialize timer: ") + uv_strerror(result);
-        return io_result_mk_error(err.c_str());
-    }
-
     timer->m_uv_timer = uv_timer;
 
     lean_object * obj = lean_uv_timer_new(timer);
     lean_mark_mt(obj);
-    timer->m_uv_timer->data = obj;
+
+    // `uv_timer_init` cannot fail, so there is no need to wait for the loop. Submitted work runs
+    // before the loop is locked, so the handle is initialized before anybody else uses it.
+    event_loop_submit(&global_ev, [uv_timer, obj]() {
+        int result = uv_timer_init(global_ev.loop, uv_timer);
+        (void)result;
+        lean_assert(result == 0);
+        uv_timer->data = obj;
+    });
 
     return lean_io_result_mk_ok(obj);
 }
@@ -116,25 +112,21 @@ extern "C" LEAN_EXPORT lean_obj_res lean_uv_timer_next(b_obj_arg obj, obj_arg /*
         // The event loop must keep the timer alive for the duration of the run time.
         lean_inc(obj);
 
-        event_loop_lock(&global_ev);
-
-        int result = uv_timer_start(
-            timer->m_uv_timer,
-            handle_timer_event,
-            timer->m_repeating ? 0 : timer->m_timeout,
-            timer->m_repeating ? timer->m_timeout : 0
-        );
-
-        event_loop_unlock(&global_ev);
-
-        if (result != 0) {
-            lean_dec(obj);
-            std::string err = std::string("failed to initialize timer: ") + uv_strerror(result);
-            return io_result_mk_error(err.c_str());
-        } else {
-            lean_inc(timer->m_promise);
-            return lean_io_result_mk_ok(timer->m_promise);
-        }
+        // `uv_timer_start` only fails for closing handles, and the handle is only closed by the
+        // finalizer, so the timer can be started without waiting for the loop.
+        event_loop_submit(&global_ev, [timer]() {
+            int result = uv_timer_start(
+                timer->m_uv_timer,
+                handle_timer_event,
+                timer->m_repeating ? 0 : timer->m_timeout,
+                timer->m_repeating ? timer->m_timeout : 0
+            );
+            (void)result;
+            lean_assert(result == 0);
+        });
+
+        lean_inc(timer->m_promise);
+        return lean_io_result_mk_ok(timer->m_promise);
     };
 
     if (timer->m_repeating) {
@@ -0,0 +1,327 @@
+/*
+Copyright (c) 2025 Lean FRO, LLC. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <vector>
+#include "runtime/uv/udp.h"
+
+/*
+UDP sockets on the global event loop. Like TCP sockets, a UDP socket is only read from while a
+`recv` is pending and every datagram is received directly into the returned `ByteArray`.
+*/
+
+namespace lean {
+#ifndef LEAN_EMSCRIPTEN
+
+using namespace std;
+
+// The finalizer of the `Socket`. A pending `recv` keeps the socket alive, so there is no promise
+// left to take care of here.
+void lean_uv_udp_socket_finalizer(void* ptr) {
+    lean_uv_udp_socket_object * udp_socket = (lean_uv_udp_socket_object*) ptr;
+
+    lean_assert(udp_socket->m_promise_read == NULL);
+
+    event_loop_lock(&global_ev);
+
+    uv_close((uv_handle_t*)udp_socket->m_uv_udp, [](uv_handle_t* handle) {
+        free(handle);
+    });
+
+    event_loop_unlock(&global_ev);
+
+    free(udp_socket);
+}
+
+void initialize_libuv_udp_socket() {
+    g_uv_udp_socket_external_class = lean_register_external_class(lean_uv_udp_socket_finalizer, [](void* obj, lean_object* f) {
+        if (((lean_uv_udp_socket_object*)obj)->m_promise_read != NULL) {
+            lean_inc(f);
+            lean_apply_1(f, ((lean_uv_udp_socket_object*)obj)->m_promise_read);
+        }
+    });
+}
+
+/* Std.Internal.UV.UDP.Socket.new : IO Socket */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_new(obj_arg /* w */) {
+    lean_uv_udp_socket_object * udp_socket = (lean_uv_udp_socket_object*)malloc(sizeof(lean_uv_udp_socket_object));
+    udp_socket->m_promise_read = NULL;
+    udp_socket->m_byte_array = NULL;
+    udp_socket->m_buffer_size = 0;
+
+    uv_udp_t * uv_udp = (uv_udp_t*)malloc(sizeof(uv_udp_t));
+
+    event_loop_lock(&global_ev);
+    int result = uv_udp_init(global_ev.loop, uv_udp);
+    event_loop_unlock(&global_ev);
+
+    if (result != 0) {
+        free(uv_udp);
+        free(udp_socket);
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    udp_socket->m_uv_udp = uv_udp;
+
+    lean_object * obj = lean_uv_udp_socket_new(udp_socket);
+    lean_mark_mt(obj);
+    udp_socket->m_uv_udp->data = obj;
+
+    return lean_io_result_mk_ok(obj);
+}
+
+/* Std.Internal.UV.UDP.Socket.bind (socket : @& Socket) (addr : @& SocketAddress) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_bind(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(socket);
+
+    sockaddr_storage addr_ptr;
+    lean_socket_address_to_sockaddr_storage(addr, &addr_ptr);
+
+    event_loop_lock(&global_ev);
+    int result = uv_udp_bind(udp_socket->m_uv_udp, (const sockaddr*)&addr_ptr, 0);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+/* Std.Internal.UV.UDP.Socket.connect (socket : @& Socket) (addr : @& SocketAddress) : IO Unit */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_connect(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(socket);
+
+    sockaddr_storage addr_ptr;
+    lean_socket_address_to_sockaddr_storage(addr, &addr_ptr);
+
+    event_loop_lock(&global_ev);
+    int result = uv_udp_connect(udp_socket->m_uv_udp, (const sockaddr*)&addr_ptr);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_box(0));
+}
+
+typedef struct {
+    uv_udp_send_t m_uv_send;
+    lean_object * m_promise;   // Resolved with `Except IO.Error Unit` once the datagram is sent.
+    lean_object * m_socket;    // The socket, kept alive while the datagram is in flight.
+    lean_object * m_data;      // The `Array ByteArray` that is sent.
+} udp_send_req;
+
+static void udp_send_cb(uv_udp_send_t* uv_req, int status) {
+    udp_send_req * req = (udp_send_req*)uv_req->data;
+
+    if (status < 0) {
+        resolve_promise(req->m_promise, mk_except_err(lean_decode_uv_error(status, NULL)));
+    } else {
+        resolve_promise(req->m_promise, mk_except_ok(lean_box(0)));
+    }
+
+    lean_dec(req->m_promise);
+    lean_dec(req->m_socket);
+    lean_dec(req->m_data);
+    free(req);
+}
+
+/* Std.Internal.UV.UDP.Socket.send (socket : @& Socket) (data : Array ByteArray) (addr : @& Option SocketAddress) : IO (IO.Promise (Except IO.Error Unit)) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_send(b_obj_arg socket, obj_arg data, b_obj_arg addr, obj_arg /* w */) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(socket);
+
+    size_t num_bufs = lean_array_size(data);
+    std::vector<uv_buf_t> bufs;
+    bufs.reserve(num_bufs + 1);
+    for (size_t i = 0; i < num_bufs; i++) {
+        lean_object * byte_array = lean_array_get_core(data, i);
+        bufs.push_back(uv_buf_init((char*)lean_sarray_cptr(byte_array), lean_sarray_size(byte_array)));
+    }
+    if (bufs.empty()) {
+        // An empty datagram, libuv needs at least one buffer.
+        bufs.push_back(uv_buf_init(NULL, 0));
+    }
+
+    sockaddr_storage addr_storage;
+    const sockaddr * addr_ptr = NULL;
+    if (!lean_is_scalar(addr)) {
+        lean_socket_address_to_sockaddr_storage(lean_ctor_get(addr, 0), &addr_storage);
+        addr_ptr = (const sockaddr*)&addr_storage;
+    }
+
+    // The buffers are not copied: `data` stays alive until they are sent and is released by the
+    // event loop thread.
+    lean_mark_mt(data);
+    lean_inc(socket);
+
+    udp_send_req * req = (udp_send_req*)malloc(sizeof(udp_send_req));
+    req->m_promise = create_promise();
+    req->m_socket = socket;
+    req->m_data = data;
+    req->m_uv_send.data = req;
+
+    // The callback may run and free `req` as soon as the loop is unlocked.
+    lean_object * promise = req->m_promise;
+    lean_inc(promise);
+
+    event_loop_lock(&global_ev);
+    int result = uv_udp_send(&req->m_uv_send, udp_socket->m_uv_udp, bufs.data(), bufs.size(), addr_ptr, udp_send_cb);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        lean_dec(promise);
+        udp_send_cb(&req->m_uv_send, result);
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(promise);
+}
+
+static void udp_alloc_cb(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket((lean_object*)handle->data);
+    lean_assert(udp_socket->m_byte_array != NULL);
+    buf->base = (char*)lean_sarray_cptr(udp_socket->m_byte_array);
+    buf->len = udp_socket->m_buffer_size;
+}
+
+static void udp_recv_cb(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const sockaddr* addr, unsigned flags) {
+    // Nothing was read, libuv will call us again.
+    if (nread == 0 && addr == NULL) {
+        return;
+    }
+
+    lean_object * obj = (lean_object*)handle->data;
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(obj);
+
+    // Only receive as many datagrams as were asked for, the rest stays in the kernel buffers.
+    uv_udp_recv_stop(handle);
+
+    lean_object * promise = udp_socket->m_promise_read;
+    lean_object * byte_array = udp_socket->m_byte_array;
+    udp_socket->m_promise_read = NULL;
+    udp_socket->m_byte_array = NULL;
+
+    if (nread >= 0) {
+        byte_array = byte_array_fit(byte_array, nread);
+        lean_object * sender = addr != NULL ? mk_option_some(lean_sockaddr_to_socket_address(addr)) : mk_option_none();
+        lean_object * pair = lean_alloc_ctor(0, 2, 0);
+        lean_ctor_set(pair, 0, byte_array);
+        lean_ctor_set(pair, 1, sender);
+        resolve_promise(promise, mk_except_ok(pair));
+    } else {
+        lean_dec(byte_array);
+        resolve_promise(promise, mk_except_err(lean_decode_uv_error(nread, NULL)));
+    }
+
+    lean_dec(promise);
+    // The loop does not need to keep the socket alive anymore.
+    lean_dec(obj);
+}
+
+/* Std.Internal.UV.UDP.Socket.recv (socket : @& Socket) (size : UInt64) : IO (IO.Promise (Except IO.Error (ByteArray × Option SocketAddress))) */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_recv(b_obj_arg socket, uint64_t buffer_size, obj_arg /* w */) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(socket);
+
+    if (buffer_size == 0) {
+        return io_result_mk_error("recv requires a positive buffer size");
+    }
+
+    event_loop_lock(&global_ev);
+
+    if (udp_socket->m_promise_read != NULL) {
+        event_loop_unlock(&global_ev);
+        return io_result_mk_error("parallel recv is not allowed, wait for the previous one to finish");
+    }
+
+    // The buffer is only referenced by the socket until it is handed to the promise, so it can
+    // stay single threaded.
+    udp_socket->m_byte_array = lean_alloc_sarray(1, 0, buffer_size);
+    udp_socket->m_buffer_size = buffer_size;
+    udp_socket->m_promise_read = create_promise();
+
+    int result = uv_udp_recv_start(udp_socket->m_uv_udp, udp_alloc_cb, udp_recv_cb);
+
+    if (result < 0) {
+        lean_dec(udp_socket->m_byte_array);
+        lean_dec(udp_socket->m_promise_read);
+        udp_socket->m_byte_array = NULL;
+        udp_socket->m_promise_read = NULL;
+        event_loop_unlock(&global_ev);
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    // The event loop must keep the socket alive until a datagram arrives.
+    lean_inc(socket);
+    lean_object * promise = udp_socket->m_promise_read;
+    lean_inc(promise);
+
+    event_loop_unlock(&global_ev);
+
+    return lean_io_result_mk_ok(promise);
+}
+
+template<typename F>
+static lean_obj_res udp_get_name(b_obj_arg socket, F get_name) {
+    lean_uv_udp_socket_object * udp_socket = lean_to_uv_udp_socket(socket);
+
+    sockaddr_storage addr_storage;
+    int addr_len = sizeof(addr_storage);
+
+    event_loop_lock(&global_ev);
+    int result = get_name(udp_socket->m_uv_udp, (sockaddr*)&addr_storage, &addr_len);
+    event_loop_unlock(&global_ev);
+
+    if (result < 0) {
+        return lean_io_result_mk_error(lean_decode_uv_error(result, NULL));
+    }
+
+    return lean_io_result_mk_ok(lean_sockaddr_to_socket_address((const sockaddr*)&addr_storage));
+}
+
+/* Std.Internal.UV.UDP.Socket.getPeerName (socket : @& Socket) : IO SocketAddress */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_getpeername(b_obj_arg socket, obj_arg /* w */) {
+    return udp_get_name(socket, uv_udp_getpeername);
+}
+
+/* Std.Internal.UV.UDP.Socket.getSockName (socket : @& Socket) : IO SocketAddress */
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_getsockname(b_obj_arg socket, obj_arg /* w */) {
+    return udp_get_name(socket, uv_udp_getsockname);
+}
+
+#else
+
+void lean_uv_udp_socket_finalizer(void* ptr);
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_new(obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_new is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_bind(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_bind is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_connect(b_obj_arg socket, b_obj_arg addr, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_connect is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_send(b_obj_arg socket, obj_arg data, b_obj_arg addr, obj_arg /* w */) {
+    lean_dec(data);
+    return io_result_mk_error("lean_uv_udp_send is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_recv(b_obj_arg socket, uint64_t buffer_size, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_recv is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_getpeername(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_getpeername is not supported");
+}
+
+extern "C" LEAN_EXPORT lean_obj_res lean_uv_udp_getsockname(b_obj_arg socket, obj_arg /* w */) {
+    return io_result_mk_error("lean_uv_udp_getsockname is not supported");
+}
+
+#endif
+}
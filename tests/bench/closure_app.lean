@@ -0,0 +1,37 @@
+/-!
+Higher-order code that goes through `lean_apply_*` with partial applications: under-applications that are extended
+one argument at a time, folds with partially applied functions, and monadic binds.
+-/
+
+def step (a b c d : Nat) : Nat :=
+  (a * 31 + b * 17 + c * 7 + d) % 1000003
+
+/-- Extends a partial application of `f` one argument at a time. -/
+def extend (f : Nat → Nat → Nat → Nat → Nat) (i acc : Nat) : Nat :=
+  let g := f i
+  let h := g acc
+  let k := h 3
+  k 5
+
+def foldWith (f : Nat → Nat → Nat) : List Nat → Nat → Nat
+  | [],      acc => acc
+  | x :: xs, acc => foldWith f xs (f acc x)
+
+def bindLoop (f : Nat → Nat → Nat) : List Nat → StateM Nat Unit
+  | []      => pure ()
+  | x :: xs => do
+    let s ← get
+    set (f s x)
+    bindLoop f xs
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let xs := List.range 100
+    let mut acc := 0
+    for i in [0:n] do
+      acc := extend step i acc
+      acc := foldWith (step i 1) xs acc
+      acc := ((bindLoop (step 2 i) xs).run acc).2
+    IO.println s!"result: {acc}"
+  | _ => throw <| IO.userError "give number of iterations"
@@ -0,0 +1,12 @@
+/-!
+Renders a large nested list with `toString` and `Std.Format.pretty`. Both build their output from many short
+pieces.
+-/
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let xss := (List.range n).map fun i => (List.range (i % 20)).map (· * i)
+    IO.println s!"toString: {(toString xss).length}"
+    IO.println s!"pretty: {(Std.Format.pretty (repr xss) 1000000000).length}"
+  | _ => throw <| IO.userError "give number of lists"
@@ -0,0 +1,23 @@
+import Std.Data.HashMap
+
+/-!
+Inserts and looks up strings in a `Std.HashMap String Nat`. A quarter of the keys are long, the
+remaining ones are short identifiers.
+-/
+
+def key (i : Nat) : String :=
+  if i % 4 == 0 then "".pushn 'a' 200 ++ toString i else "key" ++ toString i
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let keys := (Array.range (2 * n)).map key
+    let mut m : Std.HashMap String Nat := {}
+    for i in [0:n] do
+      m := m.insert keys[i]! i
+    let mut found := 0
+    for _ in [0:10] do
+      for k in keys do
+        if m.contains k then found := found + 1
+    IO.println s!"size: {m.size}, found: {found}"
+  | _ => throw <| IO.userError "give number of keys"
@@ -0,0 +1,38 @@
+/-!
+Spawns tasks that capture a tree of about one million nodes. The tree is marked as multi-threaded
+when it is first captured. Afterwards, each round replaces one entry, which creates a new path
+from the root, and spawns another task capturing the new version. Only the nodes on the new path
+have to be marked.
+-/
+
+inductive Tree where
+  | leaf
+  | node (l : Tree) (v : Nat) (r : Tree)
+
+def build : Nat → Nat → Tree
+  | 0, _ => .leaf
+  | d + 1, i => .node (build d (2 * i)) i (build d (2 * i + 1))
+
+def Tree.set : Tree → Nat → Nat → Nat → Tree
+  | .leaf, _, _, _ => .leaf
+  | .node l _ r, 0, _, x => .node l x r
+  | .node l v r, d + 1, i, x =>
+    if i % 2 == 0 then .node (l.set d (i / 2) x) v r else .node l v (r.set d (i / 2) x)
+
+def Tree.get : Tree → Nat → Nat → Nat
+  | .leaf, _, _ => 0
+  | .node _ v _, 0, _ => v
+  | .node l _ r, d + 1, i => if i % 2 == 0 then l.get d (i / 2) else r.get d (i / 2)
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let mut t := build 20 (n % 2 + 1)
+    let mut tasks := Array.mkEmpty n
+    for i in [0:n] do
+      t := t.set 19 i i
+      let t := t
+      tasks := tasks.push (Task.spawn fun _ => t.get 19 i)
+    let sum := tasks.foldl (fun s t => s + t.get) 0
+    IO.println s!"sum: {sum}"
+  | _ => throw <| IO.userError "give number of tasks"
@@ -0,0 +1,31 @@
+import Std.Data.HashMap
+
+/-!
+Builds hierarchical names from short, freshly allocated components and uses them as keys of a
+`Std.HashMap Lean.Name Nat`, as the elaborator does for its many name-indexed tables.
+-/
+
+open Lean
+
+def words : Array String := #[
+  "Lean", "Elab", "Term", "Meta", "mk", "app", "instDecidableEqNat", "x", "h", "ih", "Nat", "succ",
+  "add_comm", "List", "map", "foldl", "Array", "push", "get", "eq_of_beq", "Parser", "Syntax", "ident",
+  "_private", "motive", "toString", "inst", "Tactic", "simp", "rfl", "congrArg", "HAdd", "hAdd"]
+
+def mkName (i : Nat) : Name :=
+  let w := words[i % words.size]!
+  let w := if i % 3 == 0 then w ++ toString (i % 1000) else w
+  .str (.str (.str .anonymous "Lean") words[i / 7 % words.size]!) w
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let mut m : Std.HashMap Name Nat := {}
+    for i in [0:n] do
+      let k := mkName i
+      m := m.insert k (m.getD k 0 + 1)
+    let mut hits := 0
+    for i in [0:n] do
+      if m.contains (mkName (i * 7919)) then hits := hits + 1
+    IO.println s!"distinct: {m.size}, hits: {hits}"
+  | _ => throw <| IO.userError "give number of names"
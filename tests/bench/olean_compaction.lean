@@ -0,0 +1,22 @@
+import Lean.Environment
+
+/-!
+Writes an .olean file containing many long strings, most of which are duplicates. The compactor
+deduplicates strings by hashing their contents.
+-/
+
+open Lean
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let long := "".pushn 'x' 1000
+    let strs : Array String := (Array.range n).map fun i => s!"{i % 1000}{long}{i % 7}"
+    let data : ModuleData := {
+      imports := #[], constNames := #[], constants := #[], extraConstNames := #[]
+      entries := #[(`bench, unsafe unsafeCast strs)] }
+    for _ in [0:5] do
+      saveModuleData "olean_compaction.olean" `OleanCompaction data
+    IO.FS.removeFile "olean_compaction.olean"
+    IO.println s!"strings: {strs.size}"
+  | _ => throw <| IO.userError "give number of strings"
@@ -0,0 +1,90 @@
+import Lean.Data.PersistentArray
+import Lean.Data.RRBVector
+
+/-!
+Compares `Array`, `Lean.PersistentArray` and `Lean.RRBVector` on workloads that keep old versions
+alive: a backtracking search that updates the vector of its parent in both branches, an undo
+stack, and repeated concatenation of a shared vector. The first argument selects the
+implementation.
+-/
+
+open Lean
+
+class Vec (γ : Type) where
+  empty  : γ
+  push   : γ → Nat → γ
+  set    : γ → Nat → Nat → γ
+  get    : γ → Nat → Nat
+  append : γ → γ → γ
+
+instance : Vec (Array Nat) where
+  empty  := #[]
+  push   := Array.push
+  set    := Array.set!
+  get a i := a[i]!
+  append := (· ++ ·)
+
+instance : Vec (PersistentArray Nat) where
+  empty  := {}
+  push   := PersistentArray.push
+  set    := PersistentArray.set
+  get    := PersistentArray.get!
+  append := (· ++ ·)
+
+instance : Vec (RRBVector Nat) where
+  empty  := {}
+  push   := RRBVector.push
+  set    := RRBVector.set
+  get    := RRBVector.get!
+  append := (· ++ ·)
+
+variable {γ : Type} [Vec γ]
+
+def search (n : Nat) (xs : γ) : Nat → Nat → Nat
+  | 0, i => Vec.get xs (i % n)
+  | d + 1, i =>
+    let j := (i * 7919 + d) % n
+    search n (Vec.set xs j i) d (2 * i + 1) + search n (Vec.set xs j (i + 1)) d (2 * i + 2)
+
+def undo (n : Nat) (xs : γ) (updates : Nat) : Nat := Id.run do
+  let mut hist : List γ := []
+  let mut cur := xs
+  for k in [0:updates] do
+    if k % 64 == 63 then
+      match hist with
+      | h :: t => cur := h; hist := t
+      | [] => pure ()
+    else
+      if k % 8 == 0 then
+        hist := cur :: hist
+      cur := Vec.set cur (k * 7919 % n) k
+  let mut s := 0
+  for i in [0:n] do
+    s := s + Vec.get cur i
+  return s
+
+def concat (n : Nat) (xs : γ) (rounds : Nat) : Nat := Id.run do
+  let mut acc := xs
+  for _ in [0:rounds] do
+    acc := Vec.append acc xs
+  let mut s := 0
+  for i in [0:1000] do
+    s := s + Vec.get acc (i * 7919 % (n * (rounds + 1)))
+  return s
+
+def run (γ : Type) [Vec γ] (n depth : Nat) : IO Unit := do
+  let xs : γ := (List.range n).foldl Vec.push Vec.empty
+  IO.println s!"search: {search n xs depth 0}"
+  IO.println s!"undo: {undo n xs (10 * n)}"
+  IO.println s!"concat: {concat n xs 100}"
+
+def main : List String → IO Unit
+  | [impl, n, depth] => do
+    let n := n.toNat!
+    let depth := depth.toNat!
+    match impl with
+    | "array"      => run (Array Nat) n depth
+    | "persistent" => run (PersistentArray Nat) n depth
+    | "rrb"        => run (RRBVector Nat) n depth
+    | _            => throw <| IO.userError s!"unknown implementation '{impl}'"
+  | _ => throw <| IO.userError "give implementation (array, persistent or rrb), size and search depth"
@@ -0,0 +1,35 @@
+/-!
+Traverses a tree of about one million nodes that has been marked as multi-threaded by capturing it
+in tasks. Each traversal collects all nodes in an array, so the reference count of every node is
+incremented and decremented again. The main thread and the tasks traverse the tree concurrently.
+-/
+
+inductive Tree where
+  | leaf
+  | node (l : Tree) (v : Nat) (r : Tree)
+
+def build : Nat → Nat → Tree
+  | 0, _ => .leaf
+  | d + 1, i => .node (build d (2 * i)) i (build d (2 * i + 1))
+
+def Tree.nodes : Tree → Array Tree → Array Tree
+  | .leaf, acc => acc
+  | t@(.node l _ r), acc => r.nodes (l.nodes (acc.push t))
+
+def Tree.total (t : Tree) : Nat :=
+  (t.nodes #[]).foldl (init := 0) fun
+    | s, .node _ v _ => s + v
+    | s, .leaf => s
+
+def rounds (t : Tree) (n : Nat) : Nat :=
+  (List.range n).foldl (fun s _ => s + t.total) 0
+
+def main : List String → IO Unit
+  | [n, k] => do
+    let n := n.toNat!
+    -- depends on the input so that the tree is not extracted as a persistent closed term
+    let t := build 20 (n % 2 + 1)
+    let tasks := (List.range k.toNat!).map fun _ => Task.spawn fun _ => rounds t n
+    let sum := tasks.foldl (fun s t => s + t.get) (rounds t n)
+    IO.println s!"sum: {sum}"
+  | _ => throw <| IO.userError "give number of rounds and number of tasks"
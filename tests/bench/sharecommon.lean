@@ -0,0 +1,27 @@
+import Lean.Util.ShareCommon
+
+/-!
+Maximizes sharing of trees of about two million nodes using `Lean.ShareCommon.shareCommon`. All
+subtrees of the same depth (at least two) are structurally equal, but none of them are shared
+initially, so every node is looked up in both the pointer map and the hash-consing set.
+-/
+
+inductive Tree where
+  | leaf (s : String)
+  | node (l : Tree) (v : Nat) (r : Tree)
+
+def build : Nat → Nat → Tree
+  | 0, i => .leaf (toString (i % 4))
+  | d + 1, i => .node (build d (2 * i)) d (build d (2 * i + 1))
+
+def Tree.size : Tree → Nat
+  | .leaf _ => 1
+  | .node l _ r => l.size + 1 + r.size
+
+def main : List String → IO Unit
+  | [n] => do
+    let mut total := 0
+    for i in [0:n.toNat!] do
+      total := total + (Lean.ShareCommon.shareCommon (build 20 i)).size
+    IO.println s!"nodes: {total}"
+  | _ => throw <| IO.userError "give number of rounds"
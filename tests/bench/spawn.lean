@@ -0,0 +1,17 @@
+/-!
+Spawns `n` short-lived processes with a piped stdout while the parent holds a heap of `mb` megabytes.
+Measures spawn latency against the resident set size of the parent, which dominates when the child
+is started with `fork`.
+-/
+
+def main : List String → IO Unit
+  | [n, mb] => do
+    let heap := mkArray (mb.toNat! * 1024 * 1024 / 8) (0 : Nat)
+    let mut ok := 0
+    for _ in [0:n.toNat!] do
+      let out ← IO.Process.output { cmd := "echo", args := #["ok"] }
+      if out.exitCode == 0 && out.stdout == "ok\n" then
+        ok := ok + 1
+    IO.println s!"processes spawned: {ok}"
+    IO.println s!"heap size: {heap.size * 8 / 1024 / 1024}MB"
+  | _ => throw <| IO.userError "give number of processes and heap size in MB"
@@ -0,0 +1,63 @@
+import Std.Internal.Async.TCP
+
+/-!
+Loopback TCP through the libuv event loop: `n` one-byte ping-pongs measure the round-trip latency of
+the promise based primitives, then `n` writes of 64KiB measure throughput.
+-/
+
+open Std.Internal.IO.Async
+open Std.Net
+
+def loopback (port : UInt16) : SocketAddress :=
+  .v4 { addr := .ofParts 127 0 0 1, port }
+
+def connectPair : IO (TCP.Socket.Client × TCP.Socket.Client) := do
+  let server ← TCP.Socket.Server.mk
+  server.bind (loopback 0)
+  server.listen 16
+  let accepted ← server.accept
+  let client ← TCP.Socket.Client.mk
+  (← client.connect (loopback (← server.getSockName).port)).block
+  let conn ← accepted.block
+  client.noDelay
+  conn.noDelay
+  return (client, conn)
+
+/-- Receive exactly `n` bytes. -/
+partial def recvExactly (c : TCP.Socket.Client) (n : Nat) (acc : Nat := 0) : IO Nat := do
+  if acc ≥ n then return acc
+  match ← (← c.recv? (1 <<< 20)).block with
+  | some data => recvExactly c n (acc + data.size)
+  | none => return acc
+
+def pingPong (client conn : TCP.Socket.Client) (n : Nat) : IO Nat := do
+  let ping := ByteArray.mk #[1]
+  let echo ← IO.asTask (prio := .dedicated) do
+    for _ in [0:n] do
+      let _ ← recvExactly conn 1
+      (← conn.send ping).block
+  let mut rounds := 0
+  for _ in [0:n] do
+    (← client.send ping).block
+    let _ ← recvExactly client 1
+    rounds := rounds + 1
+  IO.ofExcept (← IO.wait echo)
+  return rounds
+
+def bulk (client conn : TCP.Socket.Client) (n : Nat) : IO Nat := do
+  let chunk := ByteArray.mk (Array.mkArray 65536 0)
+  let reader ← IO.asTask (prio := .dedicated) (recvExactly conn (n * chunk.size))
+  for _ in [0:n] do
+    -- keep at most 4MiB queued in the event loop
+    while (← client.writeQueueSize) > 4194304 do
+      IO.sleep 1
+    discard <| client.send chunk
+  IO.ofExcept (← IO.wait reader)
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let (client, conn) ← connectPair
+    IO.println s!"ping-pong rounds: {← pingPong client conn n}"
+    IO.println s!"bulk bytes: {← bulk client conn n}"
+  | _ => throw <| IO.userError "give number of iterations"
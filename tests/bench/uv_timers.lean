@@ -0,0 +1,28 @@
+import Std.Internal.Async.Timer
+
+/-!
+Registers `n` one-shot timers on the libuv event loop from 8 tasks at once, then waits for all of
+them. Measures how fast requests can be submitted to the event loop.
+-/
+
+open Std.Internal.IO.Async
+
+def register (n : Nat) : IO (Array (AsyncTask Unit)) := do
+  let mut tasks := Array.mkEmpty n
+  for i in [0:n] do
+    tasks := tasks.push (← sleep (.ofNat (1 + i % 10)))
+  return tasks
+
+def main : List String → IO Unit
+  | [n] => do
+    let n := n.toNat!
+    let mut fired := 0
+    for _ in [0:10] do
+      let registrations ← (List.range 8).mapM fun _ =>
+        IO.asTask (prio := .dedicated) (register (n / 8))
+      for r in registrations do
+        for t in ← IO.ofExcept (← IO.wait r) do
+          t.block
+          fired := fired + 1
+    IO.println s!"timers fired: {fired}"
+  | _ => throw <| IO.userError "give number of timers"
@@ -0,0 +1,31 @@
+/-!
+The sampling allocation profiler. The program runs itself again with `LEAN_ALLOCPROF` set and checks that
+the profile written at exit contains allocation samples and the statistics about freed objects.
+-/
+
+def work (n : Nat) : Nat := Id.run do
+  let mut xs : Array (List Nat) := #[]
+  for i in [0:n] do
+    xs := xs.push [i, i + 1]
+  return xs.foldl (fun s l => s + l.length) 0
+
+def main (args : List String) : IO Unit := do
+  if args == ["child"] then
+    IO.println (work 100000)
+    return
+  let app ← IO.appPath
+  let prof := app.toString ++ ".allocprof"
+  let out ← IO.Process.output {
+    cmd := app.toString, args := #["child"],
+    env := #[("LEAN_ALLOCPROF", some prof), ("LEAN_ALLOCPROF_RATE", some "4096")] }
+  IO.print out.stdout
+  let lines ← IO.FS.lines prof
+  IO.FS.removeFile prof
+  IO.println (lines[0]!.startsWith "heap profile: " && lines[0]!.endsWith " @ heap_v2/4096")
+  -- sample lines have the form `<live>: <live bytes> [<allocated>: <allocated bytes>] @ <frames>`, where the
+  -- frames are only available on platforms with `backtrace`, so we only check the number of sampled allocations
+  let samples := (lines.toList.drop 1).takeWhile (!·.startsWith "#")
+  let numAllocated (l : String) : Nat := ((l.splitOn "[")[1]!.splitOn ":")[0]!.toNat!
+  IO.println (!samples.isEmpty && samples.all (·.contains '@') && numAllocated lines[0]! > 100 &&
+    (samples.map numAllocated).sum == numAllocated lines[0]!)
+  IO.println (lines.contains "# tag kind freed mean_lifetime_us live" && lines.any (·.startsWith "# 1 constructor "))
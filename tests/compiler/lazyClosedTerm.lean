@@ -0,0 +1,18 @@
+/-!
+Extracted closed terms are computed on first access when the C code is compiled with `-DLEAN_LAZY_CLOSED_TERMS`,
+see `lazyClosedTerm.lean.leancflags`.
+-/
+
+def table (n : Nat) : Array Nat := (List.range n).toArray.map (· * 2)
+
+/-- `table 1000` is extracted as a closed term. -/
+def sumFrom (k : Nat) : Nat := (table 1000).foldl (· + ·) k
+
+def main (args : List String) : IO Unit := do
+  let n₀ ← Runtime.getLazyClosedTermInits
+  IO.println (sumFrom args.length)
+  let n₁ ← Runtime.getLazyClosedTermInits
+  IO.println (sumFrom (args.length + 1))
+  let n₂ ← Runtime.getLazyClosedTermInits
+  -- the first call computes the closed term, the second one reuses it
+  IO.println (n₁ > n₀, n₂ == n₁)
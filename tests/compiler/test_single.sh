@@ -1,15 +1,19 @@
 #!/usr/bin/env bash
 source ../common.sh
 
+# Additional `leanc` flags for the C program, e.g. `-DLEAN_LAZY_CLOSED_TERMS`
+leancflags=()
+[ -f "$f.leancflags" ] && read -ra leancflags < "$f.leancflags"
+
 # First check the C version actually works...
 echo "running C program..."
 rm "./$f.out" || true
-compile_lean_c_backend
+compile_lean_c_backend ${leancflags[@]+"${leancflags[@]}"}
 exec_check "./$f.out"
 diff_produced
 
-# Then check the LLVM version
-if lean_has_llvm_support; then
+# Then check the LLVM version, unless the test depends on flags of the C backend
+if lean_has_llvm_support && [ ${#leancflags[@]} -eq 0 ]; then
     echo "running LLVM program..."
     rm "./$f.out" || true
     compile_lean_llvm_backend
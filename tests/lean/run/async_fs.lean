@@ -0,0 +1,27 @@
+import Std.Internal.Async.FS
+
+open Std.Internal.IO.Async
+
+def roundTrip : IO (String × Nat × Bool × Bool) := do
+  IO.FS.withTempFile fun _ path => do
+    let f ← (← FS.File.open path .write).block
+    let n ← (← f.write "hello world".toUTF8).block
+    (← f.close).block
+    let closedFails := (← IO.wait (← f.close)) matches .error _
+    let f ← (← FS.File.open path .read).block
+    let data ← (← f.read 100 (some 6)).block
+    let eof ← (← f.read 100 (some 11)).block
+    let md ← (← FS.metadata path).block
+    let some dir := path.parent | throw <| .userError "no parent"
+    let entries ← (← FS.readDir dir).block
+    let some name := path.fileName | throw <| .userError "no file name"
+    return (String.fromUTF8! data, n.toNat + md.byteSize.toNat + eof.size,
+      closedFails, entries.contains name)
+
+/-- info: ("world", 22, true, true) -/
+#guard_msgs in
+#eval roundTrip
+
+/-- info: true -/
+#guard_msgs in
+#eval return (← IO.wait (← FS.File.open "/nonexistent/file" .read)) matches .error (.noFileOrDirectory ..)
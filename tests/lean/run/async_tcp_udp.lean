@@ -0,0 +1,52 @@
+import Std.Internal.Async.TCP
+import Std.Internal.Async.UDP
+
+open Std.Internal.IO.Async
+open Std.Net
+
+def loopback (port : UInt16) : SocketAddress :=
+  .v4 { addr := .ofParts 127 0 0 1, port }
+
+/-- Receive until the peer shuts down. -/
+partial def recvAll (c : TCP.Socket.Client) (acc : ByteArray := .empty) : IO ByteArray := do
+  match ← (← c.recv? 4096).block with
+  | some data => recvAll c (acc ++ data)
+  | none => return acc
+
+def echo : IO (String × Bool) := do
+  let server ← TCP.Socket.Server.mk
+  server.bind (loopback 0)
+  server.listen 16
+  let port := (← server.getSockName).port
+  let accepted ← server.accept
+  let client ← TCP.Socket.Client.mk
+  (← client.connect (loopback port)).block
+  let conn ← accepted.block
+  -- echo everything back, then close
+  let serverTask ← IO.asTask do
+    let data ← recvAll conn
+    (← conn.send data).block
+    (← conn.shutdown).block
+  (← client.sendAll #["hello".toUTF8, ", ".toUTF8, "world".toUTF8]).block
+  (← client.shutdown).block
+  let reply ← recvAll client
+  IO.ofExcept (← IO.wait serverTask)
+  return (String.fromUTF8! reply, (← client.getPeerName).port == port)
+
+/-- info: ("hello, world", true) -/
+#guard_msgs in
+#eval echo
+
+def datagram : IO (String × Bool) := do
+  let a ← UDP.Socket.mk
+  a.bind (loopback 0)
+  let b ← UDP.Socket.mk
+  b.bind (loopback 0)
+  let received ← a.recv 1024
+  (← b.send "ping".toUTF8 (some (← a.getSockName))).block
+  let (data, sender) ← received.block
+  return (String.fromUTF8! data, sender.map (·.port) == some (← b.getSockName).port)
+
+/-- info: ("ping", true) -/
+#guard_msgs in
+#eval datagram
@@ -0,0 +1,56 @@
+def bytes (n : Nat) (f : Nat → Nat) : ByteArray :=
+  (List.range n |>.map fun i => (f i).toUInt8).toByteArray
+
+/-! `ByteArray` search and comparison -/
+
+/-- info: (some 3, some 40, none, none, some 37, some 5, none) -/
+#guard_msgs in
+#eval
+  let a := bytes 100 (· % 37)
+  (a.indexOf? 3, a.indexOf? 3 4, a.indexOf? 200, a.indexOf? 3 1000,
+   a.indexOfBytes? (bytes 3 id) 1, a.indexOfBytes? .empty 5, a.indexOfBytes? (bytes 3 (· + 35)))
+
+/-- info: [Ordering.lt, Ordering.eq, Ordering.gt, Ordering.lt] -/
+#guard_msgs in
+#eval
+  let a := bytes 40 id
+  [compare a (a.set! 30 31), compare a (bytes 40 id), compare a (a.extract 0 39), compare ByteArray.empty a]
+
+/-! Bitwise operations on slices -/
+
+/-- info: ([0, 1, 3, 3, 4, 5, 6, 7, 8, 9], [0, 1, 0, 1, 0, 1, 6, 7, 8, 9], [0, 1, 2, 3, 4, 13, 14, 7, 8, 9]) -/
+#guard_msgs in
+#eval
+  let a := bytes 10 id
+  ((a.xorSlice 0 a 1 2).toList, (bytes 4 id |>.andSlice 0 a 2 100).toList, (bytes 3 (· + 8) |>.orSlice 1 a 5 3).toList)
+
+/-- info: (3200, 0, 17) -/
+#guard_msgs in
+#eval
+  let a := bytes 1000 (· * 7)
+  let b := a.xorSlice 0 a 0 1000
+  ((bytes 800 fun _ => 15).popcount, b.popcount, ((bytes 128 fun _ => 1).orSlice 0 b 3 17).popcount)
+
+/-! `FloatArray` kernels -/
+
+def floats (n : Nat) (f : Nat → Float) : FloatArray :=
+  (List.range n |>.map f).toFloatArray
+
+/-- info: (4950.000000, 328350.000000, 0.000000, 99.000000) -/
+#guard_msgs in
+#eval
+  let a := floats 100 Nat.toFloat
+  (a.sum, a.dot a, a.min, a.max)
+
+/-- info: (0.000000, inf, -inf, -3.000000, 7.000000) -/
+#guard_msgs in
+#eval
+  let a := floats 7 fun i => if i == 3 then 0 / 0 else i.toFloat - 3
+  (FloatArray.empty.sum, FloatArray.empty.min, FloatArray.empty.max, a.min, a.max + 4)
+
+/-- info: ([3.000000, 5.000000, 7.000000, 3.000000], [1.000000, 3.000000, 5.000000]) -/
+#guard_msgs in
+#eval
+  let x := floats 3 Nat.toFloat
+  let y := floats 4 fun _ => 1
+  ((FloatArray.axpy 2 x y).addScalar 2 |>.toList, ((x.mulScalar 2).addScalar 1).toList)
@@ -0,0 +1,39 @@
+/-- info: 0 -/
+#guard_msgs in
+#eval Lean.Compiler.getParallelWorkers
+
+set_option compiler.parallel true in
+set_option compiler.parallel.threads 2 in
+mutual
+partial def isEven : Nat → Bool
+  | 0 => true
+  | n+1 => isOdd n
+
+partial def isOdd : Nat → Bool
+  | 0 => false
+  | n+1 => isEven n
+
+partial def countEven : List Nat → Nat
+  | [] => 0
+  | x :: xs => (if isEven x then 1 else 0) + countOdd xs
+
+partial def countOdd : List Nat → Nat
+  | [] => 0
+  | x :: xs => (if isOdd x then 1 else 0) + countEven xs
+
+partial def sumAlt : List Nat → String
+  | [] => toString (countEven [0, 1, 2, 3, 4])
+  | x :: xs => toString x ++ "," ++ sumAlt xs
+end
+
+/-- info: "4,5,6,5" -/
+#guard_msgs in
+#eval sumAlt [4, 5, 6]
+
+#guard isEven 10 && isOdd 7 && countOdd [1, 2, 3] == 3
+
+/-! The passes of the block above must have been run on a second thread as well. -/
+
+/-- info: true -/
+#guard_msgs in
+#eval show IO Bool from return (← Lean.Compiler.getParallelWorkers) > 0
@@ -0,0 +1,48 @@
+/-!
+# Deferred deallocation of multi-threaded object graphs
+-/
+
+inductive Tree
+  | nil
+  | node (l : Tree) (v : Nat) (r : Tree)
+
+/-- A tree of `2^d - 1` distinct nodes. The index keeps the compiler from sharing equal subtrees. -/
+def make : Nat → Nat → Tree
+  | 0, _ => .nil
+  | d + 1, i => .node (make d (2 * i)) i (make d (2 * i + 1))
+
+def Tree.size : Tree → Nat
+  | .nil => 0
+  | .node l _ r => 1 + l.size + r.size
+
+partial def waitForReclaimer (n : Nat := 0) : IO Bool := do
+  if (← Runtime.getDeferredFreeBacklog) == 0 then
+    return true
+  else if n > 1000 then
+    return false
+  else
+    IO.sleep 10
+    waitForReclaimer (n + 1)
+
+def test : IO Unit := do
+  Runtime.setDeferredFreeThreshold 1000
+  let total ← Runtime.getDeferredFreeTotal
+  for i in [0:3] do
+    let t ← Runtime.markMultiThreaded (make (16 + i) (i + 1))
+    -- single-threaded objects pointing into the multi-threaded tree
+    let ts := (List.range 10).map fun j => Tree.node t j (make j j)
+    IO.println (ts.map Tree.size).sum
+  -- each tree has at least 65535 nodes, all but at most 1000 of which are freed by the reclaimer
+  IO.println ((← Runtime.getDeferredFreeTotal) - total ≥ 3 * 64000)
+  IO.println (← waitForReclaimer)
+  Runtime.setDeferredFreeThreshold 0
+
+/--
+info: 656373
+1311733
+2622453
+true
+true
+-/
+#guard_msgs in
+#eval test
@@ -0,0 +1,37 @@
+/-!
+# Batched file operations
+-/
+
+def describe {α} (f : α → String) : Except IO.Error α → String
+  | .ok a => f a
+  | .error (.noFileOrDirectory ..) => "noFileOrDirectory"
+  | .error _ => "error"
+
+def test : IO Unit := do
+  IO.FS.withTempDir fun dir => do
+    let files := (List.range 300).toArray.map fun i =>
+      (dir / s!"f{i}", ByteArray.mk ((List.range (i * 37)).toArray.map (·.toUInt8)))
+    let written ← IO.FS.writeBinFileBatch files
+    IO.println (written.all (·.toBool))
+    let paths := files.map (·.1) ++ #[dir / "missing", dir]
+    let mdata ← IO.FS.metadataBatch paths
+    IO.println (mdata.toList.drop 298 |>.map (describe fun m => if m.type == .dir then "dir" else s!"{m.byteSize}"))
+    let contents ← IO.FS.readBinFileBatch paths
+    let same := (files.zip contents).all fun ((_, data), r) =>
+      match r with
+      | .ok read => read.data == data.data
+      | .error _ => false
+    IO.println same
+    IO.println (contents.toList.drop 300 |>.map (describe fun d => toString d.size))
+    let failed ← IO.FS.writeBinFileBatch #[(dir / "missing" / "f", .empty), (dir / "g", "g".toUTF8)]
+    IO.println (failed.toList.map (describe fun _ => "ok"), ← IO.FS.readFile (dir / "g"))
+
+/--
+info: true
+[11026, 11063, noFileOrDirectory, dir]
+true
+[noFileOrDirectory, error]
+([noFileOrDirectory, ok], g)
+-/
+#guard_msgs in
+#eval test
@@ -0,0 +1,26 @@
+/-!
+# Reading lines in batches
+-/
+
+def test : IO Unit := do
+  IO.FS.withTempFile fun handle path => do
+    let content := String.join ((List.range 2500).map fun i => s!"line {i}\r\n") ++ "∀ last"
+    handle.putStr content
+    handle.flush
+    let h ← IO.FS.Handle.mk path .read
+    let batch ← h.getLines 2
+    IO.println (repr batch)
+    let rest ← h.getLines 10000
+    IO.println (rest.size, rest.back!)
+    IO.println (← h.getLines 10).size
+    let lines ← IO.FS.lines path
+    IO.println (lines.size, lines[1234]!, lines.back!)
+
+/--
+info: #["line 0\r\n", "line 1\r\n"]
+(2499, ∀ last)
+0
+(2501, line 1234, ∀ last)
+-/
+#guard_msgs in
+#eval test
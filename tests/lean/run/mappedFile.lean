@@ -0,0 +1,32 @@
+/-!
+# Memory mapped files
+-/
+
+def scan (path : System.FilePath) : IO (Nat × List UInt8 × String × List Nat) := do
+  let m ← IO.FS.MappedFile.mk path
+  let bytes := [← m.get 0, ← m.get 1, ← m.get (m.size - 1), ← m.get m.size]
+  let some line := String.fromUTF8? (← m.extract 6 11) | throw <| .userError "invalid UTF-8"
+  let mut newlines := #[]
+  let mut i ← m.findByte '\n'.toNat.toUInt8 0
+  while i < m.size do
+    newlines := newlines.push i.toNat
+    i ← m.findByte '\n'.toNat.toUInt8 (i + 1)
+  return (m.size.toNat, bytes, line, newlines.toList)
+
+def test : IO Unit := do
+  IO.FS.withTempFile fun handle path => do
+    handle.putStr "hello\nworld\n∀x\n"
+    handle.flush
+    IO.println (← scan path)
+    handle.rewind
+    handle.truncate
+    handle.flush
+    let empty ← IO.FS.MappedFile.mk path
+    IO.println (empty.size, ← empty.get 0, (← empty.extract 0 10).size, ← empty.findByte 0 0)
+
+/--
+info: (17, [104, 101, 10, 0], world, [5, 11, 16])
+(0, 0, 0, 0)
+-/
+#guard_msgs in
+#eval test
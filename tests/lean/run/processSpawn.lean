@@ -0,0 +1,55 @@
+/-!
+# Process spawning options
+
+Checks the working directory, environment, `null` redirections and `setsid` of spawned processes,
+and that a program that cannot be executed is reported by `spawn` itself. The checks use `sh` and are
+skipped on Windows.
+-/
+
+open IO.Process
+
+def check (msg : String) (b : Bool) : IO Unit :=
+  unless b do throw <| IO.userError s!"check failed: {msg}"
+
+def posixOnly (x : IO Unit) : IO Unit :=
+  unless System.Platform.isWindows do x
+
+#eval posixOnly do
+  let dir : System.FilePath := "processSpawn.dir"
+  IO.FS.createDirAll dir
+  let out ← output { cmd := "sh", args := #["-c", "pwd -P"], cwd := dir }
+  check "cwd" (out.stdout == (← IO.FS.realPath dir).toString ++ "\n")
+  IO.FS.removeDirAll dir
+
+#eval posixOnly do
+  let out ← output {
+    cmd := "sh", args := #["-c", "echo \"$LEAN_SPAWN_TEST ${HOME-unset}\""]
+    env := #[("LEAN_SPAWN_TEST", some "set"), ("HOME", none)]
+  }
+  check "env" (out.stdout == "set unset\n")
+
+#eval posixOnly do
+  -- with `stdin := .null`, `cat` immediately reads end of file
+  let child ← spawn { cmd := "sh", args := #["-c", "cat; echo done"], stdin := .null, stdout := .piped }
+  check "null stdin" ((← child.stdout.readToEnd) == "done\n")
+  check "null stdin exit code" ((← child.wait) == 0)
+  let child ← spawn {
+    cmd := "sh", args := #["-c", "echo out; echo err >&2"], stdout := .null, stderr := .piped
+  }
+  check "null stdout" ((← child.stderr.readToEnd) == "err\n")
+  check "null stdout exit code" ((← child.wait) == 0)
+
+#eval posixOnly do
+  -- the shell leads its own process group if and only if it was started in a new session
+  let leader := "test \"$(ps -o pgid= -p $$ | tr -d ' ')\" = \"$$\" && echo leader || echo member"
+  let out ← output { cmd := "sh", args := #["-c", leader], setsid := true }
+  check "setsid" (out.stdout == "leader\n")
+  let out ← output { cmd := "sh", args := #["-c", leader] }
+  check "no setsid" (out.stdout == "member\n")
+
+#eval posixOnly do
+  let failed ← try
+      discard <| spawn { cmd := "lean-process-spawn-test-does-not-exist" }
+      pure false
+    catch _ => pure true
+  check "missing program" failed
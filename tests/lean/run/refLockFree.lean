@@ -0,0 +1,29 @@
+/-!
+Concurrent updates of a shared `IO.Ref` using `modifyGetLockFree` and `modify`.
+-/
+
+def bump (r : IO.Ref Nat) (n : Nat) (lockFree : Bool) : IO Unit := do
+  for _ in [0:n] do
+    if lockFree then
+      r.modifyGetLockFree fun v => ((), v + 1)
+    else
+      r.modify (· + 1)
+
+def test (numTasks n : Nat) : IO Nat := do
+  let r ← IO.mkRef 0
+  let tasks ← (List.range numTasks).mapM fun i =>
+    IO.asTask (bump r n (i % 2 == 0)) .dedicated
+  for t in tasks do
+    IO.ofExcept (← IO.wait t)
+  r.get
+
+/-- info: 8000 -/
+#guard_msgs in
+#eval test 8 1000
+
+/-- info: 5 -/
+#guard_msgs in
+#eval do
+  let r ← IO.mkRef 2
+  let old ← r.modifyGetLockFree fun v => (v, v + 3)
+  return old + (← r.get) - 2
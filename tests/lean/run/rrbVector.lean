@@ -0,0 +1,59 @@
+import Lean.Data.RRBVector
+
+open Lean
+
+def mk (n : Nat) (off : Nat := 0) : RRBVector Nat :=
+  (List.range n).foldl (fun v i => v.push (i + off)) {}
+
+/-- info: (100000, some 99999, none, 4999950000) -/
+#guard_msgs in
+#eval
+  let v := mk 100000
+  (v.size, v.get? 99999, v.get? 100000, v.foldl (· + ·) 0)
+
+/-! Updates do not affect other versions. -/
+
+/-- info: ([0, 1, 2, 3], [0, 10, 2, 3], [0, 1, 2], [0, 1, 2, 3, 4]) -/
+#guard_msgs in
+#eval
+  let v := mk 4
+  (v.toList, (v.set 1 10).toList, v.pop.toList, (v.push 4).toList)
+
+/-- info: (199, some 0, some 198, some 0) -/
+#guard_msgs in
+#eval
+  let v := mk 100 ++ mk 100 100
+  let w := (v.set 150 0).pop
+  (w.size, w.get? 150, w.back?, v.get? 0)
+
+def check (v : RRBVector Nat) (as : Array Nat) : Bool :=
+  v.size == as.size && v.toArray == as && (List.range (as.size / 97)).all fun i => v.get? (i * 97) == as[i * 97]?
+
+/-! Concatenation and slicing of vectors of various shapes. -/
+
+/-- info: true -/
+#guard_msgs in
+#eval Id.run do
+  let mut v : RRBVector Nat := {}
+  let mut as : Array Nat := #[]
+  let mut ok := true
+  for i in [0:100] do
+    let w := mk (i * 37 % 1500) (i * 1000)
+    v := if i % 2 == 0 then v ++ w else w ++ v
+    as := if i % 2 == 0 then as ++ w.toArray else w.toArray ++ as
+    if i % 3 == 0 then
+      let b := i * 13 % (as.size + 1)
+      let e := as.size - i
+      v := v.extract b e
+      as := as.extract b e
+    ok := ok && check v as
+  return ok
+
+/-- info: 5050 -/
+#guard_msgs in
+#eval Id.run do
+  let mut s := 0
+  for x in mk 1000 do
+    if x > 100 then break
+    s := s + x
+  return s
@@ -0,0 +1,57 @@
+def tst : IO Unit := do
+  let as := [(1 : UInt32), 2, 3].toUInt32Array
+  IO.println as
+  let as := (as.push 4).set! 1 20
+  let as₁ := as.set! 2 30
+  IO.println as₁
+  IO.println as
+  IO.println (as.size, as.get! 3, as.get! 4, as[0]!)
+  IO.println (as.extract 1 3 ++ as₁)
+  IO.println (as.foldl (· + ·) 0)
+
+/--
+info: [1, 2, 3]
+[1, 20, 30, 4]
+[1, 20, 3, 4]
+(4, 4, 0, 1)
+[20, 3, 1, 20, 30, 4]
+28
+-/
+#guard_msgs in
+#eval tst
+
+/-! Conversion to and from bytes. -/
+
+/-- info: ([4, 3, 2, 1, 255, 0, 0, 0], [16909060, 255]) -/
+#guard_msgs in
+#eval
+  let bs := [(0x01020304 : UInt32), 255].toUInt32Array.toByteArray
+  (bs.toList, (UInt32Array.ofByteArray (bs.push 7)).toList)
+
+/-- info: (16, [-1, 5, 0]) -/
+#guard_msgs in
+#eval
+  let as := [(-1 : Int64), 5].toInt64Array
+  let bs := as.toByteArray
+  (bs.size, ((Int64Array.ofByteArray bs).push 0).toList)
+
+/-- info: [18446744073709551615, 42] -/
+#guard_msgs in
+#eval
+  let as := [(0 : UInt64), 42].toUInt64Array
+  (as.set! 0 (0 - 1)).toList
+
+/-- info: [1.500000, 2.500000, 2.500000, 1.500000] -/
+#guard_msgs in
+#eval
+  let as := (Float32Array.replicate 4 1.5).fill 1 3 2.5
+  as.toList
+
+/-- info: (3, 4.000000) -/
+#guard_msgs in
+#eval Id.run do
+  let as := Float32Array.replicate 3 (1.5 : Float32) |>.fill 2 100 1
+  let mut s : Float32 := 0
+  for x in as do
+    s := s + x
+  return (as.size, s)
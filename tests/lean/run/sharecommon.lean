@@ -188,3 +188,22 @@ check $ ptrAddrUnsafe o1 == ptrAddrUnsafe o2
 check $ ptrAddrUnsafe o1 == ptrAddrUnsafe o3
 
 #eval (tst7 3).run
+
+/-! States are values: sharing with an older state does not see objects added by later calls. -/
+unsafe def tst8 (σ : ShareCommon.StateFactory) : IO Unit := do
+let s₀ : ShareCommon.State.{0} σ := .mk σ
+let (x, s₁) := s₀.shareCommon [1, 2]
+let (y, _) := s₁.shareCommon ([0, 1].map (· + 1))
+let (z, _) := s₀.shareCommon ([0, 1].map (· + 1))
+let (w, _) := s₁.shareCommon [3]
+unless ptrAddrUnsafe x == ptrAddrUnsafe y && ptrAddrUnsafe x != ptrAddrUnsafe z do
+  throw $ IO.userError "check failed"
+IO.println [x, y, z, w]
+
+/-- info: [[1, 2], [1, 2], [1, 2], [3]] -/
+#guard_msgs in
+#eval tst8 objectFactory
+
+/-- info: [[1, 2], [1, 2], [1, 2], [3]] -/
+#guard_msgs in
+#eval tst8 hashMapObjectFactory
@@ -0,0 +1,38 @@
+/-!
+The specialization cache ignores universe levels, so the specializations below can be shared between the universe
+polymorphic `lengths` and its monomorphic instances.
+-/
+
+def lengths.{u} (xss : List (List (ULift.{u} Nat))) : List Nat :=
+  xss.map List.length
+
+def lengths0 (xss : List (List (ULift.{0} Nat))) : List Nat :=
+  xss.map List.length
+
+def lengths1 (xss : List (List (ULift.{1} Nat))) : List Nat :=
+  xss.map List.length
+
+def sums.{u} (xss : List (List (ULift.{u} Nat))) : List Nat :=
+  xss.map fun xs => xs.foldl (fun acc x => acc + x.down) 0
+
+def sums1 (xss : List (List (ULift.{1} Nat))) : List Nat :=
+  xss.map fun xs => xs.foldl (fun acc x => acc + x.down) 0
+
+#guard lengths.{2} [[⟨1⟩, ⟨2⟩], [], [⟨3⟩]] == [2, 0, 1]
+#guard lengths0 [[⟨1⟩], [⟨2⟩, ⟨3⟩]] == [1, 2]
+#guard lengths1 [[], [⟨1⟩, ⟨2⟩, ⟨3⟩]] == [0, 3]
+#guard sums.{3} [[⟨1⟩, ⟨2⟩], [⟨5⟩]] == [3, 5]
+#guard sums1 [[⟨4⟩, ⟨4⟩], []] == [8, 0]
+
+/-! The monomorphic instances must reuse the specializations created for `lengths` instead of generating their own. -/
+
+open Lean in
+/-- The specializations generated by the old code generator while compiling `decl`. -/
+def specsAt (decl : Name) : CoreM (List Name) := do
+  return (IR.getDecls (← getEnv)).filterMap fun d =>
+    if (d.name.toString.splitOn s!"._at.{decl}._spec_").length > 1 then some d.name else none
+
+/-- info: (true, [], []) -/
+#guard_msgs in
+#eval show Lean.CoreM _ from
+  return (!(← specsAt `lengths).isEmpty, ← specsAt `lengths0, ← specsAt `lengths1)
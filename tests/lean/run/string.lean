@@ -42,3 +42,19 @@ def next? (s: String) (p: String.Pos) : Option Char :=
 #guard "abba".revPosOf 'a' = some ⟨3⟩
 #guard "abba".revPosOf 'z' = none
 #guard "L∃∀N".revPosOf '∀' = some ⟨4⟩
+
+-- extract
+#guard lean.extract 0 lean.endPos = lean
+#guard lean.extract 0 ⟨100⟩ = lean
+#guard (lean.extract 0 lean.endPos).length = 4
+#guard lean.extract ⟨1⟩ lean.endPos = "∃∀N"
+#guard lean.extract ⟨2⟩ lean.endPos = ""
+#guard lean.extract 0 ⟨2⟩ = lean
+#guard abc.toSubstring.toString = abc
+
+-- long suffixes share the data of the string they are extracted from
+#guard
+  let s := "".pushn 'a' 300 ++ "∀b"
+  let t := s.extract ⟨10⟩ s.endPos
+  t == "".pushn 'a' 290 ++ "∀b" && t.length == 292 && (t.extract ⟨100⟩ t.endPos).length == 192 &&
+    t ++ "c" == "".pushn 'a' 290 ++ "∀bc" && (t.set 0 'z').get 0 == 'z' && s.get 0 == 'a'
@@ -0,0 +1,48 @@
+def build (f : String.Builder → String.Builder) : String :=
+  (f {}).toString
+
+/-- info: ("", "abc", "aé中😀", "--", 0) -/
+#guard_msgs in
+#eval
+  (build id, build (· ++ "a" ++ "" ++ "bc"), build fun b => b.push 'a' |>.push 'é' |>.push '中' |>.push '😀',
+   build (·.pushn '-' 2), (String.Builder.empty.pushn 'x' 0).length)
+
+/-! Long pieces are referenced, short ones are copied; both must end up in order. -/
+
+/-- info: (true, 5245, 5245, 10245) -/
+#guard_msgs in
+#eval
+  let long := "".pushn 'é' 50
+  let pieces := (List.range 200).map fun i => if i % 2 == 0 then long else toString i
+  let b := String.Builder.empty.appendList pieces
+  (b.toString == String.join pieces, b.toString.length, b.length, b.utf8ByteSize)
+
+/-! Substrings and bytes -/
+
+/-- info: ("bcdé", "", "cdéf", "ü€ bytes") -/
+#guard_msgs in
+#eval
+  let s := "abcdéf"
+  let bs := "ü€".toUTF8
+  (build (·.appendSubstring (s.toSubstring.drop 1 |>.take 4)),
+   build (·.appendSubstring (s.toSubstring.drop 7)),
+   build (·.appendSubstring ⟨s, ⟨2⟩, ⟨100⟩⟩),
+   build fun b => if h : String.validateUTF8 bs then b.appendUTF8 bs h ++ " bytes" else b)
+
+/-! Builders are persistent values. -/
+
+/-- info: ("ab", "abc", "abd") -/
+#guard_msgs in
+#eval
+  let b := String.Builder.empty ++ "a" |>.push 'b'
+  (b.toString, (b.push 'c').toString, (b ++ "d").toString)
+
+/-- info: "[1, 2, 3] [] #[[a], [b, c]]" -/
+#guard_msgs in
+#eval s!"{[1, 2, 3]} {([] : List Nat)} {#[["a"], ["b", "c"]]}"
+
+/-- info: true -/
+#guard_msgs in
+#eval
+  open Std.Format in
+  pretty (nest 2 (text "a" ++ line ++ text "b\nc")) 0 == "a\n  b\n  c"
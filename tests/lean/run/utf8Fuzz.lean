@@ -0,0 +1,54 @@
+/-!
+Compares the native UTF-8 validation and code point counting procedures against the reference
+implementations on pseudo-random byte arrays. The inputs mix long ASCII runs (which exercise the
+vectorized fast path in `utf8.cpp`) with valid multi-byte characters and invalid sequences.
+-/
+
+/-- Linear congruential generator, the test must be deterministic. -/
+def nextSeed (s : UInt64) : UInt64 :=
+  s * 6364136223846793005 + 1442695040888963407
+
+def pieces : Array (List UInt8) := #[
+  [0xc3, 0xa9], [0xe2, 0x82, 0xac], [0xf0, 0x9f, 0x98, 0x80], [0x7f],
+  [0x80], [0xff], [0xed, 0xa0, 0x80], [0xc0, 0x81], [0xf4, 0x90, 0x80, 0x80], [0xe2, 0x82]]
+
+def randomBytes (seed : UInt64) : ByteArray × UInt64 := Id.run do
+  let mut s := nextSeed seed
+  let mut out := ByteArray.empty
+  let n := (s >>> 33).toNat % 24
+  for _ in [0:n] do
+    s := nextSeed s
+    let r := (s >>> 33).toNat
+    match r % 10 with
+    | 0 | 1 | 2 | 3 =>
+      for _ in [0:(r / 10) % 40] do
+        out := out.push 0x78
+    | 8 =>
+      for b in pieces[(r / 10) % pieces.size]! do
+        out := out.push b
+    | 9 =>
+      out := out.push (r / 10).toUInt8
+    | _ =>
+      for b in pieces[(r / 10) % 4]! do
+        out := out.push b
+  return (out, s)
+
+def checkOne (a : ByteArray) : Bool :=
+  String.validateUTF8 a == (String.validateUTF8.loop a 0).isSome &&
+  if h : String.validateUTF8 a then
+    let s := String.fromUTF8 a h
+    let r := String.fromUTF8.loop a 0 ""
+    s == r && s.length == r.length && s.utf8ByteSize == a.size
+  else
+    true
+
+def fuzz (n : Nat) : Bool := Id.run do
+  let mut seed : UInt64 := 42
+  for _ in [0:n] do
+    let (a, s) := randomBytes seed
+    seed := s
+    unless checkOne a do
+      return false
+  return true
+
+#guard fuzz 3000